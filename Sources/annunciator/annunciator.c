@@ -0,0 +1,161 @@
+#include "annunciator.h"
+#include <string.h>
+#include <assert.h>
+
+#define ANNUNCIATOR_NONE                        (0xFFU)
+
+/**
+ * @brief 選出優先權最高的請求，相同優先權時來源編號小的優先
+ *
+ * @param ann 警示物件
+ */
+static void arbitrate(annunciator_t* ann)
+{
+    uint8_t i;
+    uint8_t priority = 0;
+
+    ann->active = ANNUNCIATOR_NONE;
+
+    for (i = 0; i < ANNUNCIATOR_SOURCE_MAX; i++)
+    {
+        if (ann->request[i].priority > priority)
+        {
+            priority = ann->request[i].priority;
+            ann->active = i;
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 警示初始化，所有輸出關閉
+ *
+ * @param ann 警示物件
+ * @param config 配置結構體
+ */
+void annunciator_init(annunciator_t* ann, const annunciator_config_t* config)
+{
+    assert(ann);
+    assert(config);
+
+    memset(ann, 0, sizeof(annunciator_t));
+    ann->config = config;
+    ann->active = ANNUNCIATOR_NONE;
+
+    if (ann->config->output)
+    {
+        ann->config->output(0);
+    }
+}
+
+/**
+ * @brief 警示任務，依樣式產生輸出
+ *
+ * @param ann 警示物件
+ *
+ * @note 內建時間計數器，需以 10ms 間隔時間調用；
+ *       所有樣式共用同一計數器，相同週期的閃爍會同步
+ */
+void annunciator_task(annunciator_t* ann)
+{
+    const annunciator_pattern_t* pattern;
+    uint8_t output = 0;
+    uint8_t ch;
+
+    assert(ann);
+
+    ann->tick++;
+
+    if (ann->update)
+    {
+        ann->update = false;
+        arbitrate(ann);
+    }
+
+    if (ann->active != ANNUNCIATOR_NONE)
+    {
+        for (ch = 0; ch < ANNUNCIATOR_CHANNEL_MAX; ch++)
+        {
+            pattern = &ann->request[ann->active].pattern[ch];
+
+            if (pattern->on &&
+                (!pattern->off || ((ann->tick % (pattern->on + pattern->off)) < pattern->on)))
+            {
+                output |= (1U << ch);
+            }
+        }
+    }
+
+    if (ann->output != output)
+    {
+        ann->output = output;
+
+        if (ann->config->output)
+        {
+            ann->config->output(output);
+        }
+    }
+}
+
+/**
+ * @brief 設定來源的請求，內容相同時不做任何事
+ *
+ * @param ann 警示物件
+ * @param source 來源編號
+ * @param priority 優先權，0 等同清除
+ * @param pattern 各通道樣式 (ANNUNCIATOR_CHANNEL_MAX 個)
+ */
+void annunciator_set(annunciator_t* ann, uint8_t source, uint8_t priority, const annunciator_pattern_t* pattern)
+{
+    annunciator_request_t* request;
+
+    assert(ann);
+    assert(pattern);
+
+    if (source >= ANNUNCIATOR_SOURCE_MAX)
+    {
+        return;
+    }
+
+    request = &ann->request[source];
+
+    if ((request->priority != priority) ||
+        memcmp(&request->pattern[0], pattern, sizeof(request->pattern)))
+    {
+        request->priority = priority;
+        memcpy(&request->pattern[0], pattern, sizeof(request->pattern));
+        ann->update = true;
+    }
+}
+
+/**
+ * @brief 清除來源的請求
+ *
+ * @param ann 警示物件
+ * @param source 來源編號
+ */
+void annunciator_clear(annunciator_t* ann, uint8_t source)
+{
+    assert(ann);
+
+    if ((source < ANNUNCIATOR_SOURCE_MAX) && ann->request[source].priority)
+    {
+        ann->request[source].priority = 0;
+        ann->update = true;
+    }
+}
+
+/**
+ * @brief 目前輸出
+ *
+ * @param ann 警示物件
+ *
+ * @return uint8_t bit n = 通道 n
+ */
+uint8_t annunciator_output(annunciator_t* ann)
+{
+    assert(ann);
+
+    return ann->output;
+}
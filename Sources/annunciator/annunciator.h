@@ -0,0 +1,50 @@
+#ifndef _annunciator_h_
+#define _annunciator_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ANNUNCIATOR_CHANNEL_MAX                 (4U)        /** 輸出通道數量 (燈號/蜂鳴器) */
+#define ANNUNCIATOR_SOURCE_MAX                  (8U)        /** 請求來源數量 */
+
+/** 閃爍樣式，單位 10 ms，on = 0 為熄滅，off = 0 為恆亮 */
+#define ANNUNCIATOR_OFF                         { 0, 0 }
+#define ANNUNCIATOR_ON                          { 1, 0 }
+#define ANNUNCIATOR_BLINK_FAST                  { 20, 20 }
+#define ANNUNCIATOR_BLINK                       { 50, 50 }
+#define ANNUNCIATOR_BLINK_SLOW                  { 100, 100 }
+
+typedef struct annunciator_pattern
+{
+    uint16_t on;                    /** basic = 10 ms */
+    uint16_t off;                   /** basic = 10 ms */
+} annunciator_pattern_t;
+
+typedef struct annunciator_request
+{
+    uint8_t priority;               /** 0: 無請求，數字越大優先權越高 */
+    annunciator_pattern_t pattern[ANNUNCIATOR_CHANNEL_MAX];
+} annunciator_request_t;
+
+typedef struct annunciator_config
+{
+    void (*output)(uint8_t channels);   /** bit n = 通道 n，只在變化時調用 */
+} annunciator_config_t;
+
+typedef struct annunciator
+{
+    uint32_t tick;                  /** basic = 10 ms */
+    uint8_t output;
+    uint8_t active;                 /** 目前顯示的來源 */
+    bool update;
+    annunciator_request_t request[ANNUNCIATOR_SOURCE_MAX];
+    const annunciator_config_t* config;
+} annunciator_t;
+
+void annunciator_init(annunciator_t* ann, const annunciator_config_t* config);
+void annunciator_task(annunciator_t* ann);
+void annunciator_set(annunciator_t* ann, uint8_t source, uint8_t priority, const annunciator_pattern_t* pattern);
+void annunciator_clear(annunciator_t* ann, uint8_t source);
+uint8_t annunciator_output(annunciator_t* ann);
+
+#endif
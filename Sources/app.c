@@ -1,13 +1,29 @@
 #include "app.h"
 
 void app_io_test(void);
-static keyboard_t key_io_scan(void);
 static uint16_t fc135kw_io(fc135kw_io_t io, uint16_t value);
 static uint16_t tyt60kw_io(tyt60kw_io_t io, uint16_t value);
+static void fc135kw_light_tower(fc135kw_light_tower_t light);
+static void tyt60kw_light_tower(tyt60kw_light_tower_t light);
+static void light_tower(uint8_t channels);
+static stage_state_t fc135kw_stage_state(void);
+static void fc135kw_stage_run(bool enable);
+static void fc135kw_stage_power(uint16_t power_kw);
+static stage_state_t tyt60kw_stage_state(void);
+static void tyt60kw_stage_run(bool enable);
+static void tyt60kw_stage_power(uint16_t power_kw);
 static void bidc300100_tx(uint32_t id, uint8_t* data, uint8_t size);
 static void lptmrISR(void);
+static uint32_t lptmr_counter(void);
+static bool lptmr_pending(void);
 
-bidc300100_t dcdc;
+bidc300100_bank_t dcdc;
+
+annunciator_t tower;
+const annunciator_config_t tower_config =
+{
+    .output = light_tower,
+};
 
 fc135kw_t fc135kw;
 fc135kw_config_t fc135kw_config =
@@ -15,6 +31,7 @@ fc135kw_config_t fc135kw_config =
     .name = "fc135kw",
     .log = app_log,
     .io = fc135kw_io,
+    .light_tower = fc135kw_light_tower,
 };
 
 tyt60kw_t tyt60kw;
@@ -23,6 +40,32 @@ tyt60kw_config_t tyt60kw_config =
     .name = "tyt60kw",
     .log = app_log,
     .io = tyt60kw_io,
+    .light_tower = tyt60kw_light_tower,
+};
+
+stage_t stage;
+const stage_config_t stage_config =
+{
+    .log = app_log,
+    .stack =
+    {
+        [STACK_FC135KW] =
+        {
+            .name = "fc135kw",
+            .capacity = 135,
+            .state = fc135kw_stage_state,
+            .run = fc135kw_stage_run,
+            .power = fc135kw_stage_power,
+        },
+        [STACK_TYT60KW] =
+        {
+            .name = "tyt60kw",
+            .capacity = 60,
+            .state = tyt60kw_stage_state,
+            .run = tyt60kw_stage_run,
+            .power = tyt60kw_stage_power,
+        },
+    },
 };
 
 uart_t uart1 =
@@ -31,23 +74,41 @@ uart_t uart1 =
     .state = &lpuart1_State,
     .user_cfg = &lpuart1_InitConfig0,
 };
-uint8_t uart_tx_buf[1024];
 uint8_t uart_rx_buf[1024];
 
+timebase_config_t timebase_config =
+{
+    .counter = lptmr_counter,
+    .pending = lptmr_pending,
+};
+static uint32_t lptmr_period_count;
+
 /*--------------------------------------------------------------------------------------------------------*/
 
 void app_init(void)
 {
+    /** cache */
+    app_cache_enable(true);
+
     /** clock */
     CLOCK_DRV_Init(&clockMan1_InitConfig0);
 
     /** gpio */
     PINS_DRV_Init(NUM_OF_CONFIGURED_PINS, g_pin_mux_InitConfigArr);
+    app_output_init();
 
     /** timer */
     LPTMR_DRV_Init(INST_LPTMR1, &lpTmr1_config0, false);
     INT_SYS_InstallHandler(LPTMR0_IRQn, &lptmrISR, (isr_t*)0);
     INT_SYS_EnableIRQ(LPTMR0_IRQn);
+
+    /** timebase, LPTMR 比較週期即為溢位週期，計數器在週期內提供 us 解析度 */
+    uint16_t compare;
+    LPTMR_DRV_GetCompareValueByCount(INST_LPTMR1, &compare);
+    lptmr_period_count = (uint32_t)compare + 1U;
+    timebase_config.period = lpTmr1_config0.compareValue;
+    timebase_init(&timebase_config);
+
     LPTMR_DRV_StartCounter(INST_LPTMR1);
 
      /** dma */
@@ -58,42 +119,75 @@ void app_init(void)
         EDMA_CONFIGURED_CHANNELS_COUNT);
 
     /** pwm */
-    static ftm_state_t ftmStateStruct[4];
-    FTM_DRV_Init(INST_FLEXTIMER_PWM0, &flexTimer_pwm0_InitConfig, &ftmStateStruct[0]);
-    FTM_DRV_InitPwm(INST_FLEXTIMER_PWM0, &flexTimer_pwm0_PwmConfig);
-    FTM_DRV_Init(INST_FLEXTIMER_PWM1, &flexTimer_pwm1_InitConfig, &ftmStateStruct[1]);
-    FTM_DRV_InitPwm(INST_FLEXTIMER_PWM1, &flexTimer_pwm1_PwmConfig);
-    FTM_DRV_Init(INST_FLEXTIMER_PWM2, &flexTimer_pwm2_InitConfig, &ftmStateStruct[2]);
-    FTM_DRV_InitPwm(INST_FLEXTIMER_PWM2, &flexTimer_pwm2_PwmConfig);
-    FTM_DRV_Init(INST_FLEXTIMER_PWM3, &flexTimer_pwm3_InitConfig, &ftmStateStruct[3]);
-    FTM_DRV_InitPwm(INST_FLEXTIMER_PWM3, &flexTimer_pwm3_PwmConfig);
+    app_pwm_init();
+
+    /** clock governor, 需在 pwm 之後 (切換時脈時重新計算 FTM 週期) */
+    app_clock_init();
 
     /** user */
-    key_io_init(key_io_scan);
+    app_input_init();
     app_can_init();
+    app_uds_init();
 
     uart_init(&uart1);
-    uart_tx_config(&uart1, &uart_tx_buf[0], sizeof(uart_tx_buf));
+#if APP_MODBUS
+    app_uart_init();
+    app_modbus_init();
+#else
     uart_rx_config(&uart1, &uart_rx_buf[0], sizeof(uart_rx_buf));
+    app_uart_init();
+#endif
 
-    bidc300100_init(&dcdc, 0, bidc300100_tx);
+    annunciator_init(&tower, &tower_config);
+    bidc300100_bank_init(&dcdc, bidc300100_tx);
     fc135kw_init(&fc135kw, &fc135kw_config);
     tyt60kw_init(&tyt60kw, &tyt60kw_config);
+    stage_init(&stage, &stage_config);
+    menu_init();
+    app_protect_init();
+    app_output_flush();
+    app_pwm_flush();
 }
 
 void app_run(void)
 {
     basic_time();
+    timebase_task();
     cmngr_task();
+    app_can_task();
+    app_uds_task();
+    app_input_task();
+    app_protect_task();
     menu();
     SYS_RUN_LIGHT(time_flag.bits.t1_00s_clock);
 
+#if !APP_MODBUS
     app_io_test();
+#endif
+    app_modbus_task();
+    app_bench_task();
+
+    if (time_flag.bits.t0_01s)
+    {
+        annunciator_task(&tower);
+        app_output_flush();
+        app_pwm_flush();
+    }
+
+    app_uart_task();
+    app_clock_task();
+    app_idle();
 }
 
 void app_log(const char* str, uint16_t size)
 {
-    uart_write(&uart1, (uint8_t*)str, size);
+#if APP_MODBUS
+    /* uart1 為 Modbus 匯流排，主動輸出會破壞訊框 */
+    (void)str;
+    (void)size;
+#else
+    (void)app_uart_write((const uint8_t*)str, size);
+#endif
 }
 
 void app_io_test(void)
@@ -143,16 +237,16 @@ void app_io_test(void)
                             buffer[4] = (logic ? '1' : '0');
                             buffer[5] = '\r';
                             buffer[6] = '\n';
-                            uart_write(&uart1, &buffer[0], 7);
+                            (void)app_uart_write(&buffer[0], 7);
                         }
                         else if (buffer[3] == 'W')
                         {
                             logic = ((buffer[3] - '0') == 1);
-                            PINS_DRV_WritePin((GPIO_Type* const)port, (1 << num), logic);
+                            app_output_write((output_port_t)(buffer[0] - 'A'), num, logic);
                         }
                         else
                         {
-                            PINS_DRV_TogglePins((GPIO_Type* const)port, (1 << num));
+                            app_output_toggle((output_port_t)(buffer[0] - 'A'), num);
                         }
                     }
                 }
@@ -208,16 +302,6 @@ void app_io_test(void)
 
 /*--------------------------------------------------------------------------------------------------------*/
 
-static keyboard_t key_io_scan(void)
-{
-    keyboard_t keyboard = { 0 };
-
-    if (BUTTON_ON() || KEY_1()) { keyboard.bits.key_1 = 1; }
-    if (BUTTON_OFF() || KEY_2()) { keyboard.bits.key_2 = 1; }
-
-    return keyboard;
-}
-
 static void bidc300100_tx(uint32_t id, uint8_t* data, uint8_t size)
 {
     can_message_t message =
@@ -264,46 +348,125 @@ static uint16_t tyt60kw_io(tyt60kw_io_t io, uint16_t value)
     return 0;
 }
 
-static void lptmrISR(void)
+/**
+ * @brief stack 燈號請求，依狀態決定優先權與樣式
+ *
+ * @param source 來源
+ * @param priority 優先權
+ */
+static void stack_tower(tower_source_t source, tower_priority_t priority)
 {
-    //1ms
-    LPTMR_DRV_ClearCompareFlag(INST_LPTMR1);
-    basic_time_from_10ms_irp();
+    static const annunciator_pattern_t pattern[TOWER_PRIORITY_MAX][ANNUNCIATOR_CHANNEL_MAX] =
+    {
+        [TOWER_PRIORITY_IDLE] = { ANNUNCIATOR_ON, ANNUNCIATOR_OFF, ANNUNCIATOR_OFF, ANNUNCIATOR_OFF },
+        [TOWER_PRIORITY_BUSY] = { ANNUNCIATOR_OFF, ANNUNCIATOR_OFF, ANNUNCIATOR_OFF, ANNUNCIATOR_OFF },
+        [TOWER_PRIORITY_PRECHARGE] = { ANNUNCIATOR_OFF, ANNUNCIATOR_BLINK_FAST, ANNUNCIATOR_OFF, ANNUNCIATOR_OFF },
+        [TOWER_PRIORITY_RUNNING] = { ANNUNCIATOR_OFF, ANNUNCIATOR_ON, ANNUNCIATOR_OFF, ANNUNCIATOR_OFF },
+        [TOWER_PRIORITY_ERROR] = { ANNUNCIATOR_OFF, ANNUNCIATOR_OFF, ANNUNCIATOR_BLINK_SLOW, ANNUNCIATOR_BLINK_SLOW },
+    };
+
+    annunciator_set(&tower, source, priority, &pattern[priority][0]);
 }
 
-void pwm_duty(uint8_t num, uint8_t ch, uint16_t duty)
+/* 燈號樣式由狀態決定，驅動的 light (逐 tick 切換的燈號) 只放在主機封包中 */
+static void fc135kw_light_tower(fc135kw_light_tower_t light)
 {
-    uint8_t id;
+    (void)light;
 
-    switch (num)
+    switch (fc135kw_status(&fc135kw))
     {
-        case INST_FLEXTIMER_PWM0:
-        {
-            id = flexTimer_pwm0_IndependentChannelsConfig[ch].hwChannelId;
-            break;
-        }
-        case INST_FLEXTIMER_PWM1:
-        {
-            id = flexTimer_pwm1_IndependentChannelsConfig[ch].hwChannelId;
-            break;
-        }
-        case INST_FLEXTIMER_PWM2:
-        {
-            id = flexTimer_pwm2_IndependentChannelsConfig[ch].hwChannelId;
-            break;
-        }
-        case INST_FLEXTIMER_PWM3:
-        {
-            id = flexTimer_pwm3_IndependentChannelsConfig[ch].hwChannelId;
-            break;
-        }
-        default: { return; }
+        case FC135KW_IDLE: { stack_tower(TOWER_SOURCE_FC135KW, TOWER_PRIORITY_IDLE); break; }
+        case FC135KW_PRECHARGE: { stack_tower(TOWER_SOURCE_FC135KW, TOWER_PRIORITY_PRECHARGE); break; }
+        case FC135KW_RUNNING: { stack_tower(TOWER_SOURCE_FC135KW, TOWER_PRIORITY_RUNNING); break; }
+        case FC135KW_ERROR: { stack_tower(TOWER_SOURCE_FC135KW, TOWER_PRIORITY_ERROR); break; }
+        default: { stack_tower(TOWER_SOURCE_FC135KW, TOWER_PRIORITY_BUSY); break; }
     }
+}
 
-    FTM_DRV_UpdatePwmChannel(num,
-        id,
-        FTM_PWM_UPDATE_IN_TICKS,
-        (uint16_t)(((uint32_t)duty * 24000) / 100),
-        0U,
-        true);
+static void tyt60kw_light_tower(tyt60kw_light_tower_t light)
+{
+    (void)light;
+
+    switch (tyt60kw_status(&tyt60kw))
+    {
+        case TYT60KW_IDLE: { stack_tower(TOWER_SOURCE_TYT60KW, TOWER_PRIORITY_IDLE); break; }
+        case TYT60KW_PRECHARGE: { stack_tower(TOWER_SOURCE_TYT60KW, TOWER_PRIORITY_PRECHARGE); break; }
+        case TYT60KW_RUNNING: { stack_tower(TOWER_SOURCE_TYT60KW, TOWER_PRIORITY_RUNNING); break; }
+        case TYT60KW_ERROR: { stack_tower(TOWER_SOURCE_TYT60KW, TOWER_PRIORITY_ERROR); break; }
+        default: { stack_tower(TOWER_SOURCE_TYT60KW, TOWER_PRIORITY_BUSY); break; }
+    }
+}
+
+static stage_state_t fc135kw_stage_state(void)
+{
+    switch (fc135kw_status(&fc135kw))
+    {
+        case FC135KW_IDLE: { return STAGE_STANDBY; }
+        case FC135KW_PRECHARGE: { return STAGE_STARTING; }
+        case FC135KW_RUNNING: { return STAGE_RUNNING; }
+        case FC135KW_SHUTDOWN: { return STAGE_STOPPING; }
+        default: { return STAGE_UNAVAILABLE; }
+    }
+}
+
+/* 排程只在運行/待機變化時調用，進入待機時設定熱待機，恢復運行時清除 */
+static void fc135kw_stage_run(bool enable)
+{
+    fc135kw_standby(&fc135kw, !enable);
+    fc135kw_start(&fc135kw, enable);
+}
+
+static void fc135kw_stage_power(uint16_t power_kw)
+{
+    fc135kw_power(&fc135kw, power_kw);
+}
+
+static stage_state_t tyt60kw_stage_state(void)
+{
+    switch (tyt60kw_status(&tyt60kw))
+    {
+        case TYT60KW_IDLE: { return STAGE_STANDBY; }
+        case TYT60KW_PRECHARGE: { return STAGE_STARTING; }
+        case TYT60KW_RUNNING: { return STAGE_RUNNING; }
+        case TYT60KW_SHUTDOWN: { return STAGE_STOPPING; }
+        default: { return STAGE_UNAVAILABLE; }
+    }
+}
+
+static void tyt60kw_stage_run(bool enable)
+{
+    tyt60kw_standby(&tyt60kw, !enable);
+    tyt60kw_start(&tyt60kw, enable);
+}
+
+static void tyt60kw_stage_power(uint16_t power_kw)
+{
+    tyt60kw_power(&tyt60kw, power_kw);
+}
+
+static void light_tower(uint8_t channels)
+{
+    LIGHT_TOWER((channels >> TOWER_LG) & 0x01,
+        (channels >> TOWER_LY) & 0x01,
+        (channels >> TOWER_LR) & 0x01,
+        (channels >> TOWER_BZ) & 0x01);
+}
+
+RAMFUNC static void lptmrISR(void)
+{
+    //10ms
+    LPTMR_DRV_ClearCompareFlag(INST_LPTMR1);
+    timebase_irq();
+    basic_time_from_10ms_irp();
+}
+
+static uint32_t lptmr_counter(void)
+{
+    /* CNR 在每個比較週期內由 0 數到 CMR，換算為 us */
+    return ((uint32_t)LPTMR_DRV_GetCounterValueByCount(INST_LPTMR1) * timebase_config.period) / lptmr_period_count;
+}
+
+static bool lptmr_pending(void)
+{
+    return LPTMR_DRV_GetCompareFlag(INST_LPTMR1);
 }
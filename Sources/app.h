@@ -5,33 +5,206 @@
 #include <stdint.h>
 #include "define_io.h"
 #include "basic_time.h"
+#include "timebase.h"
 #include "can_manager.h"
-#include "keyboard.h"
 #include "s32_can.h"
 #include "s32_uart.h"
 #include "menu.h"
 
 #include "fc135kw.h"
 #include "toyota60kw.h"
-#include "bidc300100.h"
+#include "bidc300100_bank.h"
+#include "can_health.h"
+#include "annunciator.h"
+#include "can_fastpath.h"
+#include "fc135kw_codec.h"
+#include "tyt60kw_codec.h"
+#include "stage.h"
+#include "ramfunc.h"
+#include "uart_txq.h"
+#include "modbus_rtu.h"
+#include "j1939_tp.h"
+#include "isotp.h"
+#include "uds.h"
 
 #define TYT60KW_HOST_CAN_TX_ID                  (0x00BB0000 | (((uint32_t)0x81) << 8) | 0x10)
 #define TYT60KW_HOST_CAN_RX_ID                  (0x00AA0000 | (((uint32_t)0x81) << 8) | 0x10)
 #define FC135KW_HOST_CAN_TX_ID                  (0x00BB0000 | (((uint32_t)0x82) << 8) | 0x10)
 #define FC135KW_HOST_CAN_RX_ID                  (0x00AA0000 | (((uint32_t)0x82) << 8) | 0x10)
+#define FC135KW_TP_ADDRESS                      (0x00U)     /** 本機在 fc135kw 匯流排上的 J1939 位址 (RTS 的目的地) */
+#define FC135KW_TP_SOURCE                       (0x10U)     /** fc135kw 控制器的 J1939 位址 */
+#define FC135KW_TP_ID(pgn, da)                  ((((uint32_t)7) << 26) | ((pgn) << 8) | (((uint32_t)(da)) << 8) | FC135KW_TP_SOURCE)
+#define UDS_REQUEST_ID                          (0x18DA82F1UL)  /** 診斷請求 (實體定址，測試端 0xF1 -> 本機 0x82) */
+#define UDS_FUNCTIONAL_ID                       (0x18DB33F1UL)  /** 診斷請求 (功能定址) */
+#define UDS_RESPONSE_ID                         (0x18DAF182UL)  /** 診斷回應 */
 
-#define app_logger(fmt, ...)                    uart_printf(&uart1, fmt, ## __VA_ARGS__)
+typedef enum stack_id
+{
+    STACK_FC135KW = 0,
+    STACK_TYT60KW,
+} stack_id_t;
+
+typedef enum tower_channel
+{
+    TOWER_LG = 0,
+    TOWER_LY,
+    TOWER_LR,
+    TOWER_BZ,
+} tower_channel_t;
+
+typedef enum tower_source
+{
+    TOWER_SOURCE_MENU = 0,
+    TOWER_SOURCE_FC135KW,
+    TOWER_SOURCE_TYT60KW,
+} tower_source_t;
+
+typedef enum tower_priority
+{
+    TOWER_PRIORITY_NONE = 0,
+    TOWER_PRIORITY_IDLE,            /** 全部 stack idle 才顯示 */
+    TOWER_PRIORITY_BUSY,            /** init/shutdown/deinit，壓過 idle */
+    TOWER_PRIORITY_PRECHARGE,
+    TOWER_PRIORITY_RUNNING,
+    TOWER_PRIORITY_ERROR,
+    TOWER_PRIORITY_SYSTEM,          /** 系統啟動/關機流程 */
+    TOWER_PRIORITY_MAX,
+} tower_priority_t;
+
+typedef enum output_port
+{
+    OUTPUT_PTA = 0,
+    OUTPUT_PTB,
+    OUTPUT_PTC,
+    OUTPUT_PTD,
+    OUTPUT_PTE,
+    OUTPUT_PORT_MAX,
+} output_port_t;
+
+typedef enum input_id
+{
+    INPUT_DI1 = 0,
+    INPUT_DI2,
+    INPUT_DI3,
+    INPUT_DI4,
+    INPUT_DI5,
+    INPUT_DI6,
+    INPUT_DI8,
+    INPUT_KEY_1,
+    INPUT_KEY_2,
+    INPUT_MAX,
+
+    INPUT_BUTTON_ON = INPUT_DI1,
+    INPUT_BUTTON_OFF = INPUT_DI2,
+} input_id_t;
+
+typedef enum input_event
+{
+    INPUT_EVENT_PRESS = 0x01,
+    INPUT_EVENT_RELEASE = 0x02,
+    INPUT_EVENT_LONG = 0x04,
+} input_event_t;
+
+typedef void (*input_callback_t)(input_id_t id, input_event_t event, uint64_t time);
+
+typedef enum clock_profile
+{
+    CLOCK_PROFILE_RUN = 0,                      /** FIRC 48 MHz */
+    CLOCK_PROFILE_HSRUN,                        /** SPLL 112 MHz */
+} clock_profile_t;
+
+typedef enum protect_source
+{
+    PROTECT_BUS_VOLTAGE = 0,
+    PROTECT_BUS_CURRENT,
+    PROTECT_SOURCE_MAX,
+} protect_source_t;
+
+typedef struct protect_event
+{
+    protect_source_t source;
+    uint16_t raw;                   /** 觸發時的 ADC 值 (12 bits) */
+    uint64_t time;                  /** 觸發時間 (us) */
+} protect_event_t;
+
+/* Cortex-M4 DWT 週期計數器 (SDK 未提供 CMSIS CoreDebug/DWT 定義)，clock governor 與 bench 共用 */
+#define CORE_DEMCR                              (*(volatile uint32_t*)0xE000EDFCUL)
+#define CORE_DEMCR_TRCENA                       (1UL << 24)
+#define CORE_DWT_CTRL                           (*(volatile uint32_t*)0xE0001000UL)
+#define CORE_DWT_CTRL_CYCCNTENA                 (1UL << 0)
+#define CORE_DWT_CYCCNT                         (*(volatile uint32_t*)0xE0001004UL)
+
+#define PWM_DUTY_FULL                           (10000U)    /** pwm_duty_fine() 解析度 0.01 % */
+
+#define PROTECT_VOLTAGE_TRIP_MV                 (4500U)     /** 匯流排電壓跳脫點(ADC 腳位電壓, mV) */
+#define PROTECT_CURRENT_TRIP_MV                 (4500U)     /** 匯流排電流跳脫點(ADC 腳位電壓, mV) */
+
+#define APP_BENCH                               (0)         /** 1: 主迴圈執行驅動量測 (app_bench.c)，僅台架使用 */
+#define APP_MODBUS                              (0)         /** 1: uart1 作為 Modbus RTU 從站 (app_modbus.c)，關閉 ASCII 除錯指令與 log 輸出，僅現場 SCADA 使用 */
+
+#define app_logger(fmt, ...)                    app_printf(fmt, ## __VA_ARGS__)
 
 extern uart_t uart1;
 extern cmngr_t can0_manager, can1_manager, can2_manager;
 extern fc135kw_t fc135kw;
 extern tyt60kw_t tyt60kw;
-extern bidc300100_t dcdc;
+extern bidc300100_bank_t dcdc;
+extern can_health_t can_health[CAN_INSTANCE_COUNT];
+extern can_fastpath_t can_fastpath[CAN_INSTANCE_COUNT];
+extern annunciator_t tower;
+extern stage_t stage;
 
 void app_init(void);
 void app_run(void);
 void app_log(const char* str, uint16_t size);
 void app_can_init(void);
+void app_can_task(void);
+void app_input_init(void);
+void app_input_task(void);
+bool app_input_subscribe(input_id_t id, uint8_t events, uint32_t hold, input_callback_t callback);
+void app_input_subscribe_isr(input_id_t id, input_callback_t callback);
+bool app_input_state(input_id_t id);
+void app_output_init(void);
+void app_output_write(output_port_t port, uint8_t pin, bool level);
+void app_output_toggle(output_port_t port, uint8_t pin);
+void app_output_force(output_port_t port, uint8_t pin, bool level);
+void app_output_lock(output_port_t port, uint8_t pin, bool level);
+void app_output_release(output_port_t port, uint8_t pin);
+void app_output_override(output_port_t port, uint8_t pin, bool enable, bool level);
+void app_output_override_clear(void);
+void app_output_flush(void);
+void app_pwm_init(void);
+void app_pwm_flush(void);
+void app_pwm_mask(bool mask);
+void app_pwm_clock_update(void);
 void pwm_duty(uint8_t num, uint8_t ch, uint16_t duty);
+void pwm_duty_fine(uint8_t num, uint8_t ch, uint16_t duty);
+void app_protect_init(void);
+void app_protect_task(void);
+void app_protect_clear(stack_id_t stack);
+bool app_protect_event(protect_event_t* event);
+void app_standby_enter(void);
+void app_standby_exit(void);
+void app_idle(void);
+void app_clock_init(void);
+void app_clock_task(void);
+clock_profile_t app_clock_profile(void);
+uint8_t app_clock_load(void);
+void app_bench_task(void);
+void app_cache_enable(bool enable);
+bool app_cache_enabled(void);
+void app_cache_invalidate(void);
+void app_cache_invalidate_range(uint32_t addr, uint32_t size);
+void app_uart_init(void);
+void app_uart_task(void);
+bool app_uart_write(const uint8_t* data, uint16_t size);
+bool app_uart_post(const uint8_t* data, uint16_t size);
+bool app_uart_sent(const uint8_t* data);
+void app_printf(const char* fmt, ...);
+void app_modbus_init(void);
+void app_modbus_task(void);
+void app_uds_init(void);
+void app_uds_task(void);
+bool app_uds_receive(uint32_t id, const uint8_t* data, uint8_t dlc);
 
 #endif
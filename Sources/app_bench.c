@@ -0,0 +1,84 @@
+#include "app.h"
+
+#if APP_BENCH
+
+#include "bench_suite.h"
+
+static uint32_t bench_clock(void);
+
+static bench_config_t bench_config =
+{
+    .name = "s32k144",
+    .clock = bench_clock,
+    .clock_hz = 48000000UL,
+    .min_ticks = 4800000UL,
+    .write = app_log,
+};
+
+static bench_t bench;
+static bool bench_started;
+static uint8_t bench_pass;                      /** 0: cache 開啟, 1: cache 關閉, 2: 結束 */
+
+/**
+ * @brief DWT 週期計數器
+ *
+ * @return uint32_t cycles
+ */
+static uint32_t bench_clock(void)
+{
+    return CORE_DWT_CYCCNT;
+}
+
+#endif
+
+/**
+ * @brief 目標板上的驅動量測，APP_BENCH 開啟時每秒量測一個項目並由 uart1 輸出 json
+ *
+ * @note 以 DWT CYCCNT 計數 (ticks_per_op 即 cycles)，min_ticks 約 100 ms；
+ *       量測期間主迴圈停止，結果包含中斷執行時間，只在台架上使用；
+ *       先在 cache 開啟下跑完一輪，再關閉 cache 跑第二輪 (context 名稱加上 -nocache)，結束後恢復開啟
+ */
+void app_bench_task(void)
+{
+#if APP_BENCH
+    const bench_case_t* cases;
+    uint16_t count;
+
+    if (!time_flag.bits.t1_00s)
+    {
+        return;
+    }
+
+    if (!bench_started)
+    {
+        CORE_DEMCR |= CORE_DEMCR_TRCENA;
+        CORE_DWT_CYCCNT = 0;
+        CORE_DWT_CTRL |= CORE_DWT_CTRL_CYCCNTENA;
+
+        CLOCK_SYS_GetFreq(CORE_CLOCK, &bench_config.clock_hz);
+        bench_config.min_ticks = bench_config.clock_hz / 10U;
+
+        count = bench_suite(&cases);
+        bench_init(&bench, &bench_config, cases, count);
+        bench_started = true;
+    }
+
+    if (bench_step(&bench) || (bench_pass >= 2U))
+    {
+        return;
+    }
+
+    if (bench_pass == 0U)
+    {
+        app_cache_enable(false);
+        bench_config.name = "s32k144-nocache";
+        bench_init(&bench, &bench_config, bench.cases, bench.count);
+    }
+    else
+    {
+        app_cache_enable(true);
+    }
+
+    bench_pass++;
+#endif
+}
@@ -0,0 +1,81 @@
+#include "app.h"
+
+#define CACHE_LINE_SIZE                         (16U)       /** LMEM code cache 每條 line 的大小 (bytes) */
+#define CACHE_LCMD_INVALIDATE                   (1U)        /** PCCLCR.LCMD: 清除該 line */
+
+/**
+ * @brief 開啟或關閉 LMEM code cache (4 KB, 2-way)
+ *
+ * @param enable true: 清除兩個 way 後開啟, false: 關閉
+ *
+ * @note 只快取 flash (region 0, write-through)，SRAM 上的 RAMFUNC 不經過 cache；
+ *       重設後 cache 為關閉，SystemInit 只在定義 ICACHE_ENABLE 時開啟，這裡不依賴該設定
+ */
+void app_cache_enable(bool enable)
+{
+    if (enable)
+    {
+        LMEM->PCCCR = LMEM_PCCCR_INVW0(1) | LMEM_PCCCR_INVW1(1) | LMEM_PCCCR_GO(1) | LMEM_PCCCR_ENCACHE(1);
+    }
+    else
+    {
+        LMEM->PCCCR &= ~LMEM_PCCCR_ENCACHE_MASK;
+    }
+
+    while (LMEM->PCCCR & LMEM_PCCCR_GO_MASK)
+    {
+    }
+}
+
+/**
+ * @brief cache 是否開啟
+ */
+bool app_cache_enabled(void)
+{
+    return (LMEM->PCCCR & LMEM_PCCCR_ENCACHE_MASK) != 0U;
+}
+
+/**
+ * @brief 清除整個 cache
+ *
+ * @note flash 抹除/燒寫 (EEPROM 模擬、bootloader) 完成後，讀取前需調用，
+ *       否則可能取到舊的內容；cache 關閉時調用無作用
+ */
+void app_cache_invalidate(void)
+{
+    LMEM->PCCCR |= LMEM_PCCCR_INVW0(1) | LMEM_PCCCR_INVW1(1) | LMEM_PCCCR_GO(1);
+
+    while (LMEM->PCCCR & LMEM_PCCCR_GO_MASK)
+    {
+    }
+}
+
+/**
+ * @brief 依實體位址清除一段範圍內的 cache line
+ *
+ * @param addr 起始位址
+ * @param size 長度 (bytes)
+ *
+ * @note 只燒寫少量 flash 時使用，避免整個 cache 重新載入；範圍超過 cache 大小時直接清除全部
+ */
+void app_cache_invalidate_range(uint32_t addr, uint32_t size)
+{
+    uint32_t end = addr + size;
+
+    if (size >= (4096U - CACHE_LINE_SIZE))
+    {
+        app_cache_invalidate();
+        return;
+    }
+
+    LMEM->PCCLCR = LMEM_PCCLCR_LADSEL(1) | LMEM_PCCLCR_LCMD(CACHE_LCMD_INVALIDATE);
+
+    for (addr &= ~(CACHE_LINE_SIZE - 1U); addr < end; addr += CACHE_LINE_SIZE)
+    {
+        LMEM->PCCSAR = (addr & LMEM_PCCSAR_PHYADDR_MASK) | LMEM_PCCSAR_LGO(1);
+
+        while (LMEM->PCCSAR & LMEM_PCCSAR_LGO_MASK)
+        {
+        }
+    }
+}
@@ -1,4 +1,11 @@
 #include "app.h"
+#include <string.h>
+
+#define CAN_ID_MASK_EXACT                       (0xDFFFFFFFUL)      /** Rx FIFO 個別遮罩: RTR、IDE 與 29 位元 ID 全部比對 */
+#define CAN_ID_MASK_J1939_DA                    (0xFFUL << 8)       /** J1939 PDU1 的目的地位址 */
+#define CAN_CS_IDE                              (1UL << 21)         /** 訊息緩衝控制字的 IDE (延伸幀) 位元 */
+#define CAN_RX_QUEUE_SIZE                       (8U)                /** 中斷收下等待 rx() 取出的訊框數 (2 的冪次) */
+#define CAN_RX_SLOT(n)                          ((uint8_t)((n) & (CAN_RX_QUEUE_SIZE - 1U)))
 
 static cmngr_err_t init(const void* handle);
 static cmngr_err_t deinit(const void* handle);
@@ -11,6 +18,18 @@ static void can1_tx_task(void);
 static void can1_rx_task(cmngr_msg_t* msg);
 static void can2_tx_task(void);
 static void can2_rx_task(cmngr_msg_t* msg);
+static can_health_counter_t health_read(const void* handle);
+static void health_recover(const void* handle, bool start);
+static void health_event(const void* handle, can_health_state_t state);
+static uint32_t bitrate(const s32_can_t* can);
+static void fastpath_install(const s32_can_t* can);
+static void fastpath_event(uint8_t instance, flexcan_event_type_t event, uint32_t buffer, flexcan_state_t* state);
+static bool fc135kw_error_match(const uint8_t data[8]);
+static void fc135kw_error_action(void);
+static bool tyt60kw_error_match(const uint8_t data[8]);
+static void tyt60kw_error_action(void);
+static void fc135kw_tp_tx(const void* handle, uint32_t id, const uint8_t data[8]);
+static void fc135kw_tp_deliver(const void* handle, uint32_t pgn, uint8_t sa, const uint8_t* data, uint16_t size);
 
 flexcan_id_table_t can0_id_table[7] =
 {
@@ -22,12 +41,27 @@ flexcan_id_table_t can0_id_table[7] =
     {.id = TYT60KW_UPDATE_508, .isExtendedFrame = false, .isRemoteFrame = false,},
 };
 
-flexcan_id_table_t can1_id_table[4] =
+flexcan_id_table_t can1_id_table[] =
 {
     {.id = FC135KW_SYS_STATUS, .isExtendedFrame = true, .isRemoteFrame = false, },
     {.id = FC135KW_SYS_H2, .isExtendedFrame = true, .isRemoteFrame = false, },
     {.id = FC135KW_SYS_WATER, .isExtendedFrame = true, .isRemoteFrame = false,},
     {.id = FC135KW_SYS_ERROR, .isExtendedFrame = true, .isRemoteFrame = false,},
+    {.id = FC135KW_TP_ID(J1939_PGN_TP_CM, J1939_ADDRESS_GLOBAL), .isExtendedFrame = true, .isRemoteFrame = false,},
+    {.id = FC135KW_TP_ID(J1939_PGN_TP_DT, J1939_ADDRESS_GLOBAL), .isExtendedFrame = true, .isRemoteFrame = false,},
+    {.id = FC135KW_SYS_DM1, .isExtendedFrame = true, .isRemoteFrame = false,},
+};
+
+/* 各 ID 表項目的個別遮罩 (RTR/IDE 與 29 位元 ID)，TP 不比對目的地位址，廣播與點對點共用一個項目 */
+static const uint32_t can1_id_mask[sizeof(can1_id_table) / sizeof(flexcan_id_table_t)] =
+{
+    CAN_ID_MASK_EXACT,
+    CAN_ID_MASK_EXACT,
+    CAN_ID_MASK_EXACT,
+    CAN_ID_MASK_EXACT,
+    CAN_ID_MASK_EXACT & ~CAN_ID_MASK_J1939_DA,
+    CAN_ID_MASK_EXACT & ~CAN_ID_MASK_J1939_DA,
+    CAN_ID_MASK_EXACT,
 };
 
 can_message_t can_tx_msg[3][16];
@@ -54,6 +88,49 @@ s32_can_t can2 =
     .user_cfg = &canCom3_InitConfig0,
 };
 
+can_health_t can_health[CAN_INSTANCE_COUNT];
+can_health_config_t can_health_config[CAN_INSTANCE_COUNT] =
+{
+    [INST_CANCOM1] = {.name = "can0", .log = app_log, .read = health_read, .recover = health_recover, .event = health_event, },
+    [INST_CANCOM2] = {.name = "can1", .log = app_log, .read = health_read, .recover = health_recover, .event = health_event, },
+    [INST_CANCOM3] = {.name = "can2", .log = app_log, .read = health_read, .recover = health_recover, .event = health_event, },
+};
+
+/* 接收中斷內立即處理的緊急訊框，狀態機稍後由 cmngr 收到同一訊框接手 */
+static const can_fastpath_rule_t can0_fastpath_rule[] =
+{
+    {.id = TYT60KW_UPDATE_051, .match = tyt60kw_error_match, .action = tyt60kw_error_action, },
+};
+
+static const can_fastpath_rule_t can1_fastpath_rule[] =
+{
+    {.id = FC135KW_SYS_ERROR, .match = fc135kw_error_match, .action = fc135kw_error_action, },
+};
+
+can_fastpath_t can_fastpath[CAN_INSTANCE_COUNT];
+
+/* fc135kw 的多封包訊息 (故障清單等)，BAM 與 RTS/CTS 皆可 */
+static j1939_tp_t fc135kw_tp;
+static const j1939_tp_config_t fc135kw_tp_config =
+{
+    .name = "fc135kw tp",
+    .address = FC135KW_TP_ADDRESS,
+    .log = app_log,
+    .tx = fc135kw_tp_tx,
+    .deliver = fc135kw_tp_deliver,
+};
+
+static struct
+{
+    flexcan_callback_t chain;               /** 原本安裝的 callback */
+    flexcan_msgbuff_t* volatile buffer;     /** Rx FIFO 目前使用的接收緩衝 */
+    flexcan_msgbuff_t receive;              /** 中斷內重新啟動接收使用的緩衝 */
+    can_message_t queue[CAN_RX_QUEUE_SIZE];
+    volatile uint8_t head;                  /** 下一個寫入的位置 (中斷) */
+    volatile uint8_t tail;                  /** 下一個讀取的位置 (rx()) */
+    uint32_t overflow;                      /** 佇列已滿而丟棄的訊框 */
+} fastpath[CAN_INSTANCE_COUNT];
+
 cmngr_config_t cmngr_config =
 {
     .init = init,
@@ -86,6 +163,12 @@ cmngr_t can2_manager =
 
 void app_can_init(void)
 {
+    can_fastpath_init(&can_fastpath[can0.instance], &can0_fastpath_rule[0],
+        sizeof(can0_fastpath_rule) / sizeof(can_fastpath_rule_t));
+    can_fastpath_init(&can_fastpath[can1.instance], &can1_fastpath_rule[0],
+        sizeof(can1_fastpath_rule) / sizeof(can_fastpath_rule_t));
+    can_fastpath_init(&can_fastpath[can2.instance], NULL, 0);
+
     cmngr_init(&cmngr_config);
 
     cmngr_add(&can0_manager);
@@ -95,15 +178,155 @@ void app_can_init(void)
     cmngr_add(&can1_manager);
     cmngr_rx_config(&can1_manager, (cmngr_msg_t*)&can_rx_msg[1]);
     cmngr_tx_config(&can1_manager, (cmngr_msg_t*)&can_tx_msg[1][0], 16, sizeof(can_message_t));
+    j1939_tp_init(&fc135kw_tp, &can1_manager, &fc135kw_tp_config);
 
     cmngr_add(&can2_manager);
     cmngr_rx_config(&can2_manager, (cmngr_msg_t*)&can_rx_msg[2]);
     cmngr_tx_config(&can2_manager, (cmngr_msg_t*)&can_tx_msg[2][0], 16, sizeof(can_message_t));
+
+    can_health_init(&can_health[can0.instance], &can0, bitrate(&can0), &can_health_config[can0.instance]);
+    can_health_init(&can_health[can1.instance], &can1, bitrate(&can1), &can_health_config[can1.instance]);
+    can_health_init(&can_health[can2.instance], &can2, bitrate(&can2), &can_health_config[can2.instance]);
+}
+
+void app_can_task(void)
+{
+    if (time_flag.bits.t0_01s)
+    {
+        can_health_task(&can_health[can0.instance]);
+        can_health_task(&can_health[can1.instance]);
+        can_health_task(&can_health[can2.instance]);
+        j1939_tp_task(&fc135kw_tp);
+    }
+}
+
+/**
+ * @brief 由 bit timing 計算匯流排速率
+ *
+ * @param can CAN 物件
+ *
+ * @return uint32_t 匯流排速率 (bps)
+ *
+ * @note PE clock 使用 oscillator (SOSCDIV2)，1 bit = sync + prop + pseg1 + pseg2
+ */
+static uint32_t bitrate(const s32_can_t* can)
+{
+    const flexcan_time_segment_t* segment = &can->user_cfg->bitrate;
+    uint32_t freq = 0;
+
+    (void)CLOCK_DRV_GetFreq(SOSCDIV2_CLK, &freq);
+
+    return freq / ((segment->preDivider + 1U) *
+        (segment->propSeg + segment->phaseSeg1 + segment->phaseSeg2 + 4U));
+}
+
+/**
+ * @brief 在 FlexCAN 事件 callback 前插入快速路徑，原本的 callback 照常調用
+ *
+ * @param can CAN 物件
+ */
+static void fastpath_install(const s32_can_t* can)
+{
+    if (can->state->callback != fastpath_event)
+    {
+        fastpath[can->instance].chain = can->state->callback;
+        /* can_init() 可能已用驅動的緩衝啟動接收，第一個訊框仍落在那裡 (0: FIFO handle) */
+        fastpath[can->instance].buffer = can->state->mbs[0].mb_message;
+        FLEXCAN_DRV_InstallEventCallback(can->instance, fastpath_event, can->state->callbackParam);
+    }
+}
+
+/**
+ * @brief FlexCAN 事件 callback (中斷內)，Rx FIFO 收到訊框時先檢查快速路徑規則，
+ *        再放入接收佇列並立即重新啟動接收
+ *
+ * @note 驅動每收完一個訊框就停止接收 (關閉 FIFO 中斷或 DMA 通道)，在這裡重新啟動，
+ *       硬體 FIFO 內其餘訊框不必等主迴圈的 rx()；
+ *       驅動在 callback 前已清除 mbs[].mb_message，接收緩衝由啟動接收時記錄；
+ *       DMA 模式下資料已轉為線上順序，標準幀 ID 已右移
+ */
+RAMFUNC static void fastpath_event(uint8_t instance, flexcan_event_type_t event, uint32_t buffer, flexcan_state_t* state)
+{
+    const flexcan_msgbuff_t* message = fastpath[instance].buffer;
+    can_message_t* entry;
+
+    if (((event == FLEXCAN_EVENT_RXFIFO_COMPLETE) || (event == FLEXCAN_EVENT_DMA_COMPLETE)) && message)
+    {
+        (void)can_fastpath_dispatch(&can_fastpath[instance], message->msgId, &message->data[0]);
+
+        if ((uint8_t)(fastpath[instance].head - fastpath[instance].tail) < CAN_RX_QUEUE_SIZE)
+        {
+            entry = &fastpath[instance].queue[CAN_RX_SLOT(fastpath[instance].head)];
+            entry->id = message->msgId;
+            entry->idt = ((message->cs & CAN_CS_IDE) != 0U) ? 1U : 0U;
+            entry->dlc = (message->dataLen > 8U) ? 8U : message->dataLen;
+            memcpy(&entry->data.bytes[0], &message->data[0], 8);
+
+            /* 訊框需在 head 公開前完成寫入 */
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+            fastpath[instance].head++;
+        }
+        else
+        {
+            fastpath[instance].overflow++;
+        }
+
+        /* 訊框已複製，接收緩衝可以重複使用 */
+        fastpath[instance].buffer = &fastpath[instance].receive;
+
+        if (FLEXCAN_DRV_RxFifo(instance, &fastpath[instance].receive) != STATUS_SUCCESS)
+        {
+            fastpath[instance].buffer = NULL;
+        }
+    }
+
+    if (fastpath[instance].chain)
+    {
+        fastpath[instance].chain(instance, event, buffer, state);
+    }
+}
+
+RAMFUNC static bool fc135kw_error_match(const uint8_t data[8])
+{
+    fc135kw_sys_error_t error;
+
+    fc135kw_sys_error_unpack(&error, data);
+
+    return (error.error_level > 1);
+}
+
+RAMFUNC static void fc135kw_error_action(void)
+{
+    FC_135KW_IGN_FORCE(false);
+    fc135kw_trip(&fc135kw);
+}
+
+RAMFUNC static bool tyt60kw_error_match(const uint8_t data[8])
+{
+    tyt60kw_fc_051_t fc_051;
+
+    tyt60kw_fc_051_unpack(&fc_051, data);
+
+    return (fc_051.error_level > 0);
+}
+
+RAMFUNC static void tyt60kw_error_action(void)
+{
+    FC_TYT60KW_IGN_FORCE(false);
+    tyt60kw_trip(&tyt60kw);
 }
 
 static cmngr_err_t init(const void* handle)
 {
-    return can_init((s32_can_t*)handle) ? CMNGR_SUCCESS : CMNGR_ERROR;
+    if (can_init((s32_can_t*)handle))
+    {
+        /* 關閉 FlexCAN 自動 bus-off 恢復，改由 can_health 控制退避 */
+        health_recover(handle, false);
+        fastpath_install((s32_can_t*)handle);
+        return CMNGR_SUCCESS;
+    }
+
+    return CMNGR_ERROR;
 }
 
 static cmngr_err_t deinit(const void* handle)
@@ -114,6 +337,7 @@ static cmngr_err_t deinit(const void* handle)
 static void filter(const void* handle)
 {
     s32_can_t* can = (s32_can_t*)handle;
+    uint8_t i;
 
     if (can == &can0)
     {
@@ -126,35 +350,139 @@ static void filter(const void* handle)
         can_set_filter(can,
             &can1_id_table[0],
             sizeof(can1_id_table) / sizeof(flexcan_id_table_t));
+
+        FLEXCAN_DRV_SetRxMaskType(can->instance, FLEXCAN_RX_MASK_INDIVIDUAL);
+
+        for (i = 0; i < (sizeof(can1_id_mask) / sizeof(can1_id_mask[0])); i++)
+        {
+            (void)FLEXCAN_DRV_SetRxIndividualMask(can->instance, FLEXCAN_MSG_ID_EXT, i, can1_id_mask[i]);
+        }
     }
 }
 
 static cmngr_err_t tx(const void* handle, cmngr_msg_t* msg)
 {
-    return can_tx_message((s32_can_t*)handle, *(can_message_t*)msg) ? CMNGR_SUCCESS : CMNGR_ERROR;
+    s32_can_t* can = (s32_can_t*)handle;
+    can_message_t* message = (can_message_t*)msg;
+
+    if (can_tx_message(can, *message))
+    {
+        can_health_frame(&can_health[can->instance], message->idt, message->dlc);
+        return CMNGR_SUCCESS;
+    }
+
+    return CMNGR_ERROR;
 }
 
 static cmngr_err_t rx(const void* handle, cmngr_msg_t* msg)
 {
-    return can_rx_message((s32_can_t*)handle, msg) ? CMNGR_SUCCESS : CMNGR_ERROR;
+    s32_can_t* can = (s32_can_t*)handle;
+    can_message_t* message = (can_message_t*)msg;
+    uint8_t tail = fastpath[can->instance].tail;
+
+    if (tail != fastpath[can->instance].head)
+    {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        *message = fastpath[can->instance].queue[CAN_RX_SLOT(tail)];
+
+        /* 複製完成後才釋放位置給中斷 */
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        fastpath[can->instance].tail = tail + 1U;
+
+        can_health_frame(&can_health[can->instance], message->idt, message->dlc);
+        return CMNGR_SUCCESS;
+    }
+
+    /* 接收由中斷持續重新啟動，只有尚未啟動或 DMA 錯誤後停止時在這裡啟動 (0: FIFO handle) */
+    if (FLEXCAN_DRV_GetTransferStatus(can->instance, 0) != STATUS_BUSY)
+    {
+        fastpath[can->instance].buffer = &fastpath[can->instance].receive;
+        (void)FLEXCAN_DRV_RxFifo(can->instance, &fastpath[can->instance].receive);
+    }
+
+    return CMNGR_ERROR;
+}
+
+static can_health_counter_t health_read(const void* handle)
+{
+    CAN_Type* const base[CAN_INSTANCE_COUNT] = CAN_BASE_PTRS;
+    const s32_can_t* can = (const s32_can_t*)handle;
+    can_health_counter_t counter;
+    uint32_t ecr = base[can->instance]->ECR;
+    uint32_t fltconf = (FLEXCAN_DRV_GetErrorStatus(can->instance) & CAN_ESR1_FLTCONF_MASK) >> CAN_ESR1_FLTCONF_SHIFT;
+
+    counter.tec = (uint8_t)((ecr & CAN_ECR_TXERRCNT_MASK) >> CAN_ECR_TXERRCNT_SHIFT);
+    counter.rec = (uint8_t)((ecr & CAN_ECR_RXERRCNT_MASK) >> CAN_ECR_RXERRCNT_SHIFT);
+    counter.passive = (fltconf == 1U);
+    counter.bus_off = (fltconf >= 2U);
+
+    return counter;
 }
 
-static void can0_tx_task(void)
+/**
+ * @brief bus-off 恢復控制
+ *
+ * @param handle CAN 物件
+ * @param start true: 中止卡住的發送並開始恢復, false: 關閉自動恢復
+ *
+ * @note BOFFREC = 1 時控制器停在 bus-off，清除後才依規範開始恢復
+ */
+static void health_recover(const void* handle, bool start)
 {
-    can_message_t message = { 0 };
+    CAN_Type* const base[CAN_INSTANCE_COUNT] = CAN_BASE_PTRS;
+    const s32_can_t* can = (const s32_can_t*)handle;
+    uint8_t mb;
 
-    message.idt = 0;
-    message.dlc = 8;
+    if (start)
+    {
+        /* 退避期間排隊的舊指令不再送出 */
+        for (mb = 0; mb < can->user_cfg->max_num_mb; mb++)
+        {
+            if (can->state->mbs[mb].state == FLEXCAN_MB_TX_BUSY)
+            {
+                (void)FLEXCAN_DRV_AbortTransfer(can->instance, mb);
+            }
+        }
+
+        base[can->instance]->CTRL1 &= ~CAN_CTRL1_BOFFREC_MASK;
+    }
+    else
+    {
+        base[can->instance]->CTRL1 |= CAN_CTRL1_BOFFREC_MASK;
+    }
+}
+
+/**
+ * @brief 匯流排狀態變化，通知對應的 fuel cell 降載
+ *
+ * @param handle CAN 物件
+ * @param state 新狀態
+ *
+ * @note can0: toyota 60kw, can1: fc 135kw，各自只看自己的匯流排，
+ *       can2 主機異常不降載，由主機封包逾時處理
+ */
+static void health_event(const void* handle, can_health_state_t state)
+{
+    (void)handle;
+    (void)state;
+
+    tyt60kw_bus_fault(&tyt60kw, can_health_state(&can_health[can0.instance]) >= CAN_HEALTH_PASSIVE);
+    fc135kw_bus_fault(&fc135kw, can_health_state(&can_health[can1.instance]) >= CAN_HEALTH_PASSIVE);
+}
+
+/* 每個發送 ID 保留一個幀，id/dlc 只設定一次，內容由驅動在變更時才重新編碼 */
+static void can0_tx_task(void)
+{
+    static can_message_t cmd_04e = { .id = TYT60KW_CMD_04E, .idt = 0, .dlc = 8 };
 
     if (time_flag.bits.t0_01s)
     {
-        message.id = TYT60KW_CMD_04E;
-        tyt60kw_command(&tyt60kw, (tyt60kw_command_t)message.id, &message.data.bytes[0]);
-        cmngr_tx_message(&can0_manager, &message);
+        tyt60kw_command(&tyt60kw, TYT60KW_CMD_04E, &cmd_04e.data.bytes[0]);
+        cmngr_tx_message(&can0_manager, &cmd_04e);
     }
 }
 
-static void can0_rx_task(cmngr_msg_t* msg)
+RAMFUNC static void can0_rx_task(cmngr_msg_t* msg)
 {
     can_message_t* message = (can_message_t*)msg;
 
@@ -163,32 +491,57 @@ static void can0_rx_task(cmngr_msg_t* msg)
 
 static void can1_tx_task(void)
 {
-    can_message_t message = { 0 };
-
-    message.idt = 1;
-    message.dlc = 8;
+    static can_message_t set_status = { .id = FC135KW_SET_STATUS, .idt = 1, .dlc = 8 };
+    static can_message_t remove_bubble = { .id = FC135KW_REMOVE_BUBBLE, .idt = 1, .dlc = 8 };
+    static can_message_t drain_valve = { .id = FC135KW_DRAIN_VALVE, .idt = 1, .dlc = 8 };
 
     if (time_flag.bits.t0_10s)
     {
-        message.id = FC135KW_SET_STATUS;
-        fc135kw_command(&fc135kw, message.id, &message.data.bytes[0]);
-        cmngr_tx_message(&can1_manager, &message);
+        fc135kw_command(&fc135kw, FC135KW_SET_STATUS, &set_status.data.bytes[0]);
+        cmngr_tx_message(&can1_manager, &set_status);
 
-        message.id = FC135KW_DRAIN_VALVE;
-        fc135kw_command(&fc135kw, message.id, &message.data.bytes[0]);
-        cmngr_tx_message(&can1_manager, &message);
+        fc135kw_command(&fc135kw, FC135KW_REMOVE_BUBBLE, &remove_bubble.data.bytes[0]);
+        cmngr_tx_message(&can1_manager, &remove_bubble);
+    }
 
-        message.id = FC135KW_REMOVE_BUBBLE;
-        fc135kw_command(&fc135kw, message.id, &message.data.bytes[0]);
-        cmngr_tx_message(&can1_manager, &message);
+    /* 排水排程變更時立即發送，其餘依協議 1 s 週期 */
+    if (fc135kw_purge_pending(&fc135kw) || time_flag.bits.t1_00s)
+    {
+        fc135kw_command(&fc135kw, FC135KW_DRAIN_VALVE, &drain_valve.data.bytes[0]);
+        cmngr_tx_message(&can1_manager, &drain_valve);
     }
 }
 
-static void can1_rx_task(cmngr_msg_t* msg)
+RAMFUNC static void can1_rx_task(cmngr_msg_t* msg)
 {
     can_message_t* message = (can_message_t*)msg;
 
-    fc135kw_update(&fc135kw, message->id, &message->data.bytes[0]);
+    if (!j1939_tp_receive(&fc135kw_tp, message->id, &message->data.bytes[0]))
+    {
+        fc135kw_update(&fc135kw, message->id, &message->data.bytes[0]);
+    }
+}
+
+/**
+ * @brief fc135kw 傳輸協議的 CTS/EOMA/中止，經由 can1 佇列發送
+ */
+static void fc135kw_tp_tx(const void* handle, uint32_t id, const uint8_t data[8])
+{
+    can_message_t message = { .id = id, .idt = 1, .dlc = 8 };
+
+    memcpy(&message.data.bytes[0], data, 8);
+    cmngr_tx_message((cmngr_t*)handle, &message);
+}
+
+/**
+ * @brief fc135kw 多封包訊息重組完成
+ */
+static void fc135kw_tp_deliver(const void* handle, uint32_t pgn, uint8_t sa, const uint8_t* data, uint16_t size)
+{
+    (void)handle;
+    (void)sa;
+
+    fc135kw_message(&fc135kw, pgn, data, size);
 }
 
 static void can2_tx_task(void)
@@ -211,44 +564,48 @@ static void can2_tx_task(void)
 
     if (time_flag.bits.t0_50s)
     {
-        bidc300100_request(&dcdc, BIDC300100_SYSTEM, 5);
-        bidc300100_request(&dcdc, BIDC300100_ONOFF, 0);
+        bidc300100_bank_task(&dcdc);
     }
 }
 
-static void can2_rx_task(cmngr_msg_t* msg)
+RAMFUNC static void can2_rx_task(cmngr_msg_t* msg)
 {
     can_message_t* message = (can_message_t*)msg;
 
+    if (app_uds_receive(message->id, &message->data.bytes[0], message->dlc))
+    {
+        return;
+    }
+
     switch (message->id)
     {
         case TYT60KW_HOST_CAN_TX_ID:
         {
             tyt60kw_host_connect(&tyt60kw);
-            tyt60kw_start(&tyt60kw, (message->data.bytes[0]));
-            tyt60kw_power(&tyt60kw, message->data.bytes[2]);
+            stage_request(&stage, STACK_TYT60KW, (message->data.bytes[0] != 0), message->data.bytes[2]);
 
             if (message->data.bytes[1] != 0)
             {
                 tyt60kw_clear_error(&tyt60kw);
+                app_protect_clear(STACK_TYT60KW);
             }
             break;
         }
         case FC135KW_HOST_CAN_TX_ID:
         {
             fc135kw_host_connect(&fc135kw);
-            fc135kw_start(&fc135kw, (message->data.bytes[0]));
-            fc135kw_power(&fc135kw, message->data.bytes[2]);
+            stage_request(&stage, STACK_FC135KW, (message->data.bytes[0] != 0), message->data.bytes[2]);
 
             if (message->data.bytes[1] != 0)
             {
                 fc135kw_clear_error(&fc135kw);
+                app_protect_clear(STACK_FC135KW);
             }
             break;
         }
         default:
         {
-            bidc300100_parser(&dcdc, message->id, &message->data.bytes[0], 8);
+            bidc300100_bank_parser(&dcdc, message->id, &message->data.bytes[0], 8);
             break;
         }
     }
@@ -0,0 +1,379 @@
+#include "app.h"
+
+#define INPUT_QUEUE_SIZE                        (32U)       /** 原始邊緣事件佇列 (2 的冪次) */
+#define INPUT_SUBSCRIBER_MAX                    (8U)
+#define INPUT_FILTER_WIDTH                      (31U)       /** 硬體數位濾波，LPO 128 kHz x 31 約 242 us */
+#define INPUT_DEBOUNCE_KEY                      TIMEBASE_MS(20)
+#define INPUT_DEBOUNCE_DI                       TIMEBASE_MS(10)
+
+typedef struct input_pin
+{
+    PORT_Type* port;
+    GPIO_Type* gpio;
+    uint8_t pin;
+    bool inverse;                   /** true: 低電位為動作 */
+    uint32_t debounce;              /** 軟體去彈跳時間 (us) */
+} input_pin_t;
+
+typedef struct input_edge
+{
+    uint64_t time;
+    uint8_t id;
+    bool active;
+} input_edge_t;
+
+typedef struct input_subscriber
+{
+    input_id_t id;
+    uint8_t events;
+    uint32_t hold;                  /** 長按時間 (us) */
+    bool fired;                     /** 本次按壓是否已通知長按 */
+    input_callback_t callback;
+} input_subscriber_t;
+
+static void port_b_isr(void);
+static void port_c_isr(void);
+static void port_d_isr(void);
+static void port_e_isr(void);
+
+static const input_pin_t input_pin[INPUT_MAX] =
+{
+    [INPUT_DI1] = { PORTE, PTE, 15, true, INPUT_DEBOUNCE_KEY },     /* BUTTON_ON */
+    [INPUT_DI2] = { PORTE, PTE, 16, true, INPUT_DEBOUNCE_KEY },     /* BUTTON_OFF */
+    [INPUT_DI3] = { PORTC, PTC, 8, false, INPUT_DEBOUNCE_DI },
+    [INPUT_DI4] = { PORTC, PTC, 9, false, INPUT_DEBOUNCE_DI },
+    [INPUT_DI5] = { PORTC, PTC, 15, false, INPUT_DEBOUNCE_DI },
+    [INPUT_DI6] = { PORTB, PTB, 3, false, INPUT_DEBOUNCE_DI },
+    [INPUT_DI8] = { PORTD, PTD, 8, false, INPUT_DEBOUNCE_DI },
+    [INPUT_KEY_1] = { PORTC, PTC, 12, false, INPUT_DEBOUNCE_KEY },
+    [INPUT_KEY_2] = { PORTC, PTC, 13, false, INPUT_DEBOUNCE_KEY },
+};
+
+static struct
+{
+    input_edge_t queue[INPUT_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile bool overflow;
+
+    uint16_t state;                             /** 去彈跳後的狀態 */
+    uint16_t pending;                           /** 等待去彈跳的輸入 */
+    uint16_t pending_level;
+    uint64_t pending_time[INPUT_MAX];
+    uint64_t press_time[INPUT_MAX];
+
+    input_subscriber_t subscriber[INPUT_SUBSCRIBER_MAX];
+    uint8_t subscribers;
+    input_callback_t isr_callback[INPUT_MAX];
+} input;
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 讀取輸入的動作狀態
+ *
+ * @param id 輸入編號
+ *
+ * @return true 動作
+ * @return false 未動作
+ */
+static bool read(input_id_t id)
+{
+    const input_pin_t* p = &input_pin[id];
+
+    return (((PINS_DRV_ReadPins(p->gpio) >> p->pin) & 0x01U) != 0U) != p->inverse;
+}
+
+/**
+ * @brief 通知訂閱者
+ *
+ * @param id 輸入編號
+ * @param event 事件
+ * @param time 事件時間 (us)
+ */
+static void notify(input_id_t id, input_event_t event, uint64_t time)
+{
+    uint8_t i;
+    input_subscriber_t* s;
+
+    for (i = 0; i < input.subscribers; i++)
+    {
+        s = &input.subscriber[i];
+
+        if (s->id == id)
+        {
+            if (event == INPUT_EVENT_PRESS)
+            {
+                s->fired = false;
+            }
+
+            if (s->events & event)
+            {
+                s->callback(id, event, time);
+            }
+        }
+    }
+}
+
+/**
+ * @brief PORT 中斷共用處理，記錄邊緣事件
+ *
+ * @param port PORT 物件
+ */
+static void port_irq(PORT_Type* port)
+{
+    uint32_t flags;
+    uint64_t now = timebase_now();
+    uint8_t id;
+    uint8_t next;
+    bool active;
+
+    flags = port->ISFR;
+    port->ISFR = flags;
+
+    for (id = 0; id < INPUT_MAX; id++)
+    {
+        if ((input_pin[id].port == port) &&
+            (flags & (1UL << input_pin[id].pin)))
+        {
+            active = read((input_id_t)id);
+
+            if (input.isr_callback[id])
+            {
+                /* 緊急輸入直接在中斷內處理，不等去彈跳 */
+                input.isr_callback[id]((input_id_t)id, active ? INPUT_EVENT_PRESS : INPUT_EVENT_RELEASE, now);
+            }
+
+            next = (input.head + 1U) & (INPUT_QUEUE_SIZE - 1U);
+
+            if (next != input.tail)
+            {
+                input.queue[input.head].time = now;
+                input.queue[input.head].id = id;
+                input.queue[input.head].active = active;
+                input.head = next;
+            }
+            else
+            {
+                input.overflow = true;
+            }
+        }
+    }
+}
+
+static void port_b_isr(void) { port_irq(PORTB); }
+static void port_c_isr(void) { port_irq(PORTC); }
+static void port_d_isr(void) { port_irq(PORTD); }
+static void port_e_isr(void) { port_irq(PORTE); }
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 輸入初始化，開啟 PORT 數位濾波與雙邊緣中斷
+ */
+void app_input_init(void)
+{
+    const port_digital_filter_config_t filter =
+    {
+        .clock = PORT_DIGITAL_FILTER_LPO_CLOCK,
+        .width = INPUT_FILTER_WIDTH,
+    };
+
+    uint8_t id;
+
+    input.head = 0;
+    input.tail = 0;
+    input.overflow = false;
+    input.state = 0;
+    input.pending = 0;
+    input.subscribers = 0;
+
+    PINS_DRV_ConfigDigitalFilter(PORTB, &filter);
+    PINS_DRV_ConfigDigitalFilter(PORTC, &filter);
+    PINS_DRV_ConfigDigitalFilter(PORTD, &filter);
+    PINS_DRV_ConfigDigitalFilter(PORTE, &filter);
+
+    for (id = 0; id < INPUT_MAX; id++)
+    {
+        input.isr_callback[id] = 0;
+
+        PINS_DRV_EnableDigitalFilter(input_pin[id].port, input_pin[id].pin);
+        PINS_DRV_SetPinIntSel(input_pin[id].port, input_pin[id].pin, PORT_INT_EITHER_EDGE);
+        PINS_DRV_ClearPinIntFlagCmd(input_pin[id].port, input_pin[id].pin);
+
+        if (read((input_id_t)id))
+        {
+            input.state |= (1U << id);
+        }
+    }
+
+    INT_SYS_InstallHandler(PORTB_IRQn, &port_b_isr, (isr_t*)0);
+    INT_SYS_InstallHandler(PORTC_IRQn, &port_c_isr, (isr_t*)0);
+    INT_SYS_InstallHandler(PORTD_IRQn, &port_d_isr, (isr_t*)0);
+    INT_SYS_InstallHandler(PORTE_IRQn, &port_e_isr, (isr_t*)0);
+    INT_SYS_EnableIRQ(PORTB_IRQn);
+    INT_SYS_EnableIRQ(PORTC_IRQn);
+    INT_SYS_EnableIRQ(PORTD_IRQn);
+    INT_SYS_EnableIRQ(PORTE_IRQn);
+}
+
+/**
+ * @brief 輸入任務，處理去彈跳、長按並通知訂閱者
+ *
+ * @note 在主迴圈調用，沒有邊緣事件且沒有按壓中的輸入時幾乎不耗時
+ */
+void app_input_task(void)
+{
+    uint64_t now;
+    uint16_t mask;
+    uint8_t id;
+    uint8_t i;
+    bool active;
+    input_subscriber_t* s;
+
+    if ((input.head == input.tail) && !input.overflow &&
+        (input.pending == 0) && (input.state == 0))
+    {
+        return;
+    }
+
+    now = timebase_now();
+
+    if (input.overflow)
+    {
+        /* 佇列溢位，直接讀取所有輸入重新同步 */
+        input.overflow = false;
+        input.tail = input.head;
+
+        for (id = 0; id < INPUT_MAX; id++)
+        {
+            mask = (1U << id);
+            active = read((input_id_t)id);
+
+            if (active != ((input.state & mask) != 0U))
+            {
+                input.pending |= mask;
+                input.pending_level = active ? (input.pending_level | mask) : (input.pending_level & ~mask);
+                input.pending_time[id] = now;
+            }
+        }
+    }
+
+    while (input.tail != input.head)
+    {
+        input_edge_t* edge = &input.queue[input.tail];
+
+        mask = (1U << edge->id);
+
+        if (edge->active == ((input.state & mask) != 0U))
+        {
+            /* 彈跳回原狀態 */
+            input.pending &= ~mask;
+        }
+        else if (!(input.pending & mask) ||
+            (edge->active != ((input.pending_level & mask) != 0U)))
+        {
+            input.pending |= mask;
+            input.pending_level = edge->active ? (input.pending_level | mask) : (input.pending_level & ~mask);
+            input.pending_time[edge->id] = edge->time;
+        }
+
+        input.tail = (input.tail + 1U) & (INPUT_QUEUE_SIZE - 1U);
+    }
+
+    for (id = 0; (id < INPUT_MAX) && input.pending; id++)
+    {
+        mask = (1U << id);
+
+        if ((input.pending & mask) &&
+            ((now - input.pending_time[id]) >= input_pin[id].debounce))
+        {
+            input.pending &= ~mask;
+
+            if (input.pending_level & mask)
+            {
+                input.state |= mask;
+                input.press_time[id] = input.pending_time[id];
+                notify((input_id_t)id, INPUT_EVENT_PRESS, input.pending_time[id]);
+            }
+            else
+            {
+                input.state &= ~mask;
+                notify((input_id_t)id, INPUT_EVENT_RELEASE, input.pending_time[id]);
+            }
+        }
+    }
+
+    for (i = 0; (i < input.subscribers) && input.state; i++)
+    {
+        s = &input.subscriber[i];
+
+        if ((s->events & INPUT_EVENT_LONG) && !s->fired &&
+            (input.state & (1U << s->id)) &&
+            ((now - input.press_time[s->id]) >= s->hold))
+        {
+            s->fired = true;
+            s->callback(s->id, INPUT_EVENT_LONG, now);
+        }
+    }
+}
+
+/**
+ * @brief 訂閱輸入事件
+ *
+ * @param id 輸入編號
+ * @param events 事件組合 (input_event_t)
+ * @param hold 長按時間 (us)，沒有訂閱 INPUT_EVENT_LONG 時忽略
+ * @param callback 事件通知，在 app_input_task() 內調用
+ *
+ * @return true 訂閱成功
+ * @return false 訂閱數量已滿
+ */
+bool app_input_subscribe(input_id_t id, uint8_t events, uint32_t hold, input_callback_t callback)
+{
+    input_subscriber_t* s;
+
+    if ((id >= INPUT_MAX) || !callback ||
+        (input.subscribers >= INPUT_SUBSCRIBER_MAX))
+    {
+        return false;
+    }
+
+    s = &input.subscriber[input.subscribers++];
+    s->id = id;
+    s->events = events;
+    s->hold = hold;
+    s->fired = true;
+    s->callback = callback;
+
+    return true;
+}
+
+/**
+ * @brief 訂閱中斷內的邊緣事件，只經過硬體濾波
+ *
+ * @param id 輸入編號
+ * @param callback 事件通知，在 PORT 中斷內調用，需盡快返回
+ *
+ * @note 用於急停等需要立即反應的輸入
+ */
+void app_input_subscribe_isr(input_id_t id, input_callback_t callback)
+{
+    if (id < INPUT_MAX)
+    {
+        input.isr_callback[id] = callback;
+    }
+}
+
+/**
+ * @brief 輸入狀態(去彈跳後)
+ *
+ * @param id 輸入編號
+ *
+ * @return true 動作
+ * @return false 未動作
+ */
+bool app_input_state(input_id_t id)
+{
+    return (id < INPUT_MAX) && ((input.state & (1U << id)) != 0U);
+}
@@ -0,0 +1,219 @@
+#include "app.h"
+
+#if APP_MODBUS
+
+#define MODBUS_ADDRESS                          (1U)        /** 從站位址 */
+#define MODBUS_RX_DMA_CHANNEL                   (3U)        /** lpuart1_InitConfig0.rxDMAChannel */
+#define MODBUS_IDLE_CHARS                       (2U)        /** CTRL.IDLECFG: 2^2 = 4 個字元的閒置視為訊框結束 (>= t3.5) */
+
+/** dcdc 每個槽位佔 4 個暫存器 */
+#define MODBUS_DCDC_SLOT(n)                                                     \
+    MODBUS_UNSIGNED(210U + ((n) * 4U), dcdc.addr[n]),                           \
+    MODBUS_SIGNED(211U + ((n) * 4U), dcdc.current[n]),                          \
+    MODBUS_SIGNED(212U + ((n) * 4U), dcdc.temp[n]),                             \
+    MODBUS_UNSIGNED(213U + ((n) * 4U), dcdc.share[n])
+
+typedef struct modbus_frame
+{
+    uint8_t buffer[2][MODBUS_RTU_FRAME_MAX];
+    uint8_t active;                 /** DMA 目前寫入的緩衝 */
+    volatile uint16_t size;         /** 已完成訊框的長度 (另一個緩衝)，0: 無 */
+    volatile uint32_t overrun;      /** 主迴圈來不及處理而丟棄的訊框 */
+    volatile uint32_t error;        /** 雜訊、框架、同位或溢位錯誤的訊框 */
+} modbus_frame_t;
+
+/** 暫存器表，直接指向即時資料，SCADA 端依此位址表讀取 (0x03 / 0x04 皆可) */
+static const modbus_reg_t modbus_map[] =
+{
+    /* 0 ~ 99: fc135kw */
+    MODBUS_UNSIGNED(0, fc135kw.status),
+    MODBUS_UNSIGNED(1, fc135kw.system_status),
+    MODBUS_UNSIGNED(2, fc135kw.power_setup),
+    MODBUS_UNSIGNED(3, fc135kw.H2_pressure),
+    MODBUS_UNSIGNED(4, fc135kw.H2_src_pressure),
+    MODBUS_SIGNED(5, fc135kw.water_temp),
+    MODBUS_SIGNED(6, fc135kw.water_temp_target),
+    MODBUS_UNSIGNED(7, fc135kw.error),
+    MODBUS_UNSIGNED(8, fc135kw.error_code),
+    MODBUS_UNSIGNED(9, fc135kw.trip),
+    MODBUS_SIGNED(10, fc135kw.purge.h2_trend),
+    MODBUS_UNSIGNED(11, fc135kw.warmup.eta),
+    MODBUS_SIGNED(12, fc135kw.warmup.rate),
+    MODBUS_UNSIGNED(13, fc135kw.fault.lamp),
+    MODBUS_UNSIGNED(14, fc135kw.fault.count),
+
+    /* 100 ~ 199: tyt60kw */
+    MODBUS_UNSIGNED(100, tyt60kw.status),
+    MODBUS_UNSIGNED(101, tyt60kw.fc_status),
+    MODBUS_UNSIGNED(102, tyt60kw.power_setup),
+    MODBUS_UNSIGNED(103, tyt60kw.power_max),
+    MODBUS_UNSIGNED(104, tyt60kw.pcu_voltage),
+    MODBUS_UNSIGNED(105, tyt60kw.pcu_temp),
+    MODBUS_UNSIGNED(106, tyt60kw.w_temp_fco),
+    MODBUS_UNSIGNED(107, tyt60kw.error),
+    MODBUS_UNSIGNED(108, tyt60kw.error_code),
+    MODBUS_UNSIGNED(109, tyt60kw.trip),
+    MODBUS_UNSIGNED(110, tyt60kw.cooling_time),
+
+    /* 200 ~ 299: dcdc (bidc300100_bank) */
+    MODBUS_UNSIGNED(200, dcdc.count),
+    MODBUS_UNSIGNED(201, dcdc.present),
+    MODBUS_UNSIGNED(203, dcdc.current_setup),
+    MODBUS_DCDC_SLOT(0),
+    MODBUS_DCDC_SLOT(1),
+    MODBUS_DCDC_SLOT(2),
+    MODBUS_DCDC_SLOT(3),
+    MODBUS_DCDC_SLOT(4),
+    MODBUS_DCDC_SLOT(5),
+    MODBUS_DCDC_SLOT(6),
+    MODBUS_DCDC_SLOT(7),
+};
+
+static const modbus_rtu_config_t modbus_config =
+{
+    .address = MODBUS_ADDRESS,
+    .map = &modbus_map[0],
+    .count = sizeof(modbus_map) / sizeof(modbus_map[0]),
+};
+
+static modbus_rtu_t modbus;
+static modbus_frame_t modbus_frame;
+static uint8_t modbus_response[MODBUS_RTU_FRAME_MAX];
+
+/**
+ * @brief 設定接收 DMA 寫入指定緩衝，收滿 MODBUS_RTU_FRAME_MAX 後停止 (不產生中斷)
+ */
+static void modbus_rx_start(uint8_t index)
+{
+    DMA->CDNE = DMA_CDNE_CDNE(MODBUS_RX_DMA_CHANNEL);
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].SADDR = (uint32_t)&LPUART1->DATA;
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].SOFF = 0;
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].ATTR = DMA_TCD_ATTR_SSIZE(0) | DMA_TCD_ATTR_DSIZE(0);
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].NBYTES.MLNO = 1;
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].SLAST = 0;
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].DADDR = (uint32_t)&modbus_frame.buffer[index][0];
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].DOFF = 1;
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].CITER.ELINKNO = MODBUS_RTU_FRAME_MAX;
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].DLASTSGA = 0;
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].BITER.ELINKNO = MODBUS_RTU_FRAME_MAX;
+    DMA->TCD[MODBUS_RX_DMA_CHANNEL].CSR = DMA_TCD_CSR_DREQ_MASK;
+    DMA->SERQ = DMA_SERQ_SERQ(MODBUS_RX_DMA_CHANNEL);
+
+    modbus_frame.active = index;
+}
+
+/**
+ * @brief lpuart1 閒置中斷，線路閒置超過 MODBUS_IDLE_CHARS 即為一個完整訊框
+ *
+ * @note 取代 SDK 的 LPUART1 中斷 (發送已由 app_uart.c 直接驅動 DMA，不需要)；
+ *       主迴圈尚未處理上一個訊框時丟棄新訊框並沿用同一個緩衝
+ */
+static void modbus_uart_isr(void)
+{
+    uint32_t stat = LPUART1->STAT;
+    uint16_t size;
+    bool error;
+
+    /* 旗標皆為寫 1 清除，溢位不清除時接收會停止 */
+    LPUART1->STAT = stat & (LPUART_STAT_IDLE_MASK | LPUART_STAT_OR_MASK | LPUART_STAT_NF_MASK | LPUART_STAT_FE_MASK | LPUART_STAT_PF_MASK);
+
+    if (!(stat & LPUART_STAT_IDLE_MASK))
+    {
+        return;
+    }
+
+    DMA->CERQ = DMA_CERQ_CERQ(MODBUS_RX_DMA_CHANNEL);
+
+    while (DMA->TCD[MODBUS_RX_DMA_CHANNEL].CSR & DMA_TCD_CSR_ACTIVE_MASK)
+    {
+    }
+
+    error = (stat & (LPUART_STAT_OR_MASK | LPUART_STAT_NF_MASK | LPUART_STAT_FE_MASK | LPUART_STAT_PF_MASK)) != 0U;
+
+    if (DMA->TCD[MODBUS_RX_DMA_CHANNEL].CSR & DMA_TCD_CSR_DONE_MASK)
+    {
+        /* 超過 RTU 最大長度 */
+        size = 0;
+        error = true;
+    }
+    else
+    {
+        size = MODBUS_RTU_FRAME_MAX - (DMA->TCD[MODBUS_RX_DMA_CHANNEL].CITER.ELINKNO & DMA_TCD_CITER_ELINKNO_CITER_MASK);
+    }
+
+    if (error)
+    {
+        modbus_frame.error++;
+        modbus_rx_start(modbus_frame.active);
+    }
+    else if ((size == 0) || modbus_frame.size)
+    {
+        if (size)
+        {
+            modbus_frame.overrun++;
+        }
+
+        modbus_rx_start(modbus_frame.active);
+    }
+    else
+    {
+        modbus_frame.size = size;
+        modbus_rx_start(modbus_frame.active ^ 1U);
+    }
+}
+
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Modbus RTU 從站初始化，uart1 接收改由這裡以 DMA + 閒置中斷處理，需在 uart_init() 與 app_uart_init() 之後
+ */
+void app_modbus_init(void)
+{
+#if APP_MODBUS
+    modbus_rtu_init(&modbus, &modbus_config);
+
+    modbus_frame.size = 0;
+    modbus_frame.overrun = 0;
+    modbus_frame.error = 0;
+
+    LPUART1->CTRL = (LPUART1->CTRL & ~(LPUART_CTRL_IDLECFG_MASK | LPUART_CTRL_ILT_MASK))
+                  | LPUART_CTRL_IDLECFG(MODBUS_IDLE_CHARS) | LPUART_CTRL_ILT(1);
+    LPUART1->STAT = LPUART_STAT_IDLE_MASK | LPUART_STAT_OR_MASK | LPUART_STAT_NF_MASK | LPUART_STAT_FE_MASK | LPUART_STAT_PF_MASK;
+
+    modbus_rx_start(0);
+
+    LPUART1->BAUD |= LPUART_BAUD_RDMAE_MASK;
+    LPUART1->CTRL |= LPUART_CTRL_ILIE_MASK | LPUART_CTRL_RE_MASK | LPUART_CTRL_TE_MASK;
+
+    INT_SYS_InstallHandler(LPUART1_RxTx_IRQn, &modbus_uart_isr, (isr_t*)0);
+    INT_SYS_EnableIRQ(LPUART1_RxTx_IRQn);
+#endif
+}
+
+/**
+ * @brief 處理已收到的請求並排入回應，每次主迴圈調用
+ *
+ * @note 上一個回應尚未送出時延後處理，回應緩衝不複製直接交給發送佇列
+ */
+void app_modbus_task(void)
+{
+#if APP_MODBUS
+    uint16_t size = modbus_frame.size;
+    uint16_t len;
+
+    if (!size || !app_uart_sent(&modbus_response[0]))
+    {
+        return;
+    }
+
+    len = modbus_rtu_handle(&modbus, &modbus_frame.buffer[modbus_frame.active ^ 1U][0], size, &modbus_response[0]);
+    modbus_frame.size = 0;
+
+    if (len)
+    {
+        (void)app_uart_post(&modbus_response[0], len);
+    }
+#endif
+}
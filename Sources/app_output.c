@@ -0,0 +1,234 @@
+#include "app.h"
+
+static GPIO_Type* const output_gpio[OUTPUT_PORT_MAX] = GPIO_BASE_PTRS;
+
+static struct
+{
+    uint32_t image[OUTPUT_PORT_MAX];            /** 邏輯輸出影像 */
+    uint32_t latch[OUTPUT_PORT_MAX];            /** 最後寫入硬體的狀態 */
+    volatile uint32_t force[OUTPUT_PORT_MAX];   /** 由中斷強制的腳位 */
+    volatile uint32_t level[OUTPUT_PORT_MAX];   /** 強制的電位 */
+    volatile uint32_t lock[OUTPUT_PORT_MAX];    /** 由保護動作閂鎖的腳位，只有 app_output_release() 解除 */
+    volatile uint32_t lock_level[OUTPUT_PORT_MAX];  /** 閂鎖的電位 */
+    uint32_t override[OUTPUT_PORT_MAX];         /** 由診斷接管的腳位 */
+    uint32_t override_level[OUTPUT_PORT_MAX];   /** 接管的電位 */
+} output;
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 輸出影像初始化，需在 PINS_DRV_Init() 之後調用
+ *
+ * @note 以目前的 PDOR 作為初始影像，未經影像寫入的腳位不會被改變
+ */
+void app_output_init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < OUTPUT_PORT_MAX; i++)
+    {
+        output.image[i] = output_gpio[i]->PDOR;
+        output.latch[i] = output.image[i];
+        output.force[i] = 0;
+        output.level[i] = 0;
+        output.lock[i] = 0;
+        output.lock_level[i] = 0;
+        output.override[i] = 0;
+        output.override_level[i] = 0;
+    }
+}
+
+/**
+ * @brief 寫入邏輯輸出，只更新影像，由 app_output_flush() 統一輸出
+ *
+ * @param port 埠
+ * @param pin 腳位
+ * @param level 輸出電位
+ *
+ * @note 只能在主迴圈調用，中斷內需使用 app_output_force()
+ */
+void app_output_write(output_port_t port, uint8_t pin, bool level)
+{
+    if (level)
+    {
+        output.image[port] |= (1UL << pin);
+    }
+    else
+    {
+        output.image[port] &= ~(1UL << pin);
+    }
+}
+
+/**
+ * @brief 反轉邏輯輸出
+ *
+ * @param port 埠
+ * @param pin 腳位
+ */
+void app_output_toggle(output_port_t port, uint8_t pin)
+{
+    output.image[port] ^= (1UL << pin);
+}
+
+/**
+ * @brief 中斷內立即輸出，並鎖定該腳位直到主迴圈的影像跟上
+ *
+ * @param port 埠
+ * @param pin 腳位
+ * @param level 輸出電位
+ *
+ * @note 鎖定期間 app_output_flush() 不會改變該腳位；
+ *       影像寫入相同電位後自動解除，之後恢復由影像控制
+ */
+void app_output_force(output_port_t port, uint8_t pin, bool level)
+{
+    uint32_t mask = (1UL << pin);
+
+    if (level)
+    {
+        output.level[port] |= mask;
+    }
+    else
+    {
+        output.level[port] &= ~mask;
+    }
+
+    output.force[port] |= mask;
+
+    /* 已被閂鎖的腳位維持閂鎖的電位 */
+    if (!(output.lock[port] & mask))
+    {
+        if (level)
+        {
+            output_gpio[port]->PSOR = mask;
+        }
+        else
+        {
+            output_gpio[port]->PCOR = mask;
+        }
+
+        output.latch[port] = (output.latch[port] & ~mask) | (output.level[port] & mask);
+    }
+}
+
+/**
+ * @brief 中斷內立即輸出並閂鎖該腳位 (保護動作)
+ *
+ * @param port 埠
+ * @param pin 腳位
+ * @param level 輸出電位
+ *
+ * @note 與 app_output_force() 不同，影像寫入相同電位也不會解除，
+ *       直到 app_output_release() 才恢復由影像控制
+ */
+void app_output_lock(output_port_t port, uint8_t pin, bool level)
+{
+    uint32_t mask = (1UL << pin);
+
+    if (level)
+    {
+        output.lock_level[port] |= mask;
+        output_gpio[port]->PSOR = mask;
+    }
+    else
+    {
+        output.lock_level[port] &= ~mask;
+        output_gpio[port]->PCOR = mask;
+    }
+
+    output.lock[port] |= mask;
+    output.latch[port] = (output.latch[port] & ~mask) | (output.lock_level[port] & mask);
+}
+
+/**
+ * @brief 解除 app_output_force() 與 app_output_lock() 的鎖定，之後由影像控制
+ *
+ * @param port 埠
+ * @param pin 腳位
+ */
+void app_output_release(output_port_t port, uint8_t pin)
+{
+    INT_SYS_DisableIRQGlobal();
+    output.force[port] &= ~(1UL << pin);
+    output.lock[port] &= ~(1UL << pin);
+    INT_SYS_EnableIRQGlobal();
+}
+
+/**
+ * @brief 診斷接管輸出 (UDS IO 控制)，接管期間忽略影像寫入
+ *
+ * @param port 埠
+ * @param pin 腳位
+ * @param enable true: 接管，false: 交回影像控制
+ * @param level 接管的電位
+ *
+ * @note 只能在主迴圈調用；app_output_force() / app_output_lock() 仍優先於接管，
+ *       接管的電位也不會解除 app_output_force() 的鎖定
+ */
+void app_output_override(output_port_t port, uint8_t pin, bool enable, bool level)
+{
+    uint32_t mask = (1UL << pin);
+
+    output.override[port] = enable ? (output.override[port] | mask) : (output.override[port] & ~mask);
+    output.override_level[port] = level ? (output.override_level[port] | mask) : (output.override_level[port] & ~mask);
+}
+
+/**
+ * @brief 解除所有診斷接管
+ */
+void app_output_override_clear(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < OUTPUT_PORT_MAX; i++)
+    {
+        output.override[i] = 0;
+    }
+}
+
+/**
+ * @brief 將影像輸出到硬體，每個有變化的埠只寫一次 PSOR 與 PCOR
+ *
+ * @note 同一週期內重複寫入的輸出只會反映最後的狀態，不會產生毛刺；
+ *       比對與寫入期間關閉中斷，避免覆蓋 app_output_force() / app_output_lock() 的輸出；
+ *       優先順序: 閂鎖 > 強制 > 診斷接管 > 影像
+ */
+void app_output_flush(void)
+{
+    uint32_t image;
+    uint32_t force;
+    uint32_t lock;
+    uint32_t change;
+    uint8_t i;
+
+    for (i = 0; i < OUTPUT_PORT_MAX; i++)
+    {
+        image = (output.image[i] & ~output.override[i]) | (output.override_level[i] & output.override[i]);
+
+        INT_SYS_DisableIRQGlobal();
+
+        force = output.force[i];
+
+        if (force)
+        {
+            /* 程式的影像已經跟上強制的電位，解除鎖定 (診斷接管不算) */
+            force &= (output.image[i] ^ output.level[i]);
+            output.force[i] = force;
+        }
+
+        image = (image & ~force) | (output.level[i] & force);
+
+        lock = output.lock[i];
+        image = (image & ~lock) | (output.lock_level[i] & lock);
+        change = image ^ output.latch[i];
+
+        if (change)
+        {
+            output_gpio[i]->PSOR = change & image;
+            output_gpio[i]->PCOR = change & ~image;
+            output.latch[i] = image;
+        }
+
+        INT_SYS_EnableIRQGlobal();
+    }
+}
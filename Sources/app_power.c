@@ -0,0 +1,270 @@
+#include "app.h"
+
+#define POWER_SCS_SIRC                          (2U)
+#define POWER_SCS(reg)                          (((reg) & SCG_CSR_SCS_MASK) >> SCG_CSR_SCS_SHIFT)
+
+#define POWER_RUNM_RUN                          (0U)
+#define POWER_RUNM_HSRUN                        (3U)
+#define POWER_PMSTAT_RUN                        (0x01U)
+#define POWER_PMSTAT_HSRUN                      (0x80U)
+
+#define CLOCK_RUN_HZ                            (48000000UL)    /** RUN (FIRC) 核心時脈，負載以此換算 */
+#define CLOCK_UP_LOAD                           (70U)       /** 負載 (%) 超過時升頻 */
+#define CLOCK_DOWN_LOAD                         (40U)       /** 負載 (%) 低於此值持續 CLOCK_DOWN_DELAY 後降頻 */
+#define CLOCK_DOWN_DELAY                        (10U)       /** (s) */
+
+static struct
+{
+    bool standby;
+    uint32_t rccr;                              /** 進入待機前的 RUN 時脈設定 */
+    clock_profile_t profile;
+    uint32_t last;                              /** 上一次主迴圈的 CYCCNT */
+    uint32_t floor;                             /** 上一個視窗內最短的主迴圈 (cycles)，視為空轉 */
+    uint32_t floor_next;
+    uint32_t busy;                              /** 本視窗扣除空轉後的 cycles */
+    uint8_t load;                               /** 上一個視窗的負載 (%，換算為 RUN 時脈) */
+    uint8_t down_count;
+} power;
+
+static void clock_profile_set(clock_profile_t profile);
+static bool clock_boost(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 進入待機，系統時脈由 FIRC 48 MHz 降為 SIRC 8 MHz 並關閉 FIRC，主迴圈改為等待中斷
+ *
+ * @note LPTMR、LPUART、ADC 使用 SIRC，FlexCAN 使用 SOSC，切換時脈不影響時基、鮑率與 CAN 同步；
+ *       FTM 使用系統時脈，待機期間 PWM 頻率會改變，此時輸出皆為 0 %
+ */
+void app_standby_enter(void)
+{
+    if (power.standby)
+    {
+        return;
+    }
+
+    /* SCG->RCCR 只在 RUN 生效，先離開 HSRUN */
+    clock_profile_set(CLOCK_PROFILE_RUN);
+    power.rccr = SCG->RCCR;
+
+    INT_SYS_DisableIRQGlobal();
+
+    /* core 8 MHz, bus 8 MHz (FlexCAN 要求不低於 SOSC), flash 4 MHz */
+    SCG->RCCR = SCG_RCCR_SCS(POWER_SCS_SIRC) | SCG_RCCR_DIVCORE(0) | SCG_RCCR_DIVBUS(0) | SCG_RCCR_DIVSLOW(1);
+
+    while (POWER_SCS(SCG->CSR) != POWER_SCS_SIRC)
+    {
+    }
+
+    SCG->FIRCCSR &= ~SCG_FIRCCSR_FIRCEN_MASK;
+
+    INT_SYS_EnableIRQGlobal();
+
+    power.standby = true;
+    app_logger("standby\r\n");
+}
+
+/**
+ * @brief 離開待機，恢復原本的時脈設定
+ *
+ * @note FIRC 啟動只需數十 us，CAN 不需要重新同步
+ */
+void app_standby_exit(void)
+{
+    if (!power.standby)
+    {
+        return;
+    }
+
+    INT_SYS_DisableIRQGlobal();
+
+    SCG->FIRCCSR |= SCG_FIRCCSR_FIRCEN_MASK;
+
+    while (!(SCG->FIRCCSR & SCG_FIRCCSR_FIRCVLD_MASK))
+    {
+    }
+
+    SCG->RCCR = power.rccr;
+
+    while (POWER_SCS(SCG->CSR) != POWER_SCS(power.rccr))
+    {
+    }
+
+    INT_SYS_EnableIRQGlobal();
+
+    power.standby = false;
+    app_logger("resume\r\n");
+}
+
+/**
+ * @brief 主迴圈閒置，待機時停止 core 直到下一個中斷
+ *
+ * @note 喚醒來源: LPTMR 時基(10 ms)、按鍵 PORT 中斷、FlexCAN 接收、LPUART
+ */
+void app_idle(void)
+{
+    if (power.standby)
+    {
+        STANDBY();
+    }
+}
+
+/**
+ * @brief 時脈調速初始化，允許 HSRUN 並開啟 DWT 週期計數
+ *
+ * @note PMPROT 重設後只能寫入一次，VLPR 一併允許保留給之後使用
+ */
+void app_clock_init(void)
+{
+    SMC->PMPROT = SMC_PMPROT_AHSRUN_MASK | SMC_PMPROT_AVLP_MASK;
+
+    CORE_DEMCR |= CORE_DEMCR_TRCENA;
+    CORE_DWT_CTRL |= CORE_DWT_CTRL_CYCCNTENA;
+
+    power.profile = CLOCK_PROFILE_RUN;
+    power.last = CORE_DWT_CYCCNT;
+    power.floor = UINT32_MAX;
+    power.floor_next = UINT32_MAX;
+    power.busy = 0;
+    power.load = 0;
+    power.down_count = 0;
+}
+
+/**
+ * @brief 依 CPU 負載在 RUN (FIRC 48 MHz) 與 HSRUN (SPLL 112 MHz) 間切換，每次主迴圈結束時調用
+ *
+ * @note 負載 = 每次主迴圈扣除空轉時間後的 cycles 加總 / 1 s 的 RUN cycles，換算為 RUN 時脈避免升頻後誤判降頻；
+ *       預充、關機、錯誤與 CAN 錯誤計數偏高時固定升頻，穩定運轉且負載低時降回 RUN；
+ *       待機 (SIRC) 由 app_standby_enter()/app_standby_exit() 管理，期間不調速。
+ *       VLPR 不使用: VLPR 下 FlexCAN 無法運作
+ */
+void app_clock_task(void)
+{
+    uint32_t now = CORE_DWT_CYCCNT;
+    uint32_t pass = now - power.last;
+    uint64_t busy;
+
+    power.last = now;
+
+    if (power.standby)
+    {
+        power.busy = 0;
+        power.floor_next = UINT32_MAX;
+        return;
+    }
+
+    if (pass < power.floor_next)
+    {
+        power.floor_next = pass;
+    }
+
+    if (pass > power.floor)
+    {
+        power.busy += pass - power.floor;
+    }
+
+    if (!time_flag.bits.t1_00s)
+    {
+        return;
+    }
+
+    busy = ((uint64_t)power.busy * 100U) / CLOCK_RUN_HZ;
+    power.load = (busy > 100U) ? 100U : (uint8_t)busy;
+    power.busy = 0;
+    power.floor = power.floor_next;
+    power.floor_next = UINT32_MAX;
+
+    if (clock_boost() || (power.load >= CLOCK_UP_LOAD))
+    {
+        power.down_count = 0;
+        clock_profile_set(CLOCK_PROFILE_HSRUN);
+    }
+    else if ((power.profile == CLOCK_PROFILE_HSRUN) && (power.load < CLOCK_DOWN_LOAD))
+    {
+        if (++power.down_count >= CLOCK_DOWN_DELAY)
+        {
+            power.down_count = 0;
+            clock_profile_set(CLOCK_PROFILE_RUN);
+        }
+    }
+    else
+    {
+        power.down_count = 0;
+    }
+}
+
+/**
+ * @brief 目前的時脈設定
+ */
+clock_profile_t app_clock_profile(void)
+{
+    return power.profile;
+}
+
+/**
+ * @brief 上一秒的 CPU 負載 (%，換算為 RUN 時脈)
+ */
+uint8_t app_clock_load(void)
+{
+    return power.load;
+}
+
+/**
+ * @brief 切換 RUN/HSRUN，時脈由 SCG 依 RCCR/HCCR 自動切換
+ *
+ * @note LPTMR、LPUART、ADC 使用 SIRC，FlexCAN 使用 SOSC，不受影響 (HSRUN bus 56 MHz 仍高於 SOSC)；
+ *       FTM 使用系統時脈，切換後由 app_pwm_clock_update() 重新計算週期
+ */
+static void clock_profile_set(clock_profile_t profile)
+{
+    uint32_t runm = (profile == CLOCK_PROFILE_HSRUN) ? POWER_RUNM_HSRUN : POWER_RUNM_RUN;
+    uint32_t pmstat = (profile == CLOCK_PROFILE_HSRUN) ? POWER_PMSTAT_HSRUN : POWER_PMSTAT_RUN;
+
+    if (power.profile == profile)
+    {
+        return;
+    }
+
+    INT_SYS_DisableIRQGlobal();
+
+    SMC->PMCTRL = (SMC->PMCTRL & ~SMC_PMCTRL_RUNM_MASK) | SMC_PMCTRL_RUNM(runm);
+
+    while ((SMC->PMSTAT & SMC_PMSTAT_PMSTAT_MASK) != pmstat)
+    {
+    }
+
+    INT_SYS_EnableIRQGlobal();
+
+    SystemCoreClockUpdate();
+    app_pwm_clock_update();
+
+    power.profile = profile;
+    app_logger("clock %s, load %d%%\r\n", (profile == CLOCK_PROFILE_HSRUN) ? "hsrun" : "run", power.load);
+}
+
+/**
+ * @brief 是否需要固定升頻: 電堆啟停/錯誤中，或任一 CAN 錯誤計數已達警告
+ */
+static bool clock_boost(void)
+{
+    fc135kw_status_t fc = fc135kw_status(&fc135kw);
+    tyt60kw_status_t tyt = tyt60kw_status(&tyt60kw);
+    uint8_t i;
+
+    if ((fc == FC135KW_PRECHARGE) || (fc == FC135KW_SHUTDOWN) || (fc == FC135KW_ERROR) ||
+        (tyt == TYT60KW_PRECHARGE) || (tyt == TYT60KW_SHUTDOWN) || (tyt == TYT60KW_ERROR))
+    {
+        return true;
+    }
+
+    for (i = 0; i < CAN_INSTANCE_COUNT; i++)
+    {
+        if (can_health_state(&can_health[i]) >= CAN_HEALTH_WARNING)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
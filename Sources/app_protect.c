@@ -0,0 +1,240 @@
+#include "app.h"
+
+#define PROTECT_ADC_FULL                        (4096U)     /** 12 bits */
+#define PROTECT_ADC_VREF_MV                     (5000U)
+#define PROTECT_RAW(mv)                         ((uint16_t)(((uint32_t)(mv) * PROTECT_ADC_FULL) / PROTECT_ADC_VREF_MV))
+#define PROTECT_STACK_ALL                       ((1U << STACK_FC135KW) | (1U << STACK_TYT60KW))
+
+typedef struct protect_channel
+{
+    uint32_t adc;                               /** ADC 編號，每個來源獨占一個 ADC (比較設定為整個 ADC 共用) */
+    adc_inputchannel_t input;
+    IRQn_Type irq;
+    uint16_t trip;                              /** 跳脫點 (ADC 值) */
+} protect_channel_t;
+
+static void adc0_isr(void);
+static void adc1_isr(void);
+
+/* 類比輸入維持重置時的 PORT_PIN_DISABLED (類比功能)，不需另外設定腳位 */
+static const protect_channel_t protect_channel[PROTECT_SOURCE_MAX] =
+{
+    [PROTECT_BUS_VOLTAGE] = {.adc = INST_ADCONV1, .input = ADC_INPUTCHAN_EXT12, .irq = ADC0_IRQn, .trip = PROTECT_RAW(PROTECT_VOLTAGE_TRIP_MV), },  // PTC14 AI_1
+    [PROTECT_BUS_CURRENT] = {.adc = INST_ADCONV2, .input = ADC_INPUTCHAN_EXT3, .irq = ADC1_IRQn, .trip = PROTECT_RAW(PROTECT_CURRENT_TRIP_MV), },   // PTD3 AI_10
+};
+
+static struct
+{
+    volatile uint8_t latched;                   /** 尚未清除跳脫的 stack (bit n = stack_id_t n) */
+    bool logged;
+    protect_event_t event;
+} protect;
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 啟動連續轉換，轉換值大於等於跳脫點時才會產生完成中斷
+ *
+ * @param source 來源
+ */
+static void protect_start(protect_source_t source)
+{
+    const protect_channel_t* ch = &protect_channel[source];
+    adc_chan_config_t chan;
+
+    chan.interruptEnable = true;
+    chan.channel = ch->input;
+
+    ADC_DRV_ConfigChan(ch->adc, 0, &chan);
+}
+
+/**
+ * @brief 停止連續轉換，跳脫後避免持續觸發中斷
+ *
+ * @param source 來源
+ */
+static void protect_stop(protect_source_t source)
+{
+    adc_chan_config_t chan;
+
+    chan.interruptEnable = false;
+    chan.channel = ADC_INPUTCHAN_DISABLED;
+
+    ADC_DRV_ConfigChan(protect_channel[source].adc, 0, &chan);
+}
+
+/**
+ * @brief 跳脫 (中斷內)，遮蔽 PWM、斷開 relay 並閂鎖事件
+ *
+ * @param source 來源
+ *
+ * @note relay 以 app_output_lock() 閂鎖，直到各 stack 的 app_protect_clear() 才解除；
+ *       部分 stack 已清除後再次跳脫時重新閂鎖全部，事件保留第一次的紀錄
+ */
+static void protect_trip(protect_source_t source)
+{
+    uint16_t raw = 0;
+
+    ADC_DRV_GetChanResult(protect_channel[source].adc, 0, &raw);
+    protect_stop(source);
+
+    app_pwm_mask(true);
+
+    FC_TYT60KW_HIGH_POWER_RELAY_LOCK(false);
+    FC_TYT60KW_IGN_LOCK(false);
+    FC_135KW_HIGH_POWER_RELAY_LOCK(false);
+    FC_135KW_IGN_LOCK(false);
+
+    tyt60kw_trip(&tyt60kw);
+    fc135kw_trip(&fc135kw);
+
+    if (protect.latched == 0)
+    {
+        protect.event.source = source;
+        protect.event.raw = raw;
+        protect.event.time = timebase_now();
+    }
+
+    protect.latched = PROTECT_STACK_ALL;
+}
+
+static void adc0_isr(void) { protect_trip(PROTECT_BUS_VOLTAGE); }
+static void adc1_isr(void) { protect_trip(PROTECT_BUS_CURRENT); }
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 硬體保護初始化，需在 stack 初始化之後調用
+ *
+ * @note ADC 以軟體觸發連續轉換，比較功能只在超過跳脫點時設定 COCO，
+ *       正常運轉時不產生中斷，跳脫反應不受主迴圈週期影響
+ */
+void app_protect_init(void)
+{
+    static const isr_t isr[PROTECT_SOURCE_MAX] =
+    {
+        [PROTECT_BUS_VOLTAGE] = adc0_isr,
+        [PROTECT_BUS_CURRENT] = adc1_isr,
+    };
+
+    const protect_channel_t* ch;
+    adc_converter_config_t converter;
+    adc_compare_config_t compare;
+    uint8_t i;
+
+    protect.latched = 0;
+    protect.logged = false;
+
+    for (i = 0; i < PROTECT_SOURCE_MAX; i++)
+    {
+        ch = &protect_channel[i];
+
+        converter = adConv1_ConvConfig0;
+        converter.resolution = ADC_RESOLUTION_12BIT;
+        converter.trigger = ADC_TRIGGER_SOFTWARE;
+        converter.dmaEnable = false;
+        converter.continuousConvEnable = true;
+
+        ADC_DRV_Reset(ch->adc);
+        ADC_DRV_ConfigConverter(ch->adc, &converter);
+        ADC_DRV_AutoCalibration(ch->adc);
+
+        /* ACFGT = 1, ACREN = 0: 轉換值 >= compVal1 才完成 */
+        compare.compareEnable = true;
+        compare.compareGreaterThanEnable = true;
+        compare.compareRangeFuncEnable = false;
+        compare.compVal1 = ch->trip;
+        compare.compVal2 = 0;
+        ADC_DRV_ConfigHwCompare(ch->adc, &compare);
+
+        INT_SYS_InstallHandler(ch->irq, isr[i], (isr_t*)0);
+        INT_SYS_SetPriority(ch->irq, 0);
+        INT_SYS_EnableIRQ(ch->irq);
+
+        protect_start((protect_source_t)i);
+    }
+}
+
+/**
+ * @brief 保護事件紀錄，在主迴圈調用
+ */
+void app_protect_task(void)
+{
+    static const char* const name[PROTECT_SOURCE_MAX] =
+    {
+        [PROTECT_BUS_VOLTAGE] = "bus voltage",
+        [PROTECT_BUS_CURRENT] = "bus current",
+    };
+
+    if (protect.latched && !protect.logged)
+    {
+        protect.logged = true;
+        app_logger("[protect]%s trip, raw: %d, time: %d ms\r\n",
+            name[protect.event.source], protect.event.raw, (int)(protect.event.time / 1000U));
+    }
+}
+
+/**
+ * @brief 清除指定 stack 的跳脫，恢復該 stack 的 relay 控制並重新啟動監測
+ *
+ * @param stack 由主機清除錯誤的 stack
+ *
+ * @note 另一個 stack 仍維持閂鎖，PWM 在全部 stack 清除後才恢復；
+ *       若仍超過跳脫點，下一次轉換會再次跳脫
+ */
+void app_protect_clear(stack_id_t stack)
+{
+    uint8_t i;
+
+    if (!(protect.latched & (1U << stack)))
+    {
+        return;
+    }
+
+    INT_SYS_DisableIRQGlobal();
+
+    if (stack == STACK_FC135KW)
+    {
+        FC_135KW_HIGH_POWER_RELAY_RELEASE();
+        FC_135KW_IGN_RELEASE();
+    }
+    else
+    {
+        FC_TYT60KW_HIGH_POWER_RELAY_RELEASE();
+        FC_TYT60KW_IGN_RELEASE();
+    }
+
+    protect.latched &= (uint8_t)~(1U << stack);
+
+    if (protect.latched == 0)
+    {
+        app_pwm_mask(false);
+        protect.logged = false;
+    }
+
+    INT_SYS_EnableIRQGlobal();
+
+    app_logger("[protect]clear %s\r\n", (stack == STACK_FC135KW) ? "fc135kw" : "tyt60kw");
+
+    for (i = 0; i < PROTECT_SOURCE_MAX; i++)
+    {
+        protect_start((protect_source_t)i);
+    }
+}
+
+/**
+ * @brief 取得閂鎖的跳脫事件
+ *
+ * @param event 事件輸出
+ *
+ * @return true: 任一 stack 仍在跳脫狀態
+ */
+bool app_protect_event(protect_event_t* event)
+{
+    if (protect.latched && event)
+    {
+        *event = protect.event;
+    }
+
+    return protect.latched != 0;
+}
@@ -0,0 +1,223 @@
+#include "app.h"
+
+#define PWM_INSTANCE_MAX                        (4U)
+#define PWM_CHANNEL_MAX                         (3U)
+
+typedef struct pwm_instance
+{
+    const ftm_pwm_param_t* config;
+    uint8_t count;                              /** 通道數量 */
+    uint8_t channel[PWM_CHANNEL_MAX];           /** 硬體通道 */
+    uint16_t ticks[PWM_CHANNEL_MAX];            /** 目前的比較值 */
+    uint32_t period;                            /** PWM 週期 (ticks)，MOD + 1 */
+    uint32_t scale;                             /** 每 0.01 % 對應的 ticks (Q16) */
+    uint8_t mask;                               /** 使用中的硬體通道 (OUTMASK) */
+    bool dirty;
+} pwm_instance_t;
+
+static ftm_state_t ftm_state[PWM_INSTANCE_MAX];
+static FTM_Type* const ftm_base[PWM_INSTANCE_MAX] = FTM_BASE_PTRS;
+static pwm_instance_t pwm[PWM_INSTANCE_MAX] =
+{
+    [INST_FLEXTIMER_PWM0] = { .config = &flexTimer_pwm0_PwmConfig },
+    [INST_FLEXTIMER_PWM1] = { .config = &flexTimer_pwm1_PwmConfig },
+    [INST_FLEXTIMER_PWM2] = { .config = &flexTimer_pwm2_PwmConfig },
+    [INST_FLEXTIMER_PWM3] = { .config = &flexTimer_pwm3_PwmConfig },
+};
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief FTM 目前的 PWM 週期 (ticks)
+ *
+ * @note 邊緣對齊模式下 MOD = 週期 - 1；ftm_state.ftmPeriod 在 FTM_DRV_InitPwm() 後是週期，
+ *       FTM_DRV_UpdatePwmPeriod() 後卻存放 MOD，因此直接由 MOD 計算
+ */
+static uint32_t period(uint8_t num)
+{
+    return (uint32_t)FTM_DRV_GetMod(ftm_base[num]) + 1U;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief PWM 初始化，預先計算每個通道的硬體編號與比例
+ */
+void app_pwm_init(void)
+{
+    static const ftm_user_config_t* const user_config[PWM_INSTANCE_MAX] =
+    {
+        [INST_FLEXTIMER_PWM0] = &flexTimer_pwm0_InitConfig,
+        [INST_FLEXTIMER_PWM1] = &flexTimer_pwm1_InitConfig,
+        [INST_FLEXTIMER_PWM2] = &flexTimer_pwm2_InitConfig,
+        [INST_FLEXTIMER_PWM3] = &flexTimer_pwm3_InitConfig,
+    };
+
+    uint8_t num;
+    uint8_t ch;
+    pwm_instance_t* p;
+
+    for (num = 0; num < PWM_INSTANCE_MAX; num++)
+    {
+        p = &pwm[num];
+
+        FTM_DRV_Init(num, user_config[num], &ftm_state[num]);
+        FTM_DRV_InitPwm(num, p->config);
+
+        p->count = p->config->nNumIndependentPwmChannels;
+
+        if (p->count > PWM_CHANNEL_MAX)
+        {
+            p->count = PWM_CHANNEL_MAX;
+        }
+
+        p->mask = 0;
+
+        for (ch = 0; ch < p->count; ch++)
+        {
+            p->channel[ch] = p->config->pwmIndependentChannelConfig[ch].hwChannelId;
+            p->ticks[ch] = 0;
+            p->mask |= (uint8_t)(1U << p->channel[ch]);
+        }
+
+        /* 無條件進位，確保 PWM_DUTY_FULL 剛好等於週期 */
+        p->period = period(num);
+        p->scale = (uint32_t)((((uint64_t)p->period << 16) + (PWM_DUTY_FULL - 1U)) / PWM_DUTY_FULL);
+        p->dirty = false;
+    }
+}
+
+/**
+ * @brief 設定 PWM 佔空比 (0.01 %)，只更新暫存值，由 app_pwm_flush() 統一同步輸出
+ *
+ * @param num FTM 編號
+ * @param ch 通道(設定檔中的順序)
+ * @param duty 佔空比 0 ~ PWM_DUTY_FULL
+ */
+void pwm_duty_fine(uint8_t num, uint8_t ch, uint16_t duty)
+{
+    pwm_instance_t* p;
+    uint16_t ticks;
+
+    if ((num >= PWM_INSTANCE_MAX) || (ch >= pwm[num].count))
+    {
+        return;
+    }
+
+    if (duty > PWM_DUTY_FULL)
+    {
+        duty = PWM_DUTY_FULL;
+    }
+
+    p = &pwm[num];
+
+    /* 比較值大於 MOD 時整個週期維持輸出，滿載直接使用週期 (MOD + 1) */
+    if (duty == PWM_DUTY_FULL)
+    {
+        ticks = (uint16_t)p->period;
+    }
+    else
+    {
+        ticks = (uint16_t)(((uint64_t)duty * p->scale) >> 16);
+    }
+
+    if (p->ticks[ch] != ticks)
+    {
+        p->ticks[ch] = ticks;
+        p->dirty = true;
+    }
+}
+
+/**
+ * @brief 設定 PWM 佔空比 (%)
+ *
+ * @param num FTM 編號
+ * @param ch 通道(設定檔中的順序)
+ * @param duty 佔空比 0 ~ 100
+ */
+void pwm_duty(uint8_t num, uint8_t ch, uint16_t duty)
+{
+    pwm_duty_fine(num, ch, (duty > 100U) ? PWM_DUTY_FULL : (uint16_t)(duty * (PWM_DUTY_FULL / 100U)));
+}
+
+/**
+ * @brief 同步輸出有變化的 FTM，每個 FTM 只寫入一次比較值並觸發一次軟體同步
+ *
+ * @note 同步在計數器 max loading point 生效，同一 FTM 的通道同時更新
+ */
+void app_pwm_flush(void)
+{
+    uint8_t num;
+    pwm_instance_t* p;
+
+    for (num = 0; num < PWM_INSTANCE_MAX; num++)
+    {
+        p = &pwm[num];
+
+        if (p->dirty)
+        {
+            p->dirty = false;
+            FTM_DRV_FastUpdatePwmChannels(num, p->count, &p->channel[0], &p->ticks[0], true);
+        }
+    }
+}
+
+/**
+ * @brief 遮蔽或恢復所有 PWM 輸出，遮蔽時通道立即回到非作用電位
+ *
+ * @param mask true: 遮蔽, false: 恢復
+ *
+ * @note OUTMASK 設定為系統時脈更新，不需同步，可在中斷內調用
+ */
+void app_pwm_mask(bool mask)
+{
+    uint8_t num;
+
+    for (num = 0; num < PWM_INSTANCE_MAX; num++)
+    {
+        (void)FTM_DRV_MaskOutputChannels(num, mask ? pwm[num].mask : 0U, false);
+    }
+}
+
+/**
+ * @brief 系統時脈變更後重新計算 FTM 週期，維持 PWM 頻率與佔空比
+ *
+ * @note FTM 使用系統時脈，由 app_power.c 在切換 RUN/HSRUN 後調用；
+ *       MOD 與比較值在同一次同步的 loading point 一起更新，切換當下的一個週期頻率不同但佔空比不變
+ */
+void app_pwm_clock_update(void)
+{
+    uint8_t num;
+    uint8_t ch;
+    uint32_t period_old;
+    uint32_t period_new;
+    pwm_instance_t* p;
+
+    for (num = 0; num < PWM_INSTANCE_MAX; num++)
+    {
+        p = &pwm[num];
+        period_old = p->period;
+
+        ftm_state[num].ftmSourceClockFrequency = FTM_DRV_GetFrequency(num);
+        (void)FTM_DRV_UpdatePwmPeriod(num, FTM_PWM_UPDATE_IN_DUTY_CYCLE, p->config->uFrequencyHZ, false);
+
+        period_new = period(num);
+
+        if ((period_old == 0U) || (period_new == period_old))
+        {
+            continue;
+        }
+
+        p->period = period_new;
+
+        /* 滿載的通道 (ticks == period_old) 換算後剛好等於新的週期 */
+        for (ch = 0; ch < p->count; ch++)
+        {
+            p->ticks[ch] = (uint16_t)(((uint32_t)p->ticks[ch] * period_new) / period_old);
+        }
+
+        p->scale = (uint32_t)((((uint64_t)period_new << 16) + (PWM_DUTY_FULL - 1U)) / PWM_DUTY_FULL);
+        p->dirty = false;
+        FTM_DRV_FastUpdatePwmChannels(num, p->count, &p->channel[0], &p->ticks[0], true);
+    }
+}
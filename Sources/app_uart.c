@@ -0,0 +1,208 @@
+#include "app.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+#define UART_TX_DMA_CHANNEL                     (4U)        /** lpuart1_InitConfig0.txDMAChannel */
+#define UART_PRINTF_SIZE                        (128U)
+
+static uart_txq_t uart_txq;
+static uint8_t uart_tx_arena[1024];
+static edma_software_tcd_t uart_tcd[UART_TXQ_ENTRY_MAX] __attribute__((aligned(32)));
+static volatile uint8_t uart_tx_count;          /** 目前 DMA 串接中的段數，0: 閒置 */
+
+static void uart_tx_start(void);
+static void uart_tx_done(void* parameter, edma_chn_status_t status);
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief uart1 發送佇列初始化，需在 EDMA_DRV_Init() 與 uart_init() 之後
+ *
+ * @note 接收仍由 s32_uart (DMA 通道 3) 處理，發送改由這裡直接驅動通道 4，不再調用 uart_write()
+ */
+void app_uart_init(void)
+{
+    uart_txq_init(&uart_txq, &uart_tx_arena[0], sizeof(uart_tx_arena));
+    uart_tx_count = 0;
+
+    (void)EDMA_DRV_InstallCallback(UART_TX_DMA_CHANNEL, uart_tx_done, NULL);
+}
+
+/**
+ * @brief DMA 閒置時送出佇列中的資料，每次主迴圈調用
+ *
+ * @note 發送中新排入的資料由完成中斷直接接續，這裡只處理閒置時的啟動
+ */
+void app_uart_task(void)
+{
+    if (uart_tx_count)
+    {
+        return;
+    }
+
+    INT_SYS_DisableIRQGlobal();
+
+    if (!uart_tx_count)
+    {
+        uart_tx_start();
+    }
+
+    INT_SYS_EnableIRQGlobal();
+}
+
+/**
+ * @brief 複製後排入發送，不會阻塞，佇列已滿時丟棄
+ *
+ * @param data 資料，調用後即可重新使用
+ * @param size 長度
+ *
+ * @return true 已排入
+ */
+bool app_uart_write(const uint8_t* data, uint16_t size)
+{
+    bool result = uart_txq_write(&uart_txq, data, size);
+
+    app_uart_task();
+
+    return result;
+}
+
+/**
+ * @brief 不複製直接排入發送 (常駐的字串或遙測緩衝)，不會阻塞，佇列已滿時丟棄
+ *
+ * @param data 資料，app_uart_sent() 回傳 true 前不可修改
+ * @param size 長度
+ *
+ * @return true 已排入
+ */
+bool app_uart_post(const uint8_t* data, uint16_t size)
+{
+    bool result = uart_txq_post(&uart_txq, data, size);
+
+    app_uart_task();
+
+    return result;
+}
+
+/**
+ * @brief app_uart_post() 的緩衝是否已送出
+ */
+bool app_uart_sent(const uint8_t* data)
+{
+    return uart_txq_sent(&uart_txq, data);
+}
+
+/**
+ * @brief 格式化輸出，超過 UART_PRINTF_SIZE 的部分截斷；APP_MODBUS 開啟時不輸出
+ */
+void app_printf(const char* fmt, ...)
+{
+#if APP_MODBUS
+    /* uart1 為 Modbus 匯流排，主動輸出會破壞訊框 */
+    (void)fmt;
+#else
+    char buffer[UART_PRINTF_SIZE];
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vsnprintf(&buffer[0], sizeof(buffer), fmt, args);
+    va_end(args);
+
+    if (len <= 0)
+    {
+        return;
+    }
+
+    if (len >= (int)sizeof(buffer))
+    {
+        len = sizeof(buffer) - 1;
+    }
+
+    (void)app_uart_write((const uint8_t*)&buffer[0], (uint16_t)len);
+#endif
+}
+
+/**
+ * @brief 以佇列中尚未發送的描述項建立 scatter-gather 串接並啟動 DMA
+ *
+ * @note 每段一個 TCD (依佇列位置對應，不需複製)，只有最後一段觸發完成中斷並停止請求 (DREQ)，
+ *       中間各段由 eDMA 自動載入下一個 TCD 接續發送；調用時需已遮蔽中斷
+ */
+static void uart_tx_start(void)
+{
+    edma_software_tcd_t* tcd;
+    const uart_txq_entry_t* entry;
+    uint8_t first;
+    uint8_t count;
+    uint8_t slot;
+    uint8_t i;
+
+    count = uart_txq_issue(&uart_txq, &first);
+
+    if (!count)
+    {
+        return;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        slot = UART_TXQ_SLOT(first + i);
+        entry = &uart_txq.entry[slot];
+        tcd = &uart_tcd[slot];
+
+        tcd->SADDR = (uint32_t)entry->data;
+        tcd->SOFF = 1;
+        tcd->ATTR = DMA_TCD_ATTR_SSIZE(0) | DMA_TCD_ATTR_DSIZE(0);
+        tcd->NBYTES = 1;
+        tcd->SLAST = 0;
+        tcd->DADDR = (uint32_t)&LPUART1->DATA;
+        tcd->DOFF = 0;
+        tcd->CITER = entry->size;
+        tcd->BITER = entry->size;
+
+        if (i == (count - 1U))
+        {
+            tcd->DLAST_SGA = 0;
+            tcd->CSR = DMA_TCD_CSR_INTMAJOR_MASK | DMA_TCD_CSR_DREQ_MASK;
+        }
+        else
+        {
+            tcd->DLAST_SGA = (int32_t)&uart_tcd[UART_TXQ_SLOT(slot + 1U)];
+            tcd->CSR = DMA_TCD_CSR_ESG_MASK;
+        }
+    }
+
+    uart_tx_count = count;
+
+    /* 第一個 TCD 直接寫入通道，CSR 最後寫入 */
+    tcd = &uart_tcd[UART_TXQ_SLOT(first)];
+    DMA->CDNE = DMA_CDNE_CDNE(UART_TX_DMA_CHANNEL);
+    DMA->TCD[UART_TX_DMA_CHANNEL].SADDR = tcd->SADDR;
+    DMA->TCD[UART_TX_DMA_CHANNEL].SOFF = (uint16_t)tcd->SOFF;
+    DMA->TCD[UART_TX_DMA_CHANNEL].ATTR = tcd->ATTR;
+    DMA->TCD[UART_TX_DMA_CHANNEL].NBYTES.MLNO = tcd->NBYTES;
+    DMA->TCD[UART_TX_DMA_CHANNEL].SLAST = (uint32_t)tcd->SLAST;
+    DMA->TCD[UART_TX_DMA_CHANNEL].DADDR = tcd->DADDR;
+    DMA->TCD[UART_TX_DMA_CHANNEL].DOFF = (uint16_t)tcd->DOFF;
+    DMA->TCD[UART_TX_DMA_CHANNEL].CITER.ELINKNO = tcd->CITER;
+    DMA->TCD[UART_TX_DMA_CHANNEL].DLASTSGA = (uint32_t)tcd->DLAST_SGA;
+    DMA->TCD[UART_TX_DMA_CHANNEL].BITER.ELINKNO = tcd->BITER;
+    DMA->TCD[UART_TX_DMA_CHANNEL].CSR = tcd->CSR;
+
+    DMA->SERQ = DMA_SERQ_SERQ(UART_TX_DMA_CHANNEL);
+    LPUART1->BAUD |= LPUART_BAUD_TDMAE_MASK;
+}
+
+/**
+ * @brief 串接的最後一段完成 (中斷內)，釋放整批描述項並接續發送期間新排入的資料
+ */
+static void uart_tx_done(void* parameter, edma_chn_status_t status)
+{
+    (void)parameter;
+    (void)status;
+
+    uart_txq_release(&uart_txq, uart_tx_count);
+    uart_tx_count = 0;
+    uart_tx_start();
+}
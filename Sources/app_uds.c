@@ -0,0 +1,309 @@
+#include "app.h"
+#include <string.h>
+
+#define UDS_IO(id, port, pin)                   { (id), ((uint32_t)(port) << 8) | (pin) }
+
+#define UDS_ROUTINE_REMOVE_BUBBLE               (0x0201U)
+#define UDS_ROUTINE_PURGE                       (0x0202U)
+
+#define UDS_ROUTINE_START                       (0x01U)
+#define UDS_ROUTINE_STOP                        (0x02U)
+
+#define UDS_IO_RETURN_CONTROL                   (0x00U)
+#define UDS_IO_SHORT_TERM_ADJUST                (0x03U)
+
+static bool uds_tx(const void* handle, const uint8_t data[8]);
+static void uds_deliver(const void* handle, const uint8_t* data, uint16_t size, bool functional);
+static uint8_t uds_io_control(const void* handle, uint32_t arg, uint8_t param, const uint8_t* state, uint16_t size);
+static uint8_t uds_routine_control(const void* handle, uint32_t arg, uint8_t type, const uint8_t* option, uint16_t size);
+static void uds_session_change(const void* handle, uds_session_t session);
+static bool uds_send(const void* handle, const uint8_t* head, uint16_t head_size, const uint8_t* body, uint16_t body_size);
+static bool uds_busy(const void* handle);
+
+/** DID 表，直接指向即時資料 (依 DID 遞增排列) */
+static const uds_did_t uds_did[] =
+{
+    /* 0x01xx: fc135kw */
+    UDS_DID(0x0100, fc135kw.status),
+    UDS_DID(0x0101, fc135kw.system_status),
+    UDS_DID(0x0102, fc135kw.power_setup),
+    UDS_DID(0x0103, fc135kw.H2_pressure),
+    UDS_DID(0x0104, fc135kw.H2_src_pressure),
+    UDS_DID(0x0105, fc135kw.water_temp),
+    UDS_DID(0x0106, fc135kw.water_temp_target),
+    UDS_DID(0x0107, fc135kw.error),
+    UDS_DID(0x0108, fc135kw.error_code),
+    UDS_DID(0x0109, fc135kw.trip),
+    UDS_DID(0x010A, fc135kw.purge),
+    UDS_DID(0x010B, fc135kw.warmup),
+    UDS_DID(0x010C, fc135kw.fault),
+
+    /* 0x02xx: tyt60kw */
+    UDS_DID(0x0200, tyt60kw.status),
+    UDS_DID(0x0201, tyt60kw.fc_status),
+    UDS_DID(0x0202, tyt60kw.power_setup),
+    UDS_DID(0x0203, tyt60kw.power_max),
+    UDS_DID(0x0204, tyt60kw.pcu_voltage),
+    UDS_DID(0x0205, tyt60kw.pcu_temp),
+    UDS_DID(0x0206, tyt60kw.w_temp_fco),
+    UDS_DID(0x0207, tyt60kw.error),
+    UDS_DID(0x0208, tyt60kw.error_code),
+    UDS_DID(0x0209, tyt60kw.trip),
+    UDS_DID(0x020A, tyt60kw.cooling_time),
+
+    /* 0x03xx: dcdc (bidc300100_bank)，陣列為記憶體原樣 (小端序) */
+    UDS_DID(0x0300, dcdc.count),
+    UDS_DID(0x0301, dcdc.present),
+    UDS_DID(0x0302, dcdc.current_setup),
+    UDS_DID(0x0303, dcdc.addr),
+    UDS_DID(0x0304, dcdc.current),
+    UDS_DID(0x0305, dcdc.temp),
+    UDS_DID(0x0306, dcdc.share),
+};
+
+/** IO 控制表，define_io.h 的數位輸出 (依 DID 遞增排列) */
+static const uds_control_t uds_io[] =
+{
+    UDS_IO(0x0A00, OUTPUT_PTA, 6),
+    UDS_IO(0x0A01, OUTPUT_PTA, 8),
+    UDS_IO(0x0A02, OUTPUT_PTA, 9),
+    UDS_IO(0x0A03, OUTPUT_PTA, 17),
+    UDS_IO(0x0A04, OUTPUT_PTB, 5),
+    UDS_IO(0x0A05, OUTPUT_PTC, 1),
+    UDS_IO(0x0A06, OUTPUT_PTC, 2),
+    UDS_IO(0x0A07, OUTPUT_PTC, 3),
+    UDS_IO(0x0A08, OUTPUT_PTD, 6),
+    UDS_IO(0x0A09, OUTPUT_PTD, 11),
+    UDS_IO(0x0A0A, OUTPUT_PTD, 12),
+    UDS_IO(0x0A0B, OUTPUT_PTD, 13),
+    UDS_IO(0x0A0C, OUTPUT_PTD, 14),
+    UDS_IO(0x0A0D, OUTPUT_PTD, 16),
+    UDS_IO(0x0A0E, OUTPUT_PTD, 17),
+    UDS_IO(0x0A0F, OUTPUT_PTE, 0),
+    UDS_IO(0x0A10, OUTPUT_PTE, 1),
+    UDS_IO(0x0A11, OUTPUT_PTE, 2),
+    UDS_IO(0x0A12, OUTPUT_PTE, 3),
+    UDS_IO(0x0A13, OUTPUT_PTE, 7),
+    UDS_IO(0x0A14, OUTPUT_PTE, 9),
+    UDS_IO(0x0A15, OUTPUT_PTE, 12),
+    UDS_IO(0x0A16, OUTPUT_PTE, 13),
+    UDS_IO(0x0A17, OUTPUT_PTE, 14),
+};
+
+static const uds_control_t uds_routine[] =
+{
+    { UDS_ROUTINE_REMOVE_BUBBLE, UDS_ROUTINE_REMOVE_BUBBLE, },
+    { UDS_ROUTINE_PURGE, UDS_ROUTINE_PURGE, },
+};
+
+/** ReadMemoryByAddress 只開放 SRAM (SRAM_L + SRAM_U)，大筆資料以此直接讀取 */
+static const uds_memory_t uds_memory[] =
+{
+    { 0x1FFF8000UL, 0x0000F000UL, },
+};
+
+static const uds_config_t uds_config =
+{
+    .did = &uds_did[0],
+    .did_count = sizeof(uds_did) / sizeof(uds_did[0]),
+    .io = &uds_io[0],
+    .io_count = sizeof(uds_io) / sizeof(uds_io[0]),
+    .routine = &uds_routine[0],
+    .routine_count = sizeof(uds_routine) / sizeof(uds_routine[0]),
+    .memory = &uds_memory[0],
+    .memory_count = sizeof(uds_memory) / sizeof(uds_memory[0]),
+    .io_control = uds_io_control,
+    .routine_control = uds_routine_control,
+    .session = uds_session_change,
+    .send = uds_send,
+    .busy = uds_busy,
+};
+
+/* 請求很短，不限制測試端 (BS = 0, STmin = 0)；回應的速率由測試端的 FC 決定 */
+static const isotp_config_t uds_tp_config =
+{
+    .block_size = 0,
+    .st_min = 0,
+    .tx = uds_tx,
+    .deliver = uds_deliver,
+};
+
+static isotp_t uds_tp;
+static uds_t uds;
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+void app_uds_init(void)
+{
+    isotp_init(&uds_tp, &can2_manager, &uds_tp_config);
+    uds_init(&uds, &uds_tp, &uds_config);
+}
+
+/**
+ * @brief 逾時處理與連續發送，每次主迴圈調用
+ *
+ * @note 不受 10 ms 時基限制，CF 依發送佇列的空間連續排入
+ */
+void app_uds_task(void)
+{
+    isotp_task(&uds_tp);
+    uds_task(&uds);
+}
+
+/**
+ * @brief can2 收到的訊框
+ *
+ * @param id 29 位元 ID
+ * @param data 資料
+ * @param dlc 長度
+ *
+ * @return true 診斷請求 (已處理)
+ * @return false 其他訊框，由呼叫者繼續處理
+ */
+bool app_uds_receive(uint32_t id, const uint8_t* data, uint8_t dlc)
+{
+    if ((id != UDS_REQUEST_ID) && (id != UDS_FUNCTIONAL_ID))
+    {
+        return false;
+    }
+
+    isotp_receive(&uds_tp, data, dlc, (id == UDS_FUNCTIONAL_ID));
+
+    return true;
+}
+
+/**
+ * @brief ISO-TP 訊框經由 can2 佇列發送
+ *
+ * @return false 佇列已滿，由 ISO-TP 下次重試
+ */
+static bool uds_tx(const void* handle, const uint8_t data[8])
+{
+    can_message_t message = { .id = UDS_RESPONSE_ID, .idt = 1, .dlc = 8 };
+
+    memcpy(&message.data.bytes[0], data, 8);
+
+    return cmngr_tx_message((cmngr_t*)handle, &message) == CMNGR_SUCCESS;
+}
+
+static void uds_deliver(const void* handle, const uint8_t* data, uint16_t size, bool functional)
+{
+    (void)handle;
+
+    uds_request(&uds, data, size, functional);
+}
+
+static bool uds_send(const void* handle, const uint8_t* head, uint16_t head_size, const uint8_t* body, uint16_t body_size)
+{
+    return isotp_send((isotp_t*)handle, head, head_size, body, body_size);
+}
+
+static bool uds_busy(const void* handle)
+{
+    return isotp_busy((const isotp_t*)handle);
+}
+
+/**
+ * @brief IO 控制: 0x00 交回程式控制，0x03 接管並輸出 state[0] (0: 低，其他: 高)
+ *
+ * @note 接管只影響影像，強制與閂鎖的保護動作仍優先；跳脫未清除前拒絕接管
+ */
+static uint8_t uds_io_control(const void* handle, uint32_t arg, uint8_t param, const uint8_t* state, uint16_t size)
+{
+    output_port_t port = (output_port_t)(arg >> 8);
+    uint8_t pin = (uint8_t)arg;
+
+    (void)handle;
+
+    switch (param)
+    {
+        case UDS_IO_RETURN_CONTROL:
+        {
+            if (size != 0)
+            {
+                return UDS_NRC_INCORRECT_LENGTH;
+            }
+
+            app_output_override(port, pin, false, false);
+            return UDS_NRC_NONE;
+        }
+        case UDS_IO_SHORT_TERM_ADJUST:
+        {
+            if (size != 1U)
+            {
+                return UDS_NRC_INCORRECT_LENGTH;
+            }
+
+            /* 運行中的 stack 依賴繼電器狀態，跳脫中的 relay 需由主機清除錯誤，皆不允許接管 */
+            if ((fc135kw.status == FC135KW_RUNNING) || (tyt60kw.status == TYT60KW_RUNNING) ||
+                fc135kw.trip || tyt60kw.trip || app_protect_event(NULL))
+            {
+                return UDS_NRC_CONDITIONS_NOT_CORRECT;
+            }
+
+            app_output_override(port, pin, true, (state[0] != 0));
+            return UDS_NRC_NONE;
+        }
+        default:
+        {
+            return UDS_NRC_OUT_OF_RANGE;
+        }
+    }
+}
+
+/**
+ * @brief routine 控制: 0x0201 fc135kw 排氣泡，0x0202 fc135kw 手動排水
+ */
+static uint8_t uds_routine_control(const void* handle, uint32_t arg, uint8_t type, const uint8_t* option, uint16_t size)
+{
+    (void)handle;
+    (void)option;
+
+    if ((type != UDS_ROUTINE_START) && (type != UDS_ROUTINE_STOP))
+    {
+        return UDS_NRC_SUBFUNCTION_NOT_SUPPORTED;
+    }
+
+    if (size != 0)
+    {
+        return UDS_NRC_INCORRECT_LENGTH;
+    }
+
+    switch (arg)
+    {
+        case UDS_ROUTINE_REMOVE_BUBBLE:
+        {
+            if (fc135kw.status == FC135KW_RUNNING)
+            {
+                return UDS_NRC_CONDITIONS_NOT_CORRECT;
+            }
+
+            fc135kw_remove_bubble(&fc135kw, (type == UDS_ROUTINE_START));
+            return UDS_NRC_NONE;
+        }
+        case UDS_ROUTINE_PURGE:
+        {
+            fc135kw_purge(&fc135kw, (type == UDS_ROUTINE_START), (type == UDS_ROUTINE_START));
+            return UDS_NRC_NONE;
+        }
+        default:
+        {
+            return UDS_NRC_OUT_OF_RANGE;
+        }
+    }
+}
+
+/**
+ * @brief 回到預設 session (要求或 S3 逾時) 時交回所有診斷控制
+ */
+static void uds_session_change(const void* handle, uds_session_t session)
+{
+    (void)handle;
+
+    if (session == UDS_SESSION_DEFAULT)
+    {
+        app_output_override_clear();
+        fc135kw_purge(&fc135kw, false, false);
+        fc135kw_remove_bubble(&fc135kw, false);
+    }
+}
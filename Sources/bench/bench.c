@@ -0,0 +1,178 @@
+#include "bench.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <assert.h>
+
+/**
+ * @brief 輸出一行
+ *
+ * @param bench bench 物件
+ * @param fmt 格式
+ * @param ... 可選參數
+ */
+static void print(bench_t* bench, const char* fmt, ...)
+{
+    char buffer[BENCH_LINE_SIZE];
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+
+    if (len > 0)
+    {
+        bench->config->write(buffer, (uint16_t)((len < (int)sizeof(buffer)) ? len : (int)(sizeof(buffer) - 1U)));
+    }
+}
+
+/**
+ * @brief 量測單一項目，重複次數逐步增加直到量測時間超過 min_ticks
+ *
+ * @param bench bench 物件
+ * @param c 項目
+ * @param ticks 量測時間輸出 (計數值)
+ *
+ * @return uint32_t 重複次數
+ *
+ * @note 下一輪次數依本輪時間預估 (1.4 倍餘裕)，每輪成長 2 ~ 10 倍
+ */
+static uint32_t measure(bench_t* bench, const bench_case_t* c, uint32_t* ticks)
+{
+    uint32_t iterations = 1;
+    uint32_t elapsed;
+    uint32_t start;
+    uint64_t next;
+
+    if (c->setup)
+    {
+        c->setup(c->arg);
+    }
+
+    for (;;)
+    {
+        start = bench->config->clock();
+        c->run(c->arg, iterations);
+        elapsed = bench->config->clock() - start;
+
+        if ((elapsed >= bench->config->min_ticks) || (iterations >= BENCH_ITERATIONS_MAX))
+        {
+            break;
+        }
+
+        next = elapsed ? ((((uint64_t)bench->config->min_ticks * 14U) / 10U) * iterations) / elapsed : 0;
+
+        if (next < ((uint64_t)iterations * 2U))
+        {
+            next = (uint64_t)iterations * 2U;
+        }
+        else if (next > ((uint64_t)iterations * 10U))
+        {
+            next = (uint64_t)iterations * 10U;
+        }
+
+        iterations = (next > BENCH_ITERATIONS_MAX) ? BENCH_ITERATIONS_MAX : (uint32_t)next;
+    }
+
+    *ticks = elapsed;
+
+    return iterations;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief bench 初始化
+ *
+ * @param bench bench 物件
+ * @param config 配置結構體
+ * @param cases 項目表
+ * @param count 項目數量
+ */
+void bench_init(bench_t* bench, bench_config_t* config, const bench_case_t* cases, uint16_t count)
+{
+    assert(bench);
+    assert(config);
+    assert(config->clock);
+    assert(config->clock_hz);
+    assert(config->write);
+    assert(cases);
+
+    bench->config = config;
+    bench->cases = cases;
+    bench->count = count;
+    bench->next = 0;
+}
+
+/**
+ * @brief 量測下一個項目並輸出結果
+ *
+ * @param bench bench 物件
+ *
+ * @return true 還有項目
+ * @return false 已全部完成
+ *
+ * @note 輸出格式與 Google Benchmark 的 --benchmark_format=json 相容 (real_time / cpu_time 為每次 ns，
+ *       單執行緒量測兩者相同，compare.py 兩者皆讀取)，另外輸出 ticks_per_op (計數器為 DWT 時即 cycles)；
+ *       每次只輸出一行，可在主迴圈分次調用避免塞滿 uart 緩衝
+ */
+bool bench_step(bench_t* bench)
+{
+    const bench_case_t* c;
+    uint32_t iterations;
+    uint32_t ticks;
+    uint64_t ns;
+    uint64_t ns_x100;
+    uint64_t ticks_x100;
+
+    assert(bench);
+
+    if (bench->next > bench->count)
+    {
+        return false;
+    }
+
+    if (bench->next == 0)
+    {
+        print(bench, "{\n  \"context\": {\"name\": \"%s\", \"clock_hz\": %lu},\n  \"benchmarks\": [\n",
+            bench->config->name, (unsigned long)bench->config->clock_hz);
+    }
+
+    if (bench->next == bench->count)
+    {
+        print(bench, "\n  ]\n}\n");
+        bench->next++;
+
+        return false;
+    }
+
+    c = &bench->cases[bench->next];
+    iterations = measure(bench, c, &ticks);
+
+    ns = ((uint64_t)ticks * 1000000000ULL) / bench->config->clock_hz;
+    ns_x100 = (ns * 100U) / iterations;
+    ticks_x100 = ((uint64_t)ticks * 100U) / iterations;
+
+    print(bench, "%s    {\"name\": \"%s\", \"iterations\": %lu, \"real_time\": %lu.%02lu, "
+        "\"cpu_time\": %lu.%02lu, \"ticks_per_op\": %lu.%02lu, \"time_unit\": \"ns\"}",
+        (bench->next > 0) ? ",\n" : "", c->name, (unsigned long)iterations,
+        (unsigned long)(ns_x100 / 100U), (unsigned long)(ns_x100 % 100U),
+        (unsigned long)(ns_x100 / 100U), (unsigned long)(ns_x100 % 100U),
+        (unsigned long)(ticks_x100 / 100U), (unsigned long)(ticks_x100 % 100U));
+
+    bench->next++;
+
+    return true;
+}
+
+/**
+ * @brief 量測所有項目
+ *
+ * @param bench bench 物件
+ */
+void bench_run(bench_t* bench)
+{
+    while (bench_step(bench))
+    {
+    }
+}
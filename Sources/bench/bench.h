@@ -0,0 +1,39 @@
+#ifndef _bench_h_
+#define _bench_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BENCH_ITERATIONS_MAX                    (1UL << 24) /** 單一項目的最大重複次數 */
+#define BENCH_LINE_SIZE                         (192U)
+
+typedef struct bench_case
+{
+    const char* name;
+    void (*setup)(uint32_t arg);                /** 量測前調用，可為 NULL */
+    void (*run)(uint32_t arg, uint32_t iterations);
+    uint32_t arg;
+} bench_case_t;
+
+typedef struct bench_config
+{
+    const char* name;                           /** 輸出的 context 名稱 */
+    uint32_t(*clock)(void);                     /** 32 bits 遞增計數器 */
+    uint32_t clock_hz;                          /** 計數器頻率 */
+    uint32_t min_ticks;                         /** 單一項目最少量測時間 (計數值) */
+    void (*write)(const char* str, uint16_t size);
+} bench_config_t;
+
+typedef struct bench
+{
+    bench_config_t* config;
+    const bench_case_t* cases;
+    uint16_t count;
+    uint16_t next;                              /** 下一個項目，count + 1: 已結束 */
+} bench_t;
+
+void bench_init(bench_t* bench, bench_config_t* config, const bench_case_t* cases, uint16_t count);
+bool bench_step(bench_t* bench);
+void bench_run(bench_t* bench);
+
+#endif
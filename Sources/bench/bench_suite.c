@@ -0,0 +1,358 @@
+#include "bench_suite.h"
+#include "fc135kw.h"
+#include "toyota60kw.h"
+#include "bidc300100_bank.h"
+#include "fc135kw_codec.h"
+#include "tyt60kw_codec.h"
+#include <string.h>
+
+/**
+ * 驅動的命令編碼、資料解碼與狀態機單次 task 的量測項目，PC (tools/bench) 與目標板 (app_bench.c) 共用；
+ * 使用獨立的物件，不影響運行中的 stack，log 與 io 回呼設為 NULL 只量測驅動本身
+ */
+
+static fc135kw_t fc;
+static tyt60kw_t tyt;
+static bidc300100_t dcdc;
+static bidc300100_bank_t bank;
+static fc135kw_config_t fc_config = { .name = "bench", .log = NULL, .io = NULL, .light_tower = NULL, };
+static tyt60kw_config_t tyt_config = { .name = "bench", .log = NULL, .io = NULL, .light_tower = NULL, };
+static uint8_t input[8];
+static uint8_t output[8];
+static uint8_t step;                            /** task 項目每次還原的 step */
+static volatile uint32_t sink;
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void tx(uint32_t id, uint8_t* data, uint8_t size)
+{
+    sink += id + data[0] + size;
+}
+
+/**
+ * @brief 產生 fc135kw 控制器的正常數據
+ *
+ * @param type 資料類型
+ * @param data 輸出
+ */
+static void fc_frame(fc135kw_update_t type, uint8_t data[8])
+{
+    const fc135kw_sys_status_t status = { .system_status = 3, };
+    const fc135kw_sys_h2_t h2 = { .h2_pressure = 5000, .h2_src_pressure = 8000, };
+    const fc135kw_sys_water_t water = { .water_temp = 100, .water_temp_target = 105, };
+    const fc135kw_sys_error_t error = { .error_level = 0, .error_code = 0, };
+
+    switch (type)
+    {
+        case FC135KW_SYS_STATUS: { fc135kw_sys_status_pack(&status, data); break; }
+        case FC135KW_SYS_H2: { fc135kw_sys_h2_pack(&h2, data); break; }
+        case FC135KW_SYS_WATER: { fc135kw_sys_water_pack(&water, data); break; }
+        case FC135KW_SYS_ERROR: { fc135kw_sys_error_pack(&error, data); break; }
+        default: { break; }
+    }
+}
+
+/**
+ * @brief 產生 tyt60kw 控制器的正常數據
+ *
+ * @param type 資料類型
+ * @param data 輸出
+ */
+static void tyt_frame(tyt60kw_update_t type, uint8_t data[8])
+{
+    const tyt60kw_fc_050_t fc_050 = { .fc_status = TYT60KW_STOPPED, .relay_status = 0, };
+    const tyt60kw_fc_051_t fc_051 = { .error_level = 0, .pcu_voltage = 650, };
+    const tyt60kw_fc_222_t fc_222 = { .water_temp_fco = 60, };
+    const tyt60kw_fc_225_t fc_225 = { .pcu_temp = 40, };
+    const tyt60kw_fc_508_t fc_508 = { .error_code = 0, };
+
+    memset(data, 0, 8);
+
+    switch (type)
+    {
+        case TYT60KW_UPDATE_050: { tyt60kw_fc_050_pack(&fc_050, data); break; }
+        case TYT60KW_UPDATE_051: { tyt60kw_fc_051_pack(&fc_051, data); break; }
+        case TYT60KW_UPDATE_222: { tyt60kw_fc_222_pack(&fc_222, data); break; }
+        case TYT60KW_UPDATE_225: { tyt60kw_fc_225_pack(&fc_225, data); break; }
+        case TYT60KW_UPDATE_508: { tyt60kw_fc_508_pack(&fc_508, data); break; }
+        default: { break; }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief fc135kw 初始化並送入一輪正常數據，arg 為 update 項目的資料類型
+ */
+static void fc_setup(uint32_t arg)
+{
+    static const fc135kw_update_t type[] = { FC135KW_SYS_STATUS, FC135KW_SYS_H2, FC135KW_SYS_WATER, FC135KW_SYS_ERROR, };
+    uint8_t i;
+
+    fc135kw_init(&fc, &fc_config);
+    fc135kw_host_connect(&fc);
+    fc135kw_power(&fc, 60);
+
+    for (i = 0; i < (sizeof(type) / sizeof(type[0])); i++)
+    {
+        fc_frame(type[i], input);
+        fc135kw_update(&fc, type[i], input);
+    }
+
+    fc_frame((fc135kw_update_t)arg, input);
+}
+
+static void fc_command(uint32_t arg, uint32_t iterations)
+{
+    while (iterations--)
+    {
+        fc135kw_command(&fc, (fc135kw_command_t)arg, output);
+    }
+
+    sink += output[0];
+}
+
+static void fc_update(uint32_t arg, uint32_t iterations)
+{
+    while (iterations--)
+    {
+        fc135kw_update(&fc, (fc135kw_update_t)arg, input);
+    }
+}
+
+/**
+ * @brief fc135kw 停在指定狀態，旗標與控制器狀態設為不會離開該狀態的條件
+ */
+static void fc_task_setup(uint32_t arg)
+{
+    fc_setup(FC135KW_SYS_STATUS);
+
+    fc.status = (fc135kw_status_t)arg;
+    fc.flag.bits.start = ((arg == FC135KW_PRECHARGE) || (arg == FC135KW_RUNNING));
+    fc.flag.bits.power_on = (arg != FC135KW_DEINIT);
+    fc.flag.bits.ign_key = (arg != FC135KW_DEINIT);
+    fc.system_status = ((arg == FC135KW_RUNNING) || (arg == FC135KW_SHUTDOWN)) ? 6 : 3;
+    fc.step = 0;
+    step = fc.step;
+}
+
+static void fc_task(uint32_t arg, uint32_t iterations)
+{
+    while (iterations--)
+    {
+        fc.status = (fc135kw_status_t)arg;
+        fc.status_old = fc.status;
+        fc.step = step;
+        fc.time_count = 1000;
+        fc135kw_task(&fc);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief tyt60kw 初始化並送入一輪正常數據，arg 為 update 項目的資料類型
+ */
+static void tyt_setup(uint32_t arg)
+{
+    static const tyt60kw_update_t type[] =
+    {
+        TYT60KW_UPDATE_050, TYT60KW_UPDATE_051, TYT60KW_UPDATE_222, TYT60KW_UPDATE_225, TYT60KW_UPDATE_508,
+    };
+    uint8_t i;
+
+    tyt60kw_init(&tyt, &tyt_config);
+    tyt60kw_host_connect(&tyt);
+    tyt60kw_power(&tyt, 30);
+
+    for (i = 0; i < (sizeof(type) / sizeof(type[0])); i++)
+    {
+        tyt_frame(type[i], input);
+        tyt60kw_update(&tyt, type[i], input);
+    }
+
+    tyt_frame((tyt60kw_update_t)arg, input);
+}
+
+static void tyt_command(uint32_t arg, uint32_t iterations)
+{
+    while (iterations--)
+    {
+        tyt60kw_command(&tyt, (tyt60kw_command_t)arg, output);
+    }
+
+    sink += output[0];
+}
+
+static void tyt_update(uint32_t arg, uint32_t iterations)
+{
+    while (iterations--)
+    {
+        tyt60kw_update(&tyt, (tyt60kw_update_t)arg, input);
+    }
+}
+
+/**
+ * @brief tyt60kw 停在指定狀態，旗標與控制器狀態設為不會離開該狀態的條件
+ *
+ * @note PRECHARGE 停在等待 PCU 電壓，SHUTDOWN 停在等待控制器停止
+ */
+static void tyt_task_setup(uint32_t arg)
+{
+    tyt_setup(TYT60KW_UPDATE_050);
+
+    tyt.status = (tyt60kw_status_t)arg;
+    tyt.flag.bits.start = ((arg == TYT60KW_PRECHARGE) || (arg == TYT60KW_RUNNING));
+    tyt.flag.bits.power_on = (arg != TYT60KW_DEINIT);
+    tyt.flag.bits.ign_key = (arg != TYT60KW_DEINIT);
+    tyt.pcu_voltage = (arg == TYT60KW_PRECHARGE) ? 0 : 650;
+    tyt.fc_status = (arg == TYT60KW_SHUTDOWN) ? TYT60KW_POWER_SUPPLY : TYT60KW_STOPPED;
+    tyt.step = (arg == TYT60KW_SHUTDOWN) ? 2 : 0;
+    step = tyt.step;
+}
+
+static void tyt_task(uint32_t arg, uint32_t iterations)
+{
+    while (iterations--)
+    {
+        tyt.status = (tyt60kw_status_t)arg;
+        tyt.status_old = tyt.status;
+        tyt.step = step;
+        tyt.time_count = 1000;
+        tyt60kw_task(&tyt);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief bidc300100 初始化，input 為模組 ONOFF 響應 (arg = 0) 或其他設備的幀 (arg = 1)
+ */
+static void dcdc_setup(uint32_t arg)
+{
+    bidc300100_init(&dcdc, 0, tx);
+
+    memset(input, 0, sizeof(input));
+    input[1] = 0x55;
+    input[3] = BIDC300100_ONOFF;
+    (void)arg;
+}
+
+static void dcdc_request(uint32_t arg, uint32_t iterations)
+{
+    while (iterations--)
+    {
+        bidc300100_request(&dcdc, arg ? BIDC300100_BATTERY : BIDC300100_ONOFF, (uint8_t)arg);
+    }
+}
+
+static void dcdc_parser(uint32_t arg, uint32_t iterations)
+{
+    uint32_t id = arg ? 0x18FC0010UL : BIDC300100_ID(BIDC300100_FRAME_RESPONSE, BIDC300100_HOST_ADDR, dcdc.addr);
+
+    while (iterations--)
+    {
+        sink += bidc300100_parser(&dcdc, id, input, 8);
+    }
+}
+
+/**
+ * @brief bidc300100 bank 填滿 BIDC300100_BANK_MAX 個模組
+ */
+static void bank_setup(uint32_t arg)
+{
+    uint8_t i;
+
+    dcdc_setup(arg);
+    bidc300100_bank_init(&bank, tx);
+
+    for (i = 0; i < BIDC300100_BANK_MAX; i++)
+    {
+        bidc300100_bank_parser(&bank, BIDC300100_ID(BIDC300100_FRAME_RESPONSE, BIDC300100_HOST_ADDR, 0x20U | i), input, 8);
+    }
+
+    bidc300100_bank_current(&bank, 4000);
+}
+
+static void bank_parser(uint32_t arg, uint32_t iterations)
+{
+    uint32_t id = BIDC300100_ID(BIDC300100_FRAME_RESPONSE, BIDC300100_HOST_ADDR, 0x20U | (BIDC300100_BANK_MAX - 1U));
+
+    while (iterations--)
+    {
+        sink += bidc300100_bank_parser(&bank, id, input, 8);
+    }
+
+    (void)arg;
+}
+
+static void bank_task(uint32_t arg, uint32_t iterations)
+{
+    uint8_t i;
+
+    while (iterations--)
+    {
+        for (i = 0; i < bank.count; i++)
+        {
+            bank.lost[i] = 0;
+        }
+
+        bidc300100_bank_task(&bank);
+    }
+
+    (void)arg;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static const bench_case_t suite[] =
+{
+    { "fc135kw_command/SET_STATUS", fc_setup, fc_command, FC135KW_SET_STATUS, },
+    { "fc135kw_command/DRAIN_VALVE", fc_setup, fc_command, FC135KW_DRAIN_VALVE, },
+    { "fc135kw_command/REMOVE_BUBBLE", fc_setup, fc_command, FC135KW_REMOVE_BUBBLE, },
+    { "fc135kw_update/SYS_STATUS", fc_setup, fc_update, FC135KW_SYS_STATUS, },
+    { "fc135kw_update/SYS_H2", fc_setup, fc_update, FC135KW_SYS_H2, },
+    { "fc135kw_update/SYS_WATER", fc_setup, fc_update, FC135KW_SYS_WATER, },
+    { "fc135kw_update/SYS_ERROR", fc_setup, fc_update, FC135KW_SYS_ERROR, },
+    { "tyt60kw_command/04E", tyt_setup, tyt_command, TYT60KW_CMD_04E, },
+    { "tyt60kw_command/215", tyt_setup, tyt_command, TYT60KW_CMD_215, },
+    { "tyt60kw_update/050", tyt_setup, tyt_update, TYT60KW_UPDATE_050, },
+    { "tyt60kw_update/051", tyt_setup, tyt_update, TYT60KW_UPDATE_051, },
+    { "tyt60kw_update/222", tyt_setup, tyt_update, TYT60KW_UPDATE_222, },
+    { "tyt60kw_update/225", tyt_setup, tyt_update, TYT60KW_UPDATE_225, },
+    { "tyt60kw_update/508", tyt_setup, tyt_update, TYT60KW_UPDATE_508, },
+    { "bidc300100_request/single", dcdc_setup, dcdc_request, 0, },
+    { "bidc300100_request/multi", dcdc_setup, dcdc_request, 5, },
+    { "bidc300100_parser/match", dcdc_setup, dcdc_parser, 0, },
+    { "bidc300100_parser/other", dcdc_setup, dcdc_parser, 1, },
+    { "bidc300100_bank_parser/8", bank_setup, bank_parser, 0, },
+    { "bidc300100_bank_task/8", bank_setup, bank_task, 0, },
+    { "fc135kw_task/INIT", fc_task_setup, fc_task, FC135KW_INIT, },
+    { "fc135kw_task/IDLE", fc_task_setup, fc_task, FC135KW_IDLE, },
+    { "fc135kw_task/PRECHARGE", fc_task_setup, fc_task, FC135KW_PRECHARGE, },
+    { "fc135kw_task/RUNNING", fc_task_setup, fc_task, FC135KW_RUNNING, },
+    { "fc135kw_task/SHUTDOWN", fc_task_setup, fc_task, FC135KW_SHUTDOWN, },
+    { "fc135kw_task/ERROR", fc_task_setup, fc_task, FC135KW_ERROR, },
+    { "fc135kw_task/DEINIT", fc_task_setup, fc_task, FC135KW_DEINIT, },
+    { "tyt60kw_task/INIT", tyt_task_setup, tyt_task, TYT60KW_INIT, },
+    { "tyt60kw_task/IDLE", tyt_task_setup, tyt_task, TYT60KW_IDLE, },
+    { "tyt60kw_task/PRECHARGE", tyt_task_setup, tyt_task, TYT60KW_PRECHARGE, },
+    { "tyt60kw_task/RUNNING", tyt_task_setup, tyt_task, TYT60KW_RUNNING, },
+    { "tyt60kw_task/SHUTDOWN", tyt_task_setup, tyt_task, TYT60KW_SHUTDOWN, },
+    { "tyt60kw_task/ERROR", tyt_task_setup, tyt_task, TYT60KW_ERROR, },
+    { "tyt60kw_task/DEINIT", tyt_task_setup, tyt_task, TYT60KW_DEINIT, },
+};
+
+/**
+ * @brief 取得量測項目表
+ *
+ * @param cases 項目表輸出
+ *
+ * @return uint16_t 項目數量
+ */
+uint16_t bench_suite(const bench_case_t** cases)
+{
+    *cases = &suite[0];
+
+    return (uint16_t)(sizeof(suite) / sizeof(suite[0]));
+}
@@ -0,0 +1,8 @@
+#ifndef _bench_suite_h_
+#define _bench_suite_h_
+
+#include "bench.h"
+
+uint16_t bench_suite(const bench_case_t** cases);
+
+#endif
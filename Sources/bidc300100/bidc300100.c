@@ -15,7 +15,7 @@
  */
 static uint32_t id_fill(bidc300100_frame_t pf, uint8_t ps, uint8_t sa)
 {
-    return (uint32_t)((((uint32_t)pf) << 16) | (((uint32_t)ps) << 8) | sa);
+    return BIDC300100_ID(pf, ps, sa);
 }
 
 /**
@@ -77,20 +77,42 @@ bool bidc300100_set_ctrl(bidc300100_t* dcdc, bidc300100_ctrl_t ctrl)
         [BIDC300100_RESET] = { 29, 0xAAU },
     };
 
+    assert(dcdc);
+
+    if (ctrl < BIDC300100_CTRL_MAX)
+    {
+        return bidc300100_set_value(dcdc, command[ctrl][0], command[ctrl][1]);
+    }
+
+    return false;
+}
+
+/**
+ * @brief BIDC300100 DCDC 設定數據
+ *
+ * @param dcdc DCDC 物件
+ * @param order 數據編號 (查看產品 Datasheet)
+ * @param value 設定值
+ *
+ * @return true 設定成功
+ * @return false 設定失敗
+ */
+bool bidc300100_set_value(bidc300100_t* dcdc, uint8_t order, uint16_t value)
+{
     uint32_t id;
     bidc300100_data_t buffer = { 0 };
 
     assert(dcdc);
 
-    if (dcdc->tx && (ctrl < BIDC300100_CTRL_MAX))
+    if (dcdc->tx)
     {
         id = id_fill(BIDC300100_FRAME_SETUP, dcdc->addr, BIDC300100_HOST_ADDR);
 
         buffer.data.bytes[2] = 0;
-        buffer.data.bytes[3] = command[ctrl][0];    /* order */     // motorola
+        buffer.data.bytes[3] = order;               /* order */     // motorola
 
-        buffer.data.bytes[0] = 0;
-        buffer.data.bytes[1] = command[ctrl][1];    /* set value */ // motorola
+        buffer.data.bytes[0] = (uint8_t)(value >> 8);
+        buffer.data.bytes[1] = (uint8_t)value;      /* set value */ // motorola
 
         buffer.data.lbyte[1] = 0;
         dcdc->tx(id, &buffer.data.bytes[0], 8);
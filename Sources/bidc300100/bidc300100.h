@@ -5,6 +5,7 @@
 #include "stdbool.h"
 
 #define BIDC300100_HOST_ADDR                    (0x0FU)
+#define BIDC300100_ID(pf, ps, sa)               ((uint32_t)((((uint32_t)(pf)) << 16) | (((uint32_t)(ps)) << 8) | (sa)))
 
 typedef void (*bidc300100_tx_t)(uint32_t id, uint8_t* data, uint8_t size);
 
@@ -24,15 +25,20 @@ typedef enum bidc300100_ctrl
 
 typedef enum
 {
+    BIDC300100_FRAME_ACK = 0x22U,       /** 0x22 設置後的響應幀 */
     BIDC300100_FRAME_RESPONSE = 0x72U,  /** 0x72 查詢後的響應幀 */
     BIDC300100_FRAME_SETUP = 0x73U,     /** 0x73 設置幀 */
     BIDC300100_FRAME_QUERY = 0x74U,     /** 0x74 查詢幀 */
+    BIDC300100_FRAME_RESPONSE_EXT = 0xF2U,  /** 0xF2 查詢或設置響應 */
 } bidc300100_frame_t;
 
 typedef enum bidc300100_request
 {
     BIDC300100_SYSTEM = 0x02U,
+    BIDC300100_BATTERY = 0x04U,         /** Data0: 電池電壓, Data1: 電池電流 (0.1x) */
+    BIDC300100_TEMPERATURE = 0x08U,     /** Data1: LLC 原邊散熱器溫度, Data2: LLC 副邊散熱器溫度 (0.1x) */
     BIDC300100_ONOFF = 0x20U,
+    BIDC300100_CURRENT_SETUP = 0x37U,   /** 充放電流設置 (0.1 A, 0 ~ 2000) */
 } bidc300100_request_t;
 
 typedef struct bidc300100_can
@@ -56,6 +62,7 @@ typedef struct bidc300100
 bool bidc300100_init(bidc300100_t* dcdc, uint8_t addr, bidc300100_tx_t tx);
 bidc300100_status_t bidc300100_status(bidc300100_t* dcdc);
 bool bidc300100_set_ctrl(bidc300100_t* dcdc, bidc300100_ctrl_t ctrl);
+bool bidc300100_set_value(bidc300100_t* dcdc, uint8_t order, uint16_t value);
 bool bidc300100_request(bidc300100_t* dcdc, bidc300100_request_t request, uint8_t mult);
 bool bidc300100_parser(bidc300100_t* dcdc, uint32_t id, uint8_t* data, uint8_t size);
 
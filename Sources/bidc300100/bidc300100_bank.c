@@ -0,0 +1,423 @@
+#include "bidc300100_bank.h"
+#include "ramfunc.h"
+#include <assert.h>
+
+#define BANK_ADDR_MASK                          (0x1FU)
+#define BANK_ADDR_BASE                          (0x20U)
+
+/**
+ * @brief 以模組地址建立單一模組物件，幀格式沿用 bidc300100
+ *
+ * @param bank DCDC 組物件
+ * @param addr 模組地址 (已加上 0x20)
+ *
+ * @return bidc300100_t
+ */
+static bidc300100_t module(bidc300100_bank_t* bank, uint8_t addr)
+{
+    bidc300100_t dcdc;
+
+    dcdc.addr = addr;
+    dcdc.tx = bank->tx;
+    dcdc.status.power_output = false;
+    dcdc.status.reset = false;
+
+    return dcdc;
+}
+
+/**
+ * @brief 尋找地址所在的槽位
+ *
+ * @param bank DCDC 組物件
+ * @param addr 模組地址 (已加上 0x20)
+ *
+ * @return 槽位，BIDC300100_BANK_MAX: 不在線
+ */
+static uint8_t slot_find(bidc300100_bank_t* bank, uint8_t addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < bank->count; i++)
+    {
+        if (bank->addr[i] == addr)
+        {
+            return i;
+        }
+    }
+
+    return BIDC300100_BANK_MAX;
+}
+
+/**
+ * @brief 新增在線模組，並補送目前的控制命令
+ *
+ * @param bank DCDC 組物件
+ * @param addr 模組地址 (已加上 0x20)
+ *
+ * @return 槽位，BIDC300100_BANK_MAX: 已滿
+ *
+ * @note share 歸零，下一次 balance() 會送出電流設定
+ */
+static uint8_t slot_add(bidc300100_bank_t* bank, uint8_t addr)
+{
+    bidc300100_t dcdc;
+    uint8_t i = bank->count;
+
+    if (i >= BIDC300100_BANK_MAX)
+    {
+        return BIDC300100_BANK_MAX;
+    }
+
+    bank->addr[i] = addr;
+    bank->lost[i] = 0;
+    bank->power_output[i] = false;
+    bank->current[i] = 0;
+    bank->temp[i] = 0;
+    bank->share[i] = 0;
+    bank->present |= (1UL << (addr & BANK_ADDR_MASK));
+    bank->count++;
+
+    if (bank->ctrl < BIDC300100_CTRL_MAX)
+    {
+        dcdc = module(bank, addr);
+        bidc300100_set_ctrl(&dcdc, bank->ctrl);
+    }
+
+    return i;
+}
+
+/**
+ * @brief 移除離線模組，以最後一個槽位補位保持陣列連續
+ *
+ * @param bank DCDC 組物件
+ * @param i 槽位
+ *
+ * @note 清除 present 後會重新探測該地址
+ */
+static void slot_remove(bidc300100_bank_t* bank, uint8_t i)
+{
+    uint8_t last = (uint8_t)(bank->count - 1U);
+
+    bank->present &= ~(1UL << (bank->addr[i] & BANK_ADDR_MASK));
+
+    bank->addr[i] = bank->addr[last];
+    bank->lost[i] = bank->lost[last];
+    bank->power_output[i] = bank->power_output[last];
+    bank->current[i] = bank->current[last];
+    bank->temp[i] = bank->temp[last];
+    bank->share[i] = bank->share[last];
+    bank->count = last;
+}
+
+/**
+ * @brief 依溫度餘裕分配整組電流，再以實測電流修正，變化超過死區的模組一次送出
+ *
+ * @param bank DCDC 組物件
+ *
+ * @note 分配: share = 總電流 x 溫度餘裕 / 總溫度餘裕，溫度相同時平均分配；
+ *       修正: 輸出中的模組實際電流低於分配值時提高設定(反之降低)，補償模組間的差異
+ */
+static void balance(bidc300100_bank_t* bank)
+{
+    uint32_t weight[BIDC300100_BANK_MAX];
+    uint32_t sum = 0;
+    int32_t target;
+    int32_t actual;
+    int32_t setup;
+    bidc300100_t dcdc;
+    uint8_t i;
+
+    if ((bank->current_setup == 0) || (bank->count == 0))
+    {
+        return;
+    }
+
+    for (i = 0; i < bank->count; i++)
+    {
+        target = BIDC300100_BANK_TEMP_LIMIT - bank->temp[i];
+        weight[i] = (uint32_t)((target < BIDC300100_BANK_TEMP_MARGIN) ? BIDC300100_BANK_TEMP_MARGIN : target);
+        sum += weight[i];
+    }
+
+    for (i = 0; i < bank->count; i++)
+    {
+        target = (int32_t)(((uint32_t)bank->current_setup * weight[i]) / sum);
+        setup = target;
+
+        if (bank->power_output[i])
+        {
+            actual = (bank->current[i] < 0) ? -bank->current[i] : bank->current[i];
+            setup += (target - actual) / BIDC300100_BANK_TRIM_DIV;
+        }
+
+        if (setup < 0)
+        {
+            setup = 0;
+        }
+        else if (setup > (int32_t)BIDC300100_BANK_CURRENT_MAX)
+        {
+            setup = BIDC300100_BANK_CURRENT_MAX;
+        }
+
+        if (((setup - bank->share[i]) >= BIDC300100_BANK_DEADBAND) ||
+            ((bank->share[i] - setup) >= BIDC300100_BANK_DEADBAND))
+        {
+            bank->share[i] = (uint16_t)setup;
+            dcdc = module(bank, bank->addr[i]);
+            bidc300100_set_value(&dcdc, BIDC300100_CURRENT_SETUP, bank->share[i]);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief BIDC300100 DCDC 組初始化，模組由 bidc300100_bank_task() 自動探測
+ *
+ * @param bank DCDC 組物件
+ * @param tx 數據發送接口
+ */
+void bidc300100_bank_init(bidc300100_bank_t* bank, bidc300100_tx_t tx)
+{
+    assert(bank);
+
+    bank->tx = tx;
+    bank->present = 0;
+    bank->scan = 0;
+    bank->poll = 0;
+    bank->count = 0;
+    bank->ctrl = BIDC300100_CTRL_MAX;
+    bank->current_setup = 0;
+}
+
+/**
+ * @brief BIDC300100 DCDC 組週期處理，輪流 (查詢量測值、重新分配電流) 與 (查詢開關機、探測未知地址)
+ *
+ * @param bank DCDC 組物件
+ *
+ * @note 每次最多發送 2 x BIDC300100_BANK_MAX 幀，需小於 CAN 發送佇列深度；
+ *       32 個地址在 2 x 32 / BIDC300100_BANK_SCAN 次 task 內探測完畢
+ */
+void bidc300100_bank_task(bidc300100_bank_t* bank)
+{
+    bidc300100_t dcdc;
+    uint8_t addr;
+    uint8_t i = 0;
+
+    assert(bank);
+
+    while (i < bank->count)
+    {
+        if (++bank->lost[i] > BIDC300100_BANK_LOST)
+        {
+            slot_remove(bank, i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    for (i = 0; i < bank->count; i++)
+    {
+        dcdc = module(bank, bank->addr[i]);
+
+        if (bank->poll)
+        {
+            bidc300100_request(&dcdc, BIDC300100_ONOFF, 0);
+        }
+        else
+        {
+            bidc300100_request(&dcdc, BIDC300100_BATTERY, (BIDC300100_TEMPERATURE - BIDC300100_BATTERY) + 1U);
+        }
+    }
+
+    if (!bank->poll)
+    {
+        balance(bank);
+    }
+    else
+    {
+        for (i = 0; i < BIDC300100_BANK_SCAN; i++)
+        {
+            addr = bank->scan;
+            bank->scan = (uint8_t)((bank->scan + 1U) & BANK_ADDR_MASK);
+
+            if (!(bank->present & (1UL << addr)))
+            {
+                dcdc = module(bank, (uint8_t)(addr | BANK_ADDR_BASE));
+                bidc300100_request(&dcdc, BIDC300100_ONOFF, 0);
+            }
+        }
+    }
+
+    bank->poll ^= 1U;
+}
+
+/**
+ * @brief BIDC300100 DCDC 組設定控制，對所有在線模組連續發送
+ *
+ * @param bank DCDC 組物件
+ * @param ctrl 要控制的類型
+ *
+ * @return true 設定成功
+ * @return false 設定失敗
+ */
+bool bidc300100_bank_set_ctrl(bidc300100_bank_t* bank, bidc300100_ctrl_t ctrl)
+{
+    bidc300100_t dcdc;
+    uint8_t i;
+
+    assert(bank);
+
+    if (!bank->tx || (ctrl >= BIDC300100_CTRL_MAX))
+    {
+        return false;
+    }
+
+    /* RESET 為單次命令，不補送給新發現的模組 */
+    if (ctrl != BIDC300100_RESET)
+    {
+        bank->ctrl = ctrl;
+    }
+
+    for (i = 0; i < bank->count; i++)
+    {
+        dcdc = module(bank, bank->addr[i]);
+        bidc300100_set_ctrl(&dcdc, ctrl);
+    }
+
+    return true;
+}
+
+/**
+ * @brief BIDC300100 DCDC 組電流設定，立即分配並送出
+ *
+ * @param bank DCDC 組物件
+ * @param current 整組電流(0.1 A)，0: 不介入模組設定
+ */
+void bidc300100_bank_current(bidc300100_bank_t* bank, uint16_t current)
+{
+    assert(bank);
+
+    bank->current_setup = current;
+    balance(bank);
+}
+
+/**
+ * @brief 在線模組數
+ *
+ * @param bank DCDC 組物件
+ *
+ * @return uint8_t
+ */
+uint8_t bidc300100_bank_online(bidc300100_bank_t* bank)
+{
+    assert(bank);
+
+    return bank->count;
+}
+
+/**
+ * @brief 輸出中的模組數
+ *
+ * @param bank DCDC 組物件
+ *
+ * @return uint8_t
+ */
+uint8_t bidc300100_bank_output(bidc300100_bank_t* bank)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    assert(bank);
+
+    for (i = 0; i < bank->count; i++)
+    {
+        count += bank->power_output[i];
+    }
+
+    return count;
+}
+
+/**
+ * @brief BIDC300100 DCDC 組數據解析器，未知地址的響應視為新模組
+ *
+ * @param bank DCDC 組物件
+ * @param id 收到的 ID
+ * @param data 收到的數據
+ * @param size 收到數據的長度
+ *
+ * @return true 解析成功
+ * @return false 解析失敗
+ *
+ * @note 數據格式 WORD0 ~ WORD3 實際依 WORD1 WORD0 WORD3 WORD2 順序收發(各 WORD 為 motorola)，
+ *       WORD0 = order, Data0 = WORD1, Data1 = WORD2, Data2 = WORD3
+ */
+RAMFUNC bool bidc300100_bank_parser(bidc300100_bank_t* bank, uint32_t id, uint8_t* data, uint8_t size)
+{
+    uint8_t pf = (uint8_t)(id >> 16);
+    uint8_t addr = (uint8_t)id;
+    uint16_t order;
+    int16_t data1;
+    int16_t data2;
+    uint8_t i;
+
+    assert(bank);
+    assert(data);
+
+    if ((size != 8) ||
+        ((id & 0x00FFFF00UL) != BIDC300100_ID(pf, BIDC300100_HOST_ADDR, 0)) ||
+        ((pf != BIDC300100_FRAME_RESPONSE) && (pf != BIDC300100_FRAME_ACK) && (pf != BIDC300100_FRAME_RESPONSE_EXT)) ||
+        ((addr & ~BANK_ADDR_MASK) != BANK_ADDR_BASE))
+    {
+        return false;
+    }
+
+    i = slot_find(bank, addr);
+
+    if (i >= BIDC300100_BANK_MAX)
+    {
+        i = slot_add(bank, addr);
+
+        if (i >= BIDC300100_BANK_MAX)
+        {
+            return false;
+        }
+    }
+
+    bank->lost[i] = 0;
+
+    order = (uint16_t)((data[2] << 8) | data[3]);
+    data1 = (int16_t)((data[6] << 8) | data[7]);
+    data2 = (int16_t)((data[4] << 8) | data[5]);
+
+    switch (order)
+    {
+        case BIDC300100_BATTERY:
+        {
+            bank->current[i] = data1;
+            break;
+        }
+        case BIDC300100_TEMPERATURE:
+        {
+            bank->temp[i] = (data1 > data2) ? data1 : data2;
+            break;
+        }
+        case BIDC300100_ONOFF:
+        {
+            if (data[1] == 0x55)
+            {
+                bank->power_output[i] = true;
+            }
+            else if (data[1] == 0xAA)
+            {
+                bank->power_output[i] = false;
+            }
+            break;
+        }
+        default: { break; }
+    }
+
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef _bidc300100_bank_h_
+#define _bidc300100_bank_h_
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "bidc300100.h"
+
+#define BIDC300100_BANK_MAX                     (8U)        /** 最多並聯模組數 */
+#define BIDC300100_BANK_SCAN                    (4U)        /** 每次 task 探測的地址數 */
+#define BIDC300100_BANK_LOST                    (4U)        /** 連續幾次 task 沒有響應視為離線 */
+#define BIDC300100_BANK_CURRENT_MAX             (2000U)     /** 單模組電流設定上限(0.1 A) */
+#define BIDC300100_BANK_TEMP_LIMIT              (850)       /** 散熱器降載溫度(0.1 度)，溫度餘裕以此計算 */
+#define BIDC300100_BANK_TEMP_MARGIN             (50)        /** 最小溫度餘裕(0.1 度)，避免權重為 0 */
+#define BIDC300100_BANK_TRIM_DIV                (4)         /** 實測電流修正比例 (1/n) */
+#define BIDC300100_BANK_DEADBAND                (5)         /** 設定變化小於此值不重送(0.1 A) */
+
+typedef struct bidc300100_bank
+{
+    bidc300100_tx_t tx;
+    uint32_t present;               /** 已發現的地址 (bit n = 地址 n) */
+    uint8_t scan;                   /** 下一個探測的地址 */
+    uint8_t poll;                   /** 輪詢相位，輪流查詢量測值與開關機狀態 */
+    uint8_t count;                  /** 在線模組數 */
+    bidc300100_ctrl_t ctrl;         /** 最後的控制命令，新發現的模組會補送 */
+    uint16_t current_setup;         /** 整組電流設定(0.1 A)，0: 不介入模組設定 */
+
+    /* 以槽位索引，0 ~ count - 1 為在線模組 */
+    uint8_t addr[BIDC300100_BANK_MAX];
+    uint8_t lost[BIDC300100_BANK_MAX];
+    bool power_output[BIDC300100_BANK_MAX];
+    int16_t current[BIDC300100_BANK_MAX];       /** 實測電池電流(0.1 A) */
+    int16_t temp[BIDC300100_BANK_MAX];          /** 散熱器溫度，原副邊較高者(0.1 度) */
+    uint16_t share[BIDC300100_BANK_MAX];        /** 已送出的電流設定(0.1 A) */
+} bidc300100_bank_t;
+
+void bidc300100_bank_init(bidc300100_bank_t* bank, bidc300100_tx_t tx);
+void bidc300100_bank_task(bidc300100_bank_t* bank);
+bool bidc300100_bank_set_ctrl(bidc300100_bank_t* bank, bidc300100_ctrl_t ctrl);
+void bidc300100_bank_current(bidc300100_bank_t* bank, uint16_t current);
+uint8_t bidc300100_bank_online(bidc300100_bank_t* bank);
+uint8_t bidc300100_bank_output(bidc300100_bank_t* bank);
+bool bidc300100_bank_parser(bidc300100_bank_t* bank, uint32_t id, uint8_t* data, uint8_t size);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef _can_codec_h_
+#define _can_codec_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ramfunc.h"
+
+/**
+ * 共用型別與存取函式，由 tools/dbcgen/dbcgen.py 產生的 *_codec.c 使用；
+ * 修改 Sources/can_codec/dbc/ 內的 DBC 後需重新產生
+ */
+
+typedef struct can_codec_signal
+{
+    const char* name;
+    uint32_t id;                    /** 所屬訊息 */
+    uint8_t start;                  /** DBC 起始位元 (Motorola 為 MSB) */
+    uint8_t length;
+    bool motorola;
+    bool is_signed;
+    float factor;                   /** 實際值 = raw x factor + offset */
+    float offset;
+    float minimum;
+    float maximum;
+    const char* unit;
+} can_codec_signal_t;
+
+/** 已編碼的發送幀，內容變更時重新編碼並設定 dirty，取出發送後清除 */
+typedef struct can_codec_frame
+{
+    uint8_t data[8];
+    bool dirty;
+} can_codec_frame_t;
+
+typedef struct can_codec_message
+{
+    const char* name;
+    uint32_t id;
+    uint8_t dlc;
+    bool extended;
+    uint8_t signal;                 /** 第一個訊號在訊號表的位置 */
+    uint8_t signals;                /** 訊號數量 */
+} can_codec_message_t;
+
+/**
+ * @brief 以 Intel (little endian) 順序讀取 8 bytes
+ */
+static inline uint64_t can_codec_load_le(const uint8_t data[8])
+{
+    return ((uint64_t)data[0]) | ((uint64_t)data[1] << 8) |
+        ((uint64_t)data[2] << 16) | ((uint64_t)data[3] << 24) |
+        ((uint64_t)data[4] << 32) | ((uint64_t)data[5] << 40) |
+        ((uint64_t)data[6] << 48) | ((uint64_t)data[7] << 56);
+}
+
+/**
+ * @brief 以 Motorola (big endian) 順序讀取 8 bytes
+ */
+static inline uint64_t can_codec_load_be(const uint8_t data[8])
+{
+    return ((uint64_t)data[0] << 56) | ((uint64_t)data[1] << 48) |
+        ((uint64_t)data[2] << 40) | ((uint64_t)data[3] << 32) |
+        ((uint64_t)data[4] << 24) | ((uint64_t)data[5] << 16) |
+        ((uint64_t)data[6] << 8) | ((uint64_t)data[7]);
+}
+
+/**
+ * @brief 複製已編碼的 8 bytes
+ */
+static inline void can_codec_copy(uint8_t data[8], const uint8_t frame[8])
+{
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+    {
+        data[i] = frame[i];
+    }
+}
+
+/**
+ * @brief 合併 Intel 與 Motorola 兩個字組寫回 8 bytes
+ */
+static inline void can_codec_store(uint8_t data[8], uint64_t le, uint64_t be)
+{
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+    {
+        data[i] = (uint8_t)(le >> (8U * i)) | (uint8_t)(be >> (56U - (8U * i)));
+    }
+}
+
+/**
+ * @brief 無分支的符號延伸
+ *
+ * @param raw 原始值
+ * @param length 位元數
+ */
+static inline int32_t can_codec_sign(uint32_t raw, uint8_t length)
+{
+    const uint32_t m = 1UL << (length - 1U);
+
+    return (int32_t)((raw ^ m) - m);
+}
+
+#endif
@@ -0,0 +1,170 @@
+/* 由 tools/dbcgen/dbcgen.py 依 Sources/can_codec/dbc/fc135kw.dbc 自動產生，請勿手動修改 */
+#include "fc135kw_codec.h"
+
+RAMFUNC void fc135kw_set_status_unpack(fc135kw_set_status_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->power_on_sig = (uint8_t)((le >> 2) & 0x1ULL);
+    msg->emerg_stop = (uint8_t)((le >> 4) & 0x1ULL);
+    msg->start = (uint8_t)((le >> 5) & 0x1ULL);
+    msg->power_setup = (uint16_t)((le >> 8) & 0xFFFFULL);
+}
+
+void fc135kw_set_status_pack(const fc135kw_set_status_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->power_on_sig & 0x1UL)) << 2;
+    le |= ((uint64_t)((uint32_t)msg->emerg_stop & 0x1UL)) << 4;
+    le |= ((uint64_t)((uint32_t)msg->start & 0x1UL)) << 5;
+    le |= ((uint64_t)((uint32_t)msg->power_setup & 0xFFFFUL)) << 8;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void fc135kw_drain_valve_unpack(fc135kw_drain_valve_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->drain_valve_mc = (uint8_t)((le >> 0) & 0x1ULL);
+    msg->drain_valve_switch = (uint8_t)((le >> 1) & 0x1ULL);
+    msg->drain_valve_period_set = (uint16_t)((le >> 8) & 0xFFFFULL);
+    msg->drain_valve_open_time_set = (uint8_t)((le >> 24) & 0xFFULL);
+}
+
+void fc135kw_drain_valve_pack(const fc135kw_drain_valve_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->drain_valve_mc & 0x1UL)) << 0;
+    le |= ((uint64_t)((uint32_t)msg->drain_valve_switch & 0x1UL)) << 1;
+    le |= ((uint64_t)((uint32_t)msg->drain_valve_period_set & 0xFFFFUL)) << 8;
+    le |= ((uint64_t)((uint32_t)msg->drain_valve_open_time_set & 0xFFUL)) << 24;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void fc135kw_remove_bubble_unpack(fc135kw_remove_bubble_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->remove_bubble = (uint8_t)((le >> 6) & 0x1ULL);
+}
+
+void fc135kw_remove_bubble_pack(const fc135kw_remove_bubble_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->remove_bubble & 0x1UL)) << 6;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void fc135kw_sys_status_unpack(fc135kw_sys_status_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->system_status = (uint8_t)((le >> 0) & 0xFFULL);
+}
+
+void fc135kw_sys_status_pack(const fc135kw_sys_status_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->system_status & 0xFFUL)) << 0;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void fc135kw_sys_h2_unpack(fc135kw_sys_h2_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->h2_pressure = (uint16_t)((le >> 0) & 0xFFFFULL);
+    msg->h2_src_pressure = (uint16_t)((le >> 48) & 0xFFFFULL);
+}
+
+void fc135kw_sys_h2_pack(const fc135kw_sys_h2_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->h2_pressure & 0xFFFFUL)) << 0;
+    le |= ((uint64_t)((uint32_t)msg->h2_src_pressure & 0xFFFFUL)) << 48;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void fc135kw_sys_water_unpack(fc135kw_sys_water_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->water_temp = (uint8_t)((le >> 32) & 0xFFULL);
+    msg->water_temp_target = (uint8_t)((le >> 48) & 0xFFULL);
+}
+
+void fc135kw_sys_water_pack(const fc135kw_sys_water_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->water_temp & 0xFFUL)) << 32;
+    le |= ((uint64_t)((uint32_t)msg->water_temp_target & 0xFFUL)) << 48;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void fc135kw_sys_error_unpack(fc135kw_sys_error_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->error_level = (uint8_t)((le >> 0) & 0xFFULL);
+    msg->error_code = (uint16_t)((le >> 8) & 0xFFFFULL);
+}
+
+void fc135kw_sys_error_pack(const fc135kw_sys_error_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->error_level & 0xFFUL)) << 0;
+    le |= ((uint64_t)((uint32_t)msg->error_code & 0xFFFFUL)) << 8;
+
+    can_codec_store(data, le, be);
+}
+
+const can_codec_signal_t fc135kw_signals[FC135KW_SIGNAL_COUNT] =
+{
+    { "PowerOnSig", 0x18F00010UL, 2, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "EmergStop", 0x18F00010UL, 4, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "Start", 0x18F00010UL, 5, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "PowerSetup", 0x18F00010UL, 8, 16, false, false, 0.01f, 0.0f, 0.0f, 655.35f, "kW" },
+    { "DrainValveMC", 0x18F00070UL, 0, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "DrainValveSwitch", 0x18F00070UL, 1, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "DrainValvePeriodSet", 0x18F00070UL, 8, 16, false, false, 0.1f, 0.0f, 0.0f, 6553.5f, "s" },
+    { "DrainValveOpenTimeSet", 0x18F00070UL, 24, 8, false, false, 0.1f, 0.0f, 0.0f, 25.5f, "s" },
+    { "RemoveBubble", 0x18F000C0UL, 6, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "SystemStatus", 0x18FC0010UL, 0, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "" },
+    { "H2Pressure", 0x18FC0040UL, 0, 16, false, false, 0.01f, 0.0f, 0.0f, 655.35f, "kPa" },
+    { "H2SrcPressure", 0x18FC0040UL, 48, 16, false, false, 0.01f, 0.0f, 0.0f, 655.35f, "kPa" },
+    { "WaterTemp", 0x18FC0050UL, 32, 8, false, false, 1.0f, -40.0f, -40.0f, 215.0f, "degC" },
+    { "WaterTempTarget", 0x18FC0050UL, 48, 8, false, false, 1.0f, -40.0f, -40.0f, 215.0f, "degC" },
+    { "ErrorLevel", 0x120BB001UL, 0, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "" },
+    { "ErrorCode", 0x120BB001UL, 8, 16, false, false, 1.0f, 0.0f, 0.0f, 65535.0f, "" },
+};
+
+const can_codec_message_t fc135kw_messages[FC135KW_MESSAGE_COUNT] =
+{
+    { "SET_STATUS", 0x18F00010UL, 8, true, 0, 4 },
+    { "DRAIN_VALVE", 0x18F00070UL, 8, true, 4, 4 },
+    { "REMOVE_BUBBLE", 0x18F000C0UL, 8, true, 8, 1 },
+    { "SYS_STATUS", 0x18FC0010UL, 8, true, 9, 1 },
+    { "SYS_H2", 0x18FC0040UL, 8, true, 10, 2 },
+    { "SYS_WATER", 0x18FC0050UL, 8, true, 12, 2 },
+    { "SYS_ERROR", 0x120BB001UL, 8, true, 14, 2 },
+};
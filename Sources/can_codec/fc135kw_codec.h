@@ -0,0 +1,80 @@
+/* 由 tools/dbcgen/dbcgen.py 依 Sources/can_codec/dbc/fc135kw.dbc 自動產生，請勿手動修改 */
+#ifndef _fc135kw_codec_h_
+#define _fc135kw_codec_h_
+
+#include "can_codec.h"
+
+#define FC135KW_SET_STATUS_ID                    (0x18F00010UL)
+#define FC135KW_DRAIN_VALVE_ID                   (0x18F00070UL)    /** purge schedule, period/open time 0 = controller default */
+#define FC135KW_REMOVE_BUBBLE_ID                 (0x18F000C0UL)
+#define FC135KW_SYS_STATUS_ID                    (0x18FC0010UL)
+#define FC135KW_SYS_H2_ID                        (0x18FC0040UL)
+#define FC135KW_SYS_WATER_ID                     (0x18FC0050UL)
+#define FC135KW_SYS_ERROR_ID                     (0x120BB001UL)
+#define FC135KW_MESSAGE_COUNT                    (7U)
+#define FC135KW_SIGNAL_COUNT                     (16U)
+
+typedef struct fc135kw_set_status
+{
+    uint8_t         power_on_sig;           /** raw */
+    uint8_t         emerg_stop;             /** raw */
+    uint8_t         start;                  /** raw */
+    uint16_t        power_setup;            /** raw x 0.01 (kW) */
+} fc135kw_set_status_t;
+
+/** purge schedule, period/open time 0 = controller default */
+typedef struct fc135kw_drain_valve
+{
+    uint8_t         drain_valve_mc;         /** raw */
+    uint8_t         drain_valve_switch;     /** raw */
+    uint16_t        drain_valve_period_set; /** raw x 0.1 (s) */
+    uint8_t         drain_valve_open_time_set;/** raw x 0.1 (s) */
+} fc135kw_drain_valve_t;
+
+typedef struct fc135kw_remove_bubble
+{
+    uint8_t         remove_bubble;          /** raw */
+} fc135kw_remove_bubble_t;
+
+typedef struct fc135kw_sys_status
+{
+    uint8_t         system_status;          /** raw */
+} fc135kw_sys_status_t;
+
+typedef struct fc135kw_sys_h2
+{
+    uint16_t        h2_pressure;            /** raw x 0.01 (kPa) */
+    uint16_t        h2_src_pressure;        /** raw x 0.01 (kPa) */
+} fc135kw_sys_h2_t;
+
+typedef struct fc135kw_sys_water
+{
+    uint8_t         water_temp;             /** raw x 1 -40 (degC) */
+    uint8_t         water_temp_target;      /** raw x 1 -40 (degC) */
+} fc135kw_sys_water_t;
+
+typedef struct fc135kw_sys_error
+{
+    uint8_t         error_level;            /** raw */
+    uint16_t        error_code;             /** raw */
+} fc135kw_sys_error_t;
+
+void fc135kw_set_status_unpack(fc135kw_set_status_t* msg, const uint8_t data[8]);
+void fc135kw_set_status_pack(const fc135kw_set_status_t* msg, uint8_t data[8]);
+void fc135kw_drain_valve_unpack(fc135kw_drain_valve_t* msg, const uint8_t data[8]);
+void fc135kw_drain_valve_pack(const fc135kw_drain_valve_t* msg, uint8_t data[8]);
+void fc135kw_remove_bubble_unpack(fc135kw_remove_bubble_t* msg, const uint8_t data[8]);
+void fc135kw_remove_bubble_pack(const fc135kw_remove_bubble_t* msg, uint8_t data[8]);
+void fc135kw_sys_status_unpack(fc135kw_sys_status_t* msg, const uint8_t data[8]);
+void fc135kw_sys_status_pack(const fc135kw_sys_status_t* msg, uint8_t data[8]);
+void fc135kw_sys_h2_unpack(fc135kw_sys_h2_t* msg, const uint8_t data[8]);
+void fc135kw_sys_h2_pack(const fc135kw_sys_h2_t* msg, uint8_t data[8]);
+void fc135kw_sys_water_unpack(fc135kw_sys_water_t* msg, const uint8_t data[8]);
+void fc135kw_sys_water_pack(const fc135kw_sys_water_t* msg, uint8_t data[8]);
+void fc135kw_sys_error_unpack(fc135kw_sys_error_t* msg, const uint8_t data[8]);
+void fc135kw_sys_error_pack(const fc135kw_sys_error_t* msg, uint8_t data[8]);
+
+extern const can_codec_message_t fc135kw_messages[FC135KW_MESSAGE_COUNT];
+extern const can_codec_signal_t fc135kw_signals[FC135KW_SIGNAL_COUNT];
+
+#endif
@@ -0,0 +1,143 @@
+/* 由 tools/dbcgen/dbcgen.py 依 Sources/can_codec/dbc/host.dbc 自動產生，請勿手動修改 */
+#include "host_codec.h"
+
+RAMFUNC void host_tyt60kw_cmd_unpack(host_tyt60kw_cmd_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->start = (uint8_t)((le >> 0) & 0xFFULL);
+    msg->clear_error = (uint8_t)((le >> 8) & 0xFFULL);
+    msg->power = (uint8_t)((le >> 16) & 0xFFULL);
+}
+
+void host_tyt60kw_cmd_pack(const host_tyt60kw_cmd_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->start & 0xFFUL)) << 0;
+    le |= ((uint64_t)((uint32_t)msg->clear_error & 0xFFUL)) << 8;
+    le |= ((uint64_t)((uint32_t)msg->power & 0xFFUL)) << 16;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void host_tyt60kw_status_unpack(host_tyt60kw_status_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->status = (uint8_t)((le >> 0) & 0xFFULL);
+    msg->error_level = (uint8_t)((le >> 8) & 0xFFULL);
+    msg->start = (uint8_t)((le >> 16) & 0x1ULL);
+    msg->power_setup = (uint8_t)((le >> 24) & 0xFFULL);
+    msg->light_green = (uint8_t)((le >> 56) & 0x1ULL);
+    msg->light_yellow = (uint8_t)((le >> 57) & 0x1ULL);
+    msg->light_red = (uint8_t)((le >> 58) & 0x1ULL);
+    msg->buzzer = (uint8_t)((le >> 59) & 0x1ULL);
+}
+
+void host_tyt60kw_status_pack(const host_tyt60kw_status_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->status & 0xFFUL)) << 0;
+    le |= ((uint64_t)((uint32_t)msg->error_level & 0xFFUL)) << 8;
+    le |= ((uint64_t)((uint32_t)msg->start & 0x1UL)) << 16;
+    le |= ((uint64_t)((uint32_t)msg->power_setup & 0xFFUL)) << 24;
+    le |= ((uint64_t)((uint32_t)msg->light_green & 0x1UL)) << 56;
+    le |= ((uint64_t)((uint32_t)msg->light_yellow & 0x1UL)) << 57;
+    le |= ((uint64_t)((uint32_t)msg->light_red & 0x1UL)) << 58;
+    le |= ((uint64_t)((uint32_t)msg->buzzer & 0x1UL)) << 59;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void host_fc135kw_cmd_unpack(host_fc135kw_cmd_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->start = (uint8_t)((le >> 0) & 0xFFULL);
+    msg->clear_error = (uint8_t)((le >> 8) & 0xFFULL);
+    msg->power = (uint8_t)((le >> 16) & 0xFFULL);
+}
+
+void host_fc135kw_cmd_pack(const host_fc135kw_cmd_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->start & 0xFFUL)) << 0;
+    le |= ((uint64_t)((uint32_t)msg->clear_error & 0xFFUL)) << 8;
+    le |= ((uint64_t)((uint32_t)msg->power & 0xFFUL)) << 16;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void host_fc135kw_status_unpack(host_fc135kw_status_t* msg, const uint8_t data[8])
+{
+    const uint64_t le = can_codec_load_le(data);
+
+    msg->status = (uint8_t)((le >> 0) & 0xFFULL);
+    msg->error_level = (uint8_t)((le >> 8) & 0xFFULL);
+    msg->start = (uint8_t)((le >> 16) & 0x1ULL);
+    msg->power_setup = (uint8_t)((le >> 24) & 0xFFULL);
+    msg->warmup_time = (uint16_t)((le >> 32) & 0xFFFFULL);
+    msg->light_green = (uint8_t)((le >> 56) & 0x1ULL);
+    msg->light_yellow = (uint8_t)((le >> 57) & 0x1ULL);
+    msg->light_red = (uint8_t)((le >> 58) & 0x1ULL);
+    msg->buzzer = (uint8_t)((le >> 59) & 0x1ULL);
+}
+
+void host_fc135kw_status_pack(const host_fc135kw_status_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    le |= ((uint64_t)((uint32_t)msg->status & 0xFFUL)) << 0;
+    le |= ((uint64_t)((uint32_t)msg->error_level & 0xFFUL)) << 8;
+    le |= ((uint64_t)((uint32_t)msg->start & 0x1UL)) << 16;
+    le |= ((uint64_t)((uint32_t)msg->power_setup & 0xFFUL)) << 24;
+    le |= ((uint64_t)((uint32_t)msg->warmup_time & 0xFFFFUL)) << 32;
+    le |= ((uint64_t)((uint32_t)msg->light_green & 0x1UL)) << 56;
+    le |= ((uint64_t)((uint32_t)msg->light_yellow & 0x1UL)) << 57;
+    le |= ((uint64_t)((uint32_t)msg->light_red & 0x1UL)) << 58;
+    le |= ((uint64_t)((uint32_t)msg->buzzer & 0x1UL)) << 59;
+
+    can_codec_store(data, le, be);
+}
+
+const can_codec_signal_t host_signals[HOST_SIGNAL_COUNT] =
+{
+    { "Start", 0x00BB8110UL, 0, 8, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "ClearError", 0x00BB8110UL, 8, 8, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "Power", 0x00BB8110UL, 16, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "kW" },
+    { "Status", 0x00AA8110UL, 0, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "" },
+    { "ErrorLevel", 0x00AA8110UL, 8, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "" },
+    { "Start", 0x00AA8110UL, 16, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "PowerSetup", 0x00AA8110UL, 24, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "kW" },
+    { "LightGreen", 0x00AA8110UL, 56, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "LightYellow", 0x00AA8110UL, 57, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "LightRed", 0x00AA8110UL, 58, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "Buzzer", 0x00AA8110UL, 59, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "Start", 0x00BB8210UL, 0, 8, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "ClearError", 0x00BB8210UL, 8, 8, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "Power", 0x00BB8210UL, 16, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "kW" },
+    { "Status", 0x00AA8210UL, 0, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "" },
+    { "ErrorLevel", 0x00AA8210UL, 8, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "" },
+    { "Start", 0x00AA8210UL, 16, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "PowerSetup", 0x00AA8210UL, 24, 8, false, false, 1.0f, 0.0f, 0.0f, 255.0f, "kW" },
+    { "WarmupTime", 0x00AA8210UL, 32, 16, false, false, 1.0f, 0.0f, 0.0f, 65535.0f, "s" },
+    { "LightGreen", 0x00AA8210UL, 56, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "LightYellow", 0x00AA8210UL, 57, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "LightRed", 0x00AA8210UL, 58, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "Buzzer", 0x00AA8210UL, 59, 1, false, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+};
+
+const can_codec_message_t host_messages[HOST_MESSAGE_COUNT] =
+{
+    { "TYT60KW_CMD", 0x00BB8110UL, 8, true, 0, 3 },
+    { "TYT60KW_STATUS", 0x00AA8110UL, 8, true, 3, 8 },
+    { "FC135KW_CMD", 0x00BB8210UL, 8, true, 11, 3 },
+    { "FC135KW_STATUS", 0x00AA8210UL, 8, true, 14, 9 },
+};
@@ -0,0 +1,65 @@
+/* 由 tools/dbcgen/dbcgen.py 依 Sources/can_codec/dbc/host.dbc 自動產生，請勿手動修改 */
+#ifndef _host_codec_h_
+#define _host_codec_h_
+
+#include "can_codec.h"
+
+#define HOST_TYT60KW_CMD_ID                      (0x00BB8110UL)
+#define HOST_TYT60KW_STATUS_ID                   (0x00AA8110UL)
+#define HOST_FC135KW_CMD_ID                      (0x00BB8210UL)
+#define HOST_FC135KW_STATUS_ID                   (0x00AA8210UL)
+#define HOST_MESSAGE_COUNT                       (4U)
+#define HOST_SIGNAL_COUNT                        (23U)
+
+typedef struct host_tyt60kw_cmd
+{
+    uint8_t         start;                  /** raw */
+    uint8_t         clear_error;            /** raw */
+    uint8_t         power;                  /** raw (kW) */
+} host_tyt60kw_cmd_t;
+
+typedef struct host_tyt60kw_status
+{
+    uint8_t         status;                 /** raw */
+    uint8_t         error_level;            /** raw */
+    uint8_t         start;                  /** raw */
+    uint8_t         power_setup;            /** raw (kW) */
+    uint8_t         light_green;            /** raw */
+    uint8_t         light_yellow;           /** raw */
+    uint8_t         light_red;              /** raw */
+    uint8_t         buzzer;                 /** raw */
+} host_tyt60kw_status_t;
+
+typedef struct host_fc135kw_cmd
+{
+    uint8_t         start;                  /** raw */
+    uint8_t         clear_error;            /** raw */
+    uint8_t         power;                  /** raw (kW) */
+} host_fc135kw_cmd_t;
+
+typedef struct host_fc135kw_status
+{
+    uint8_t         status;                 /** raw */
+    uint8_t         error_level;            /** raw */
+    uint8_t         start;                  /** raw */
+    uint8_t         power_setup;            /** raw (kW) */
+    uint16_t        warmup_time;            /** raw (s) */
+    uint8_t         light_green;            /** raw */
+    uint8_t         light_yellow;           /** raw */
+    uint8_t         light_red;              /** raw */
+    uint8_t         buzzer;                 /** raw */
+} host_fc135kw_status_t;
+
+void host_tyt60kw_cmd_unpack(host_tyt60kw_cmd_t* msg, const uint8_t data[8]);
+void host_tyt60kw_cmd_pack(const host_tyt60kw_cmd_t* msg, uint8_t data[8]);
+void host_tyt60kw_status_unpack(host_tyt60kw_status_t* msg, const uint8_t data[8]);
+void host_tyt60kw_status_pack(const host_tyt60kw_status_t* msg, uint8_t data[8]);
+void host_fc135kw_cmd_unpack(host_fc135kw_cmd_t* msg, const uint8_t data[8]);
+void host_fc135kw_cmd_pack(const host_fc135kw_cmd_t* msg, uint8_t data[8]);
+void host_fc135kw_status_unpack(host_fc135kw_status_t* msg, const uint8_t data[8]);
+void host_fc135kw_status_pack(const host_fc135kw_status_t* msg, uint8_t data[8]);
+
+extern const can_codec_message_t host_messages[HOST_MESSAGE_COUNT];
+extern const can_codec_signal_t host_signals[HOST_SIGNAL_COUNT];
+
+#endif
@@ -0,0 +1,173 @@
+/* 由 tools/dbcgen/dbcgen.py 依 Sources/can_codec/dbc/tyt60kw.dbc 自動產生，請勿手動修改 */
+#include "tyt60kw_codec.h"
+
+RAMFUNC void tyt60kw_ev_hv_1_unpack(tyt60kw_ev_hv_1_t* msg, const uint8_t data[8])
+{
+    const uint64_t be = can_codec_load_be(data);
+
+    msg->power_max = (uint8_t)((be >> 48) & 0xFFULL);
+    msg->power_cmd = (uint16_t)((be >> 32) & 0xFFFULL);
+    msg->relay_off = (uint8_t)((be >> 44) & 0x1ULL);
+    msg->start_command = (uint8_t)((be >> 12) & 0xFULL);
+}
+
+void tyt60kw_ev_hv_1_pack(const tyt60kw_ev_hv_1_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    be |= ((uint64_t)((uint32_t)msg->power_max & 0xFFUL)) << 48;
+    be |= ((uint64_t)((uint32_t)msg->power_cmd & 0xFFFUL)) << 32;
+    be |= ((uint64_t)((uint32_t)msg->relay_off & 0x1UL)) << 44;
+    be |= ((uint64_t)((uint32_t)msg->start_command & 0xFUL)) << 12;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void tyt60kw_ev_hv_2_unpack(tyt60kw_ev_hv_2_t* msg, const uint8_t data[8])
+{
+    (void)data;
+    msg->reserved = 0;
+}
+
+void tyt60kw_ev_hv_2_pack(const tyt60kw_ev_hv_2_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    (void)msg;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void tyt60kw_fc_050_unpack(tyt60kw_fc_050_t* msg, const uint8_t data[8])
+{
+    const uint64_t be = can_codec_load_be(data);
+
+    msg->fc_status = (uint8_t)((be >> 60) & 0x7ULL);
+    msg->relay_status = (uint8_t)((be >> 63) & 0x1ULL);
+}
+
+void tyt60kw_fc_050_pack(const tyt60kw_fc_050_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    be |= ((uint64_t)((uint32_t)msg->fc_status & 0x7UL)) << 60;
+    be |= ((uint64_t)((uint32_t)msg->relay_status & 0x1UL)) << 63;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void tyt60kw_fc_051_unpack(tyt60kw_fc_051_t* msg, const uint8_t data[8])
+{
+    const uint64_t be = can_codec_load_be(data);
+
+    msg->error_level = (uint8_t)((be >> 22) & 0x3ULL);
+    msg->pcu_voltage = (uint16_t)((be >> 0) & 0x7FFULL);
+}
+
+void tyt60kw_fc_051_pack(const tyt60kw_fc_051_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    be |= ((uint64_t)((uint32_t)msg->error_level & 0x3UL)) << 22;
+    be |= ((uint64_t)((uint32_t)msg->pcu_voltage & 0x7FFUL)) << 0;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void tyt60kw_fc_222_unpack(tyt60kw_fc_222_t* msg, const uint8_t data[8])
+{
+    const uint64_t be = can_codec_load_be(data);
+
+    msg->water_temp_fco = (uint8_t)((be >> 56) & 0xFFULL);
+}
+
+void tyt60kw_fc_222_pack(const tyt60kw_fc_222_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    be |= ((uint64_t)((uint32_t)msg->water_temp_fco & 0xFFUL)) << 56;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void tyt60kw_fc_225_unpack(tyt60kw_fc_225_t* msg, const uint8_t data[8])
+{
+    const uint64_t be = can_codec_load_be(data);
+
+    msg->pcu_temp = (uint8_t)((be >> 48) & 0xFFULL);
+}
+
+void tyt60kw_fc_225_pack(const tyt60kw_fc_225_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    be |= ((uint64_t)((uint32_t)msg->pcu_temp & 0xFFUL)) << 48;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void tyt60kw_fc_507_unpack(tyt60kw_fc_507_t* msg, const uint8_t data[8])
+{
+    (void)data;
+    msg->reserved = 0;
+}
+
+void tyt60kw_fc_507_pack(const tyt60kw_fc_507_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    (void)msg;
+
+    can_codec_store(data, le, be);
+}
+
+RAMFUNC void tyt60kw_fc_508_unpack(tyt60kw_fc_508_t* msg, const uint8_t data[8])
+{
+    const uint64_t be = can_codec_load_be(data);
+
+    msg->error_code = (uint8_t)((be >> 0) & 0xFFULL);
+}
+
+void tyt60kw_fc_508_pack(const tyt60kw_fc_508_t* msg, uint8_t data[8])
+{
+    uint64_t le = 0;
+    uint64_t be = 0;
+
+    be |= ((uint64_t)((uint32_t)msg->error_code & 0xFFUL)) << 0;
+
+    can_codec_store(data, le, be);
+}
+
+const can_codec_signal_t tyt60kw_signals[TYT60KW_SIGNAL_COUNT] =
+{
+    { "PowerMax", 0x0000004EUL, 15, 8, true, false, 1.0f, 0.0f, 0.0f, 255.0f, "kW" },
+    { "PowerCmd", 0x0000004EUL, 19, 12, true, false, 0.1f, 0.0f, 0.0f, 409.5f, "kW" },
+    { "RelayOff", 0x0000004EUL, 20, 1, true, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "StartCommand", 0x0000004EUL, 55, 4, true, false, 1.0f, 0.0f, 0.0f, 15.0f, "" },
+    { "FcStatus", 0x00000050UL, 6, 3, true, false, 1.0f, 0.0f, 0.0f, 7.0f, "" },
+    { "RelayStatus", 0x00000050UL, 7, 1, true, false, 1.0f, 0.0f, 0.0f, 1.0f, "" },
+    { "ErrorLevel", 0x00000051UL, 47, 2, true, false, 1.0f, 0.0f, 0.0f, 3.0f, "" },
+    { "PcuVoltage", 0x00000051UL, 50, 11, true, false, 1.0f, 0.0f, 0.0f, 2047.0f, "V" },
+    { "WaterTempFco", 0x00000222UL, 7, 8, true, false, 1.0f, 0.0f, 0.0f, 255.0f, "degC" },
+    { "PcuTemp", 0x00000225UL, 15, 8, true, false, 1.0f, 0.0f, 0.0f, 255.0f, "degC" },
+    { "ErrorCode", 0x00000508UL, 63, 8, true, false, 1.0f, 0.0f, 0.0f, 255.0f, "" },
+};
+
+const can_codec_message_t tyt60kw_messages[TYT60KW_MESSAGE_COUNT] =
+{
+    { "EV_HV_1", 0x0000004EUL, 8, false, 0, 4 },
+    { "EV_HV_2", 0x00000215UL, 8, false, 4, 0 },
+    { "FC_050", 0x00000050UL, 8, false, 4, 2 },
+    { "FC_051", 0x00000051UL, 8, false, 6, 2 },
+    { "FC_222", 0x00000222UL, 8, false, 8, 1 },
+    { "FC_225", 0x00000225UL, 8, false, 9, 1 },
+    { "FC_507", 0x00000507UL, 8, false, 10, 0 },
+    { "FC_508", 0x00000508UL, 8, false, 10, 1 },
+};
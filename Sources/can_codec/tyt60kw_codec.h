@@ -0,0 +1,85 @@
+/* 由 tools/dbcgen/dbcgen.py 依 Sources/can_codec/dbc/tyt60kw.dbc 自動產生，請勿手動修改 */
+#ifndef _tyt60kw_codec_h_
+#define _tyt60kw_codec_h_
+
+#include "can_codec.h"
+
+#define TYT60KW_EV_HV_1_ID                       (0x0000004EUL)    /** 10 ms cycle */
+#define TYT60KW_EV_HV_2_ID                       (0x00000215UL)    /** 100 ms cycle, sent as zero */
+#define TYT60KW_FC_050_ID                        (0x00000050UL)
+#define TYT60KW_FC_051_ID                        (0x00000051UL)
+#define TYT60KW_FC_222_ID                        (0x00000222UL)
+#define TYT60KW_FC_225_ID                        (0x00000225UL)
+#define TYT60KW_FC_507_ID                        (0x00000507UL)
+#define TYT60KW_FC_508_ID                        (0x00000508UL)
+#define TYT60KW_MESSAGE_COUNT                    (8U)
+#define TYT60KW_SIGNAL_COUNT                     (11U)
+
+/** 10 ms cycle */
+typedef struct tyt60kw_ev_hv_1
+{
+    uint8_t         power_max;              /** raw (kW) */
+    uint16_t        power_cmd;              /** raw x 0.1 (kW) */
+    uint8_t         relay_off;              /** raw */
+    uint8_t         start_command;          /** raw */
+} tyt60kw_ev_hv_1_t;
+
+/** 100 ms cycle, sent as zero */
+typedef struct tyt60kw_ev_hv_2
+{
+    uint8_t reserved;
+} tyt60kw_ev_hv_2_t;
+
+typedef struct tyt60kw_fc_050
+{
+    uint8_t         fc_status;              /** raw */
+    uint8_t         relay_status;           /** raw */
+} tyt60kw_fc_050_t;
+
+typedef struct tyt60kw_fc_051
+{
+    uint8_t         error_level;            /** raw */
+    uint16_t        pcu_voltage;            /** raw (V) */
+} tyt60kw_fc_051_t;
+
+typedef struct tyt60kw_fc_222
+{
+    uint8_t         water_temp_fco;         /** raw (degC) */
+} tyt60kw_fc_222_t;
+
+typedef struct tyt60kw_fc_225
+{
+    uint8_t         pcu_temp;               /** raw (degC) */
+} tyt60kw_fc_225_t;
+
+typedef struct tyt60kw_fc_507
+{
+    uint8_t reserved;
+} tyt60kw_fc_507_t;
+
+typedef struct tyt60kw_fc_508
+{
+    uint8_t         error_code;             /** raw */
+} tyt60kw_fc_508_t;
+
+void tyt60kw_ev_hv_1_unpack(tyt60kw_ev_hv_1_t* msg, const uint8_t data[8]);
+void tyt60kw_ev_hv_1_pack(const tyt60kw_ev_hv_1_t* msg, uint8_t data[8]);
+void tyt60kw_ev_hv_2_unpack(tyt60kw_ev_hv_2_t* msg, const uint8_t data[8]);
+void tyt60kw_ev_hv_2_pack(const tyt60kw_ev_hv_2_t* msg, uint8_t data[8]);
+void tyt60kw_fc_050_unpack(tyt60kw_fc_050_t* msg, const uint8_t data[8]);
+void tyt60kw_fc_050_pack(const tyt60kw_fc_050_t* msg, uint8_t data[8]);
+void tyt60kw_fc_051_unpack(tyt60kw_fc_051_t* msg, const uint8_t data[8]);
+void tyt60kw_fc_051_pack(const tyt60kw_fc_051_t* msg, uint8_t data[8]);
+void tyt60kw_fc_222_unpack(tyt60kw_fc_222_t* msg, const uint8_t data[8]);
+void tyt60kw_fc_222_pack(const tyt60kw_fc_222_t* msg, uint8_t data[8]);
+void tyt60kw_fc_225_unpack(tyt60kw_fc_225_t* msg, const uint8_t data[8]);
+void tyt60kw_fc_225_pack(const tyt60kw_fc_225_t* msg, uint8_t data[8]);
+void tyt60kw_fc_507_unpack(tyt60kw_fc_507_t* msg, const uint8_t data[8]);
+void tyt60kw_fc_507_pack(const tyt60kw_fc_507_t* msg, uint8_t data[8]);
+void tyt60kw_fc_508_unpack(tyt60kw_fc_508_t* msg, const uint8_t data[8]);
+void tyt60kw_fc_508_pack(const tyt60kw_fc_508_t* msg, uint8_t data[8]);
+
+extern const can_codec_message_t tyt60kw_messages[TYT60KW_MESSAGE_COUNT];
+extern const can_codec_signal_t tyt60kw_signals[TYT60KW_SIGNAL_COUNT];
+
+#endif
@@ -0,0 +1,75 @@
+#include "can_fastpath.h"
+#include "ramfunc.h"
+#include <assert.h>
+
+/**
+ * @brief 快速路徑初始化
+ *
+ * @param fp 快速路徑物件
+ * @param rule 規則表(需為常駐記憶體)
+ * @param count 規則數量，最多 CAN_FASTPATH_RULE_MAX
+ */
+void can_fastpath_init(can_fastpath_t* fp, const can_fastpath_rule_t* rule, uint8_t count)
+{
+    uint8_t i;
+
+    assert(fp);
+    assert(rule || (count == 0));
+    assert(count <= CAN_FASTPATH_RULE_MAX);
+
+    fp->rule = rule;
+    fp->count = count;
+
+    for (i = 0; i < CAN_FASTPATH_RULE_MAX; i++)
+    {
+        fp->hits[i] = 0;
+    }
+}
+
+/**
+ * @brief 依規則檢查收到的訊框，符合時立即執行動作
+ *
+ * @param fp 快速路徑物件
+ * @param id CAN ID
+ * @param data 資料
+ *
+ * @return true: 至少一條規則觸發
+ *
+ * @note 在接收中斷內調用，條件與動作都必須短且不可阻塞；
+ *       動作只負責讓硬體先進入安全狀態，狀態機由主迴圈收到同一訊框後接手
+ */
+RAMFUNC bool can_fastpath_dispatch(can_fastpath_t* fp, uint32_t id, const uint8_t data[8])
+{
+    const can_fastpath_rule_t* rule;
+    bool fired = false;
+    uint8_t i;
+
+    for (i = 0; i < fp->count; i++)
+    {
+        rule = &fp->rule[i];
+
+        if ((rule->id == id) && ((rule->match == NULL) || rule->match(data)))
+        {
+            rule->action();
+            fp->hits[i]++;
+            fired = true;
+        }
+    }
+
+    return fired;
+}
+
+/**
+ * @brief 取得規則觸發次數
+ *
+ * @param fp 快速路徑物件
+ * @param index 規則編號
+ *
+ * @return uint16_t 觸發次數(溢位後從 0 繼續)
+ */
+uint16_t can_fastpath_hits(const can_fastpath_t* fp, uint8_t index)
+{
+    assert(fp);
+
+    return (index < fp->count) ? fp->hits[index] : 0;
+}
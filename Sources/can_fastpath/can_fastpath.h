@@ -0,0 +1,31 @@
+#ifndef _can_fastpath_h_
+#define _can_fastpath_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define CAN_FASTPATH_RULE_MAX                   (8U)
+
+typedef bool (*can_fastpath_match_t)(const uint8_t data[8]);
+typedef void (*can_fastpath_action_t)(void);
+
+typedef struct can_fastpath_rule
+{
+    uint32_t id;                    /** CAN ID */
+    can_fastpath_match_t match;     /** 條件判斷，NULL 表示收到即動作 */
+    can_fastpath_action_t action;   /** 立即動作 */
+} can_fastpath_rule_t;
+
+typedef struct can_fastpath
+{
+    const can_fastpath_rule_t* rule;
+    uint8_t count;
+    volatile uint16_t hits[CAN_FASTPATH_RULE_MAX];  /** 每條規則觸發次數 */
+} can_fastpath_t;
+
+void can_fastpath_init(can_fastpath_t* fp, const can_fastpath_rule_t* rule, uint8_t count);
+bool can_fastpath_dispatch(can_fastpath_t* fp, uint32_t id, const uint8_t data[8]);
+uint16_t can_fastpath_hits(const can_fastpath_t* fp, uint8_t index);
+
+#endif
@@ -0,0 +1,296 @@
+#include "can_health.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <assert.h>
+
+/**
+ * @brief logger
+ *
+ * @param health 匯流排監控物件
+ * @param fmt logger 訊息
+ * @param ... 可選參數
+ */
+static void logger(can_health_t* health, const char* fmt, ...)
+{
+    uint16_t len;
+    char buffer[128] = { 0 };
+
+    assert(health);
+
+    if (health->config->log)
+    {
+        va_list args;
+        va_start(args, fmt);
+
+        len = snprintf(buffer, 128, "[%s]", health->config->name);
+        len += vsnprintf(&buffer[len], (128 - len), fmt, args);
+
+        va_end(args);
+
+        health->config->log(&buffer[0], len);
+    }
+}
+
+/**
+ * @brief 切換狀態並通知上層
+ *
+ * @param health 匯流排監控物件
+ * @param state 新狀態
+ */
+static void change(can_health_t* health, can_health_state_t state)
+{
+    if (health->state != state)
+    {
+        health->state = state;
+
+        if (health->config->event)
+        {
+            health->config->event(health->handle, state);
+        }
+    }
+}
+
+/**
+ * @brief 由錯誤計數器判斷 error active/warning/passive
+ *
+ * @param counter 錯誤計數器
+ *
+ * @return can_health_state_t
+ */
+static can_health_state_t level(can_health_counter_t counter)
+{
+    if (counter.passive)
+    {
+        return CAN_HEALTH_PASSIVE;
+    }
+
+    if ((counter.tec >= CAN_HEALTH_WARNING_LEVEL) ||
+        (counter.rec >= CAN_HEALTH_WARNING_LEVEL))
+    {
+        return CAN_HEALTH_WARNING;
+    }
+
+    return CAN_HEALTH_ACTIVE;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 匯流排監控初始化
+ *
+ * @param health 匯流排監控物件
+ * @param handle 匯流排物件(回呼時帶回)
+ * @param bitrate 匯流排速率 (bps)
+ * @param config 配置結構體
+ */
+void can_health_init(can_health_t* health, const void* handle, uint32_t bitrate, can_health_config_t* config)
+{
+    assert(health);
+    assert(config);
+    assert(bitrate);
+
+    health->handle = handle;
+    health->bitrate = bitrate;
+    health->config = config;
+    health->bits = 0;
+    health->load = 0;
+    health->load_peak = 0;
+    health->window = 0;
+    health->tec = 0;
+    health->rec = 0;
+    health->bus_off_count = 0;
+    health->backoff = CAN_HEALTH_BACKOFF_MIN;
+    health->time_count = 0;
+    health->stable_time = 0;
+    health->state = CAN_HEALTH_ACTIVE;
+}
+
+/**
+ * @brief 匯流排監控任務
+ *
+ * @param health 匯流排監控物件
+ *
+ * @note 內建時間計數器，需以 10ms 間隔時間調用
+ */
+void can_health_task(can_health_t* health)
+{
+    can_health_counter_t counter = { 0 };
+
+    assert(health);
+
+    if (health->config->read)
+    {
+        counter = health->config->read(health->handle);
+    }
+
+    health->tec = counter.tec;
+    health->rec = counter.rec;
+
+    if (health->time_count > 1)
+    {
+        health->time_count--;
+    }
+
+    switch (health->state)
+    {
+        default:
+        case CAN_HEALTH_ACTIVE:
+        case CAN_HEALTH_WARNING:
+        case CAN_HEALTH_PASSIVE:
+        {
+            if (counter.bus_off)
+            {
+                health->bus_off_count++;
+                health->time_count = health->backoff;
+                health->stable_time = 0;
+                change(health, CAN_HEALTH_BUS_OFF);
+                logger(health, "bus off, count: %d, backoff: %d ms\r\n",
+                    health->bus_off_count, (health->backoff * 10));
+                break;
+            }
+
+            change(health, level(counter));
+
+            /* 穩定一段時間後，退避時間回到最短 */
+            if (health->state == CAN_HEALTH_ACTIVE)
+            {
+                if (health->stable_time < CAN_HEALTH_STABLE_TIME)
+                {
+                    if (++health->stable_time >= CAN_HEALTH_STABLE_TIME)
+                    {
+                        health->backoff = CAN_HEALTH_BACKOFF_MIN;
+                    }
+                }
+            }
+            else
+            {
+                health->stable_time = 0;
+            }
+            break;
+        }
+        case CAN_HEALTH_BUS_OFF:
+        {
+            if (health->time_count == 1)
+            {
+                if (health->config->recover)
+                {
+                    health->config->recover(health->handle, true);
+                }
+
+                health->time_count = CAN_HEALTH_RECOVER_TIMEOUT;
+                change(health, CAN_HEALTH_RECOVERING);
+            }
+            break;
+        }
+        case CAN_HEALTH_RECOVERING:
+        {
+            if (!counter.bus_off)
+            {
+                /* 恢復完成，重新關閉自動恢復，由本模組控制退避 */
+                if (health->config->recover)
+                {
+                    health->config->recover(health->handle, false);
+                }
+
+                change(health, level(counter));
+                logger(health, "bus off recovered\r\n");
+            }
+            else if (health->time_count == 1)
+            {
+                if (health->config->recover)
+                {
+                    health->config->recover(health->handle, false);
+                }
+
+                /* 恢復失敗，加倍退避時間 */
+                health->backoff <<= 1;
+
+                if (health->backoff > CAN_HEALTH_BACKOFF_MAX)
+                {
+                    health->backoff = CAN_HEALTH_BACKOFF_MAX;
+                }
+
+                health->bus_off_count++;
+                health->time_count = health->backoff;
+                change(health, CAN_HEALTH_BUS_OFF);
+                logger(health, "bus off recover failed, backoff: %d ms\r\n",
+                    (health->backoff * 10));
+            }
+            break;
+        }
+    }
+
+    if (++health->window >= CAN_HEALTH_LOAD_WINDOW)
+    {
+        /* 統計區間為 1 秒，bits / bitrate = 佔用比例 */
+        health->load = (uint16_t)(((uint64_t)health->bits * 1000U) / health->bitrate);
+
+        if (health->load > health->load_peak)
+        {
+            health->load_peak = health->load;
+        }
+
+        health->bits = 0;
+        health->window = 0;
+    }
+}
+
+/**
+ * @brief 匯流排負載統計，每收發一幀調用一次
+ *
+ * @param health 匯流排監控物件
+ * @param extended true: 擴展幀, false: 標準幀
+ * @param dlc 數據長度
+ *
+ * @note 以最壞情況的位元填充估算幀長度，包含 3 bits 幀間隔
+ */
+void can_health_frame(can_health_t* health, bool extended, uint8_t dlc)
+{
+    uint16_t bits;
+
+    assert(health);
+
+    if (dlc > 8)
+    {
+        dlc = 8;
+    }
+
+    if (extended)
+    {
+        bits = (67U + (8U * dlc)) + ((53U + (8U * dlc)) / 4U);
+    }
+    else
+    {
+        bits = (47U + (8U * dlc)) + ((33U + (8U * dlc)) / 4U);
+    }
+
+    health->bits += bits;
+}
+
+/**
+ * @brief 匯流排狀態
+ *
+ * @param health 匯流排監控物件
+ *
+ * @return can_health_state_t
+ */
+can_health_state_t can_health_state(can_health_t* health)
+{
+    assert(health);
+
+    return health->state;
+}
+
+/**
+ * @brief 匯流排負載
+ *
+ * @param health 匯流排監控物件
+ *
+ * @return uint16_t 最近 1 秒的負載 (0.1 %)
+ */
+uint16_t can_health_load(can_health_t* health)
+{
+    assert(health);
+
+    return health->load;
+}
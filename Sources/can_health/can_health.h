@@ -0,0 +1,67 @@
+#ifndef _can_health_h_
+#define _can_health_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CAN_HEALTH_WARNING_LEVEL                (96U)       /** TEC/REC 警告門檻 */
+#define CAN_HEALTH_BACKOFF_MIN                  (5U)        /** bus-off 最短退避時間 (10 ms) */
+#define CAN_HEALTH_BACKOFF_MAX                  (160U)      /** bus-off 最長退避時間 (10 ms) */
+#define CAN_HEALTH_RECOVER_TIMEOUT              (20U)       /** 恢復等待時間 (10 ms) */
+#define CAN_HEALTH_STABLE_TIME                  (500U)      /** 穩定多久後重置退避時間 (10 ms) */
+#define CAN_HEALTH_LOAD_WINDOW                  (100U)      /** 負載統計區間 (10 ms) */
+
+typedef enum can_health_state
+{
+    CAN_HEALTH_ACTIVE = 0,          /** error active */
+    CAN_HEALTH_WARNING,             /** error active，但 TEC/REC 已達警告門檻 */
+    CAN_HEALTH_PASSIVE,             /** error passive */
+    CAN_HEALTH_BUS_OFF,             /** bus-off，等待退避時間 */
+    CAN_HEALTH_RECOVERING,          /** 已請求恢復，等待控制器回到 error active */
+    CAN_HEALTH_STATE_MAX,
+} can_health_state_t;
+
+typedef struct can_health_counter
+{
+    uint8_t tec;                    /** 發送錯誤計數 */
+    uint8_t rec;                    /** 接收錯誤計數 */
+    bool passive;
+    bool bus_off;
+} can_health_counter_t;
+
+typedef struct can_health_config
+{
+    const char* name;
+    void (*log)(const char* str, uint16_t size);
+    can_health_counter_t(*read)(const void* handle);
+    void (*recover)(const void* handle, bool start);
+    void (*event)(const void* handle, can_health_state_t state);
+} can_health_config_t;
+
+typedef struct can_health
+{
+    const void* handle;
+    uint32_t bitrate;               /** 匯流排速率 (bps) */
+    uint32_t bits;                  /** 統計區間內累計的位元數 */
+    uint16_t load;                  /** 匯流排負載 (0.1 %) */
+    uint16_t load_peak;             /** 匯流排負載峰值 (0.1 %) */
+    uint16_t window;
+
+    uint8_t tec;
+    uint8_t rec;
+    uint16_t bus_off_count;
+    uint16_t backoff;               /** basic = 10 ms */
+    uint16_t time_count;            /** basic = 10 ms */
+    uint16_t stable_time;           /** basic = 10 ms */
+
+    can_health_state_t state;
+    can_health_config_t* config;
+} can_health_t;
+
+void can_health_init(can_health_t* health, const void* handle, uint32_t bitrate, can_health_config_t* config);
+void can_health_task(can_health_t* health);
+void can_health_frame(can_health_t* health, bool extended, uint8_t dlc);
+can_health_state_t can_health_state(can_health_t* health);
+uint16_t can_health_load(can_health_t* health);
+
+#endif
@@ -0,0 +1,99 @@
+#include "can_signal.h"
+#include <assert.h>
+
+/**
+ * @brief 訊號初始化
+ *
+ * @param signal 訊號物件
+ * @param period 預期的更新週期 (us)，遺失 CAN_SIGNAL_MISSED_MAX 個週期後過期
+ */
+void can_signal_init(can_signal_t* signal, uint32_t period)
+{
+    assert(signal);
+    assert(period);
+
+    signal->period = period;
+    can_signal_reset(signal);
+}
+
+/**
+ * @brief 重置訊號，從現在起重新計算期限
+ *
+ * @param signal 訊號物件
+ *
+ * @note 用於發送端剛上電或剛啟用時，避免沿用之前的過期狀態
+ */
+void can_signal_reset(can_signal_t* signal)
+{
+    assert(signal);
+
+    signal->time = timebase_now();
+    signal->state = CAN_SIGNAL_NONE;
+}
+
+/**
+ * @brief 收到訊號，在解碼後調用
+ *
+ * @param signal 訊號物件
+ * @param valid 內容是否有效
+ */
+void can_signal_update(can_signal_t* signal, bool valid)
+{
+    assert(signal);
+
+    signal->time = timebase_now();
+    signal->state = valid ? CAN_SIGNAL_VALID : CAN_SIGNAL_INVALID;
+}
+
+/**
+ * @brief 訊號狀態，讀取時才檢查期限
+ *
+ * @param signal 訊號物件
+ *
+ * @return can_signal_state_t
+ *
+ * @note 重置後一直沒有收到的訊號，超過期限後同樣視為過期
+ */
+can_signal_state_t can_signal_state(can_signal_t* signal)
+{
+    assert(signal);
+
+    if ((signal->state != CAN_SIGNAL_STALE) &&
+        ((timebase_now() - signal->time) > ((uint64_t)signal->period * CAN_SIGNAL_MISSED_MAX)))
+    {
+        signal->state = CAN_SIGNAL_STALE;
+    }
+
+    return signal->state;
+}
+
+/**
+ * @brief 訊號是否可用
+ *
+ * @param signal 訊號物件
+ *
+ * @return true 在期限內且內容有效
+ * @return false 尚未收到、無效或過期
+ */
+bool can_signal_valid(can_signal_t* signal)
+{
+    return (can_signal_state(signal) == CAN_SIGNAL_VALID);
+}
+
+/**
+ * @brief 訊號距離最後更新的時間
+ *
+ * @param signal 訊號物件
+ *
+ * @return uint32_t 經過時間 (us)，超過範圍時回傳 UINT32_MAX
+ */
+uint32_t can_signal_age(can_signal_t* signal)
+{
+    uint64_t age;
+
+    assert(signal);
+
+    age = timebase_now() - signal->time;
+
+    return (age > UINT32_MAX) ? UINT32_MAX : (uint32_t)age;
+}
@@ -0,0 +1,32 @@
+#ifndef _can_signal_h_
+#define _can_signal_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timebase.h"
+
+#define CAN_SIGNAL_MISSED_MAX                   (3U)        /** 連續遺失幾個週期視為過期 */
+
+typedef enum can_signal_state
+{
+    CAN_SIGNAL_NONE = 0,            /** 重置後尚未收到 */
+    CAN_SIGNAL_VALID,               /** 在期限內收到有效值 */
+    CAN_SIGNAL_INVALID,             /** 收到但內容無效(發送端標示不可用或超出範圍) */
+    CAN_SIGNAL_STALE,               /** 超過期限沒有更新 */
+} can_signal_state_t;
+
+typedef struct can_signal
+{
+    uint64_t time;                  /** 最後更新時間 (us) */
+    uint32_t period;                /** 預期的更新週期 (us) */
+    can_signal_state_t state;
+} can_signal_t;
+
+void can_signal_init(can_signal_t* signal, uint32_t period);
+void can_signal_reset(can_signal_t* signal);
+void can_signal_update(can_signal_t* signal, bool valid);
+can_signal_state_t can_signal_state(can_signal_t* signal);
+bool can_signal_valid(can_signal_t* signal);
+uint32_t can_signal_age(can_signal_t* signal);
+
+#endif
@@ -3,30 +3,49 @@
 
 /*--------------------------------------------------------------------------------------------------------*/
 
-#define PA6_OUT(n)                              PINS_DRV_WritePin(PTA, 6, n)    // 10A_RELAY(K17)    
-#define PA8_OUT(n)                              PINS_DRV_WritePin(PTA, 8, n)    // 10A_RELAY        // ERR 被接去 GND 
-#define PA9_OUT(n)                              PINS_DRV_WritePin(PTA, 9, n)    // 10A_RELAY(K3)    
-#define PA17_OUT(n)                             PINS_DRV_WritePin(PTA, 17, n)   // 30A_RELAY(K8)    
-#define PB5_OUT(n)                              PINS_DRV_WritePin(PTB, 5, n)    // 10A_RELAY(K21)    
-#define PC1_OUT(n)                              PINS_DRV_WritePin(PTC, 1, n)    // 10A_RELAY(K7)    
-#define PC2_OUT(n)                              PINS_DRV_WritePin(PTC, 2, n)    // SYSTEM LED
-#define PC3_OUT(n)                              PINS_DRV_WritePin(PTC, 3, n)    // 10A_RELAY(K1)    
-#define PD6_OUT(n)                              PINS_DRV_WritePin(PTD, 6, n)    // 光耦合 out 5v(U10A)              
-#define PD11_OUT(n)                             PINS_DRV_WritePin(PTD, 11, n)   // 10A_RELAY(K4)    // ERR 
-#define PD12_OUT(n)                             PINS_DRV_WritePin(PTD, 12, n)   // 10A_RELAY(K5)    // ERR 有燈無動作
-#define PD13_OUT(n)                             PINS_DRV_WritePin(PTD, 13, n)   // 10A_RELAY(K19)
-#define PD14_OUT(n)                             PINS_DRV_WritePin(PTD, 14, n)   // 10A_RELAY(K20)
-#define PD16_OUT(n)                             PINS_DRV_WritePin(PTD, 16, n)   // 10A_RELAY(K13)
-#define PD17_OUT(n)                             PINS_DRV_WritePin(PTD, 17, n)   // 10A_RELAY(K12)
-#define PE0_OUT(n)                              PINS_DRV_WritePin(PTE, 0, n)    // 10A_RELAY(K2)
-#define PE1_OUT(n)                              PINS_DRV_WritePin(PTE, 1, n)    // 10A_RELAY (K10)
-#define PE2_OUT(n)                              PINS_DRV_WritePin(PTE, 2, n)    // 10A_RELAY(K15) 
-#define PE3_OUT(n)                              PINS_DRV_WritePin(PTE, 3, n)    // 外部電 MOS(Q11)  // OC MOS 待測
-#define PE7_OUT(n)                              PINS_DRV_WritePin(PTE, 7, n)    // 30A_RELAY(K16)
-#define PE9_OUT(n)                              PINS_DRV_WritePin(PTE, 9, n)    // 10A_RELAY(K23)
-#define PE12_OUT(n)                             PINS_DRV_WritePin(PTE, 12, n)   // 10A_RELAY(K9) 
-#define PE13_OUT(n)                             PINS_DRV_WritePin(PTE, 13, n)   // 10A_RELAY(K11) 
-#define PE14_OUT(n)                             PINS_DRV_WritePin(PTE, 14, n)   // 10A_RELAY(K22) 
+#define PA6_OUT(n)                              app_output_write(OUTPUT_PTA, 6, (n))    // 10A_RELAY(K17)    
+#define PA8_OUT(n)                              app_output_write(OUTPUT_PTA, 8, (n))    // 10A_RELAY        // ERR 被接去 GND 
+#define PA9_OUT(n)                              app_output_write(OUTPUT_PTA, 9, (n))    // 10A_RELAY(K3)    
+#define PA17_OUT(n)                             app_output_write(OUTPUT_PTA, 17, (n))   // 30A_RELAY(K8)    
+#define PB5_OUT(n)                              app_output_write(OUTPUT_PTB, 5, (n))    // 10A_RELAY(K21)    
+#define PC1_OUT(n)                              app_output_write(OUTPUT_PTC, 1, (n))    // 10A_RELAY(K7)    
+#define PC2_OUT(n)                              app_output_write(OUTPUT_PTC, 2, (n))    // SYSTEM LED
+#define PC3_OUT(n)                              app_output_write(OUTPUT_PTC, 3, (n))    // 10A_RELAY(K1)    
+#define PD6_OUT(n)                              app_output_write(OUTPUT_PTD, 6, (n))    // 光耦合 out 5v(U10A)              
+#define PD11_OUT(n)                             app_output_write(OUTPUT_PTD, 11, (n))   // 10A_RELAY(K4)    // ERR 
+#define PD12_OUT(n)                             app_output_write(OUTPUT_PTD, 12, (n))   // 10A_RELAY(K5)    // ERR 有燈無動作
+#define PD13_OUT(n)                             app_output_write(OUTPUT_PTD, 13, (n))   // 10A_RELAY(K19)
+#define PD14_OUT(n)                             app_output_write(OUTPUT_PTD, 14, (n))   // 10A_RELAY(K20)
+#define PD16_OUT(n)                             app_output_write(OUTPUT_PTD, 16, (n))   // 10A_RELAY(K13)
+#define PD17_OUT(n)                             app_output_write(OUTPUT_PTD, 17, (n))   // 10A_RELAY(K12)
+#define PE0_OUT(n)                              app_output_write(OUTPUT_PTE, 0, (n))    // 10A_RELAY(K2)
+#define PE1_OUT(n)                              app_output_write(OUTPUT_PTE, 1, (n))    // 10A_RELAY (K10)
+#define PE2_OUT(n)                              app_output_write(OUTPUT_PTE, 2, (n))    // 10A_RELAY(K15) 
+#define PE3_OUT(n)                              app_output_write(OUTPUT_PTE, 3, (n))    // 外部電 MOS(Q11)  // OC MOS 待測
+#define PE7_OUT(n)                              app_output_write(OUTPUT_PTE, 7, (n))    // 30A_RELAY(K16)
+#define PE9_OUT(n)                              app_output_write(OUTPUT_PTE, 9, (n))    // 10A_RELAY(K23)
+#define PE12_OUT(n)                             app_output_write(OUTPUT_PTE, 12, (n))   // 10A_RELAY(K9) 
+#define PE13_OUT(n)                             app_output_write(OUTPUT_PTE, 13, (n))   // 10A_RELAY(K11) 
+#define PE14_OUT(n)                             app_output_write(OUTPUT_PTE, 14, (n))   // 10A_RELAY(K22) 
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* 中斷內立即輸出，主迴圈影像寫入相同電位後解除 */
+#define PB5_FORCE(n)                            app_output_force(OUTPUT_PTB, 5, (n))    // 10A_RELAY(K21)
+#define PC1_FORCE(n)                            app_output_force(OUTPUT_PTC, 1, (n))    // 10A_RELAY(K7)
+#define PD12_FORCE(n)                           app_output_force(OUTPUT_PTD, 12, (n))   // 10A_RELAY(K5)
+#define PD14_FORCE(n)                           app_output_force(OUTPUT_PTD, 14, (n))   // 10A_RELAY(K20)
+
+/* 中斷內立即輸出並閂鎖，只有 RELEASE 解除 (保護動作) */
+#define PB5_LOCK(n)                             app_output_lock(OUTPUT_PTB, 5, (n))     // 10A_RELAY(K21)
+#define PC1_LOCK(n)                             app_output_lock(OUTPUT_PTC, 1, (n))     // 10A_RELAY(K7)
+#define PD12_LOCK(n)                            app_output_lock(OUTPUT_PTD, 12, (n))    // 10A_RELAY(K5)
+#define PD14_LOCK(n)                            app_output_lock(OUTPUT_PTD, 14, (n))    // 10A_RELAY(K20)
+
+#define PB5_RELEASE()                           app_output_release(OUTPUT_PTB, 5)
+#define PC1_RELEASE()                           app_output_release(OUTPUT_PTC, 1)
+#define PD12_RELEASE()                          app_output_release(OUTPUT_PTD, 12)
+#define PD14_RELEASE()                          app_output_release(OUTPUT_PTD, 14)
 
 /*--------------------------------------------------------------------------------------------------------*/
 
@@ -63,22 +82,34 @@
 #define KEY_1()                                 PC12_IN()
 #define KEY_2()                                 PC13_IN()
 
-#define LIGHT_TOWER(g, y, r, bz)                PE12_OUT(!g);    \
-                                                PA9_OUT(!y);     \
-                                                PD16_OUT(!r);    \
-                                                PD17_OUT(!bz)
+#define LIGHT_TOWER(g, y, r, bz)                PE12_OUT(!(g));  \
+                                                PA9_OUT(!(y));   \
+                                                PD16_OUT(!(r));  \
+                                                PD17_OUT(!(bz))
 
 #define FC_TYT60KW_HIGH_POWER_RELAY(n)          PB5_OUT(!n)      
+#define FC_TYT60KW_HIGH_POWER_RELAY_FORCE(n)    PB5_FORCE(!(n))
+#define FC_TYT60KW_HIGH_POWER_RELAY_LOCK(n)     PB5_LOCK(!(n))
+#define FC_TYT60KW_HIGH_POWER_RELAY_RELEASE()   PB5_RELEASE()
 #define FC_TYT60KW_HOST_POWER(n)                PD13_OUT(!n)
 #define FC_TYT60KW_POWER(n)                     PE0_OUT(!n)
 #define FC_TYT60KW_IGN(n)                       PD14_OUT(!n)
+#define FC_TYT60KW_IGN_FORCE(n)                 PD14_FORCE(!(n))
+#define FC_TYT60KW_IGN_LOCK(n)                  PD14_LOCK(!(n))
+#define FC_TYT60KW_IGN_RELEASE()                PD14_RELEASE()
 #define FC_TYT60KW_FAN_H(ps)                    PE10_PWM(ps);   \
                                                 PE11_PWM(ps)
 #define FC_TYT60KW_FAN_L(ps)                    PD15_PWM(ps)
 
 #define FC_135KW_HIGH_POWER_RELAY(n)            PC1_OUT(!n)
+#define FC_135KW_HIGH_POWER_RELAY_FORCE(n)      PC1_FORCE(!(n))
+#define FC_135KW_HIGH_POWER_RELAY_LOCK(n)       PC1_LOCK(!(n))
+#define FC_135KW_HIGH_POWER_RELAY_RELEASE()     PC1_RELEASE()
 #define FC_135KW_HOST_POWER(n)                  PE9_OUT(!n)
 #define FC_135KW_POWER(n)                       PE1_OUT(!n)
 #define FC_135KW_IGN(n)                         PD12_OUT(!n)
+#define FC_135KW_IGN_FORCE(n)                   PD12_FORCE(!(n))
+#define FC_135KW_IGN_LOCK(n)                    PD12_LOCK(!(n))
+#define FC_135KW_IGN_RELEASE()                  PD12_RELEASE()
 
 #endif
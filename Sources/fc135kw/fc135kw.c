@@ -1,10 +1,29 @@
 #include "fc135kw.h"
+#include "ramfunc.h"
+#include "host_codec.h"
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 typedef void (*fc_fun_t)(fc135kw_t* fc);
 
+enum
+{
+    TX_SET_STATUS = 0,
+    TX_DRAIN_VALVE,
+    TX_REMOVE_BUBBLE,
+};
+
+/* 各訊號預期的更新週期 (us)，狀態與氫氣壓力 100 ms，水溫與錯誤 500 ms */
+static const uint32_t signal_period[FC135KW_SIGNAL_MAX] =
+{
+    [FC135KW_SIGNAL_STATUS] = TIMEBASE_MS(100),
+    [FC135KW_SIGNAL_H2] = TIMEBASE_MS(100),
+    [FC135KW_SIGNAL_WATER] = TIMEBASE_MS(500),
+    [FC135KW_SIGNAL_ERROR] = TIMEBASE_MS(500),
+};
+
 static void init(fc135kw_t* fc);
 static void idle(fc135kw_t* fc);
 static void precharge(fc135kw_t* fc);
@@ -12,6 +31,10 @@ static void running(fc135kw_t* fc);
 static void shutdown(fc135kw_t* fc);
 static void error(fc135kw_t* fc);
 static void deinit(fc135kw_t* fc);
+static void purge(fc135kw_t* fc);
+static uint16_t eta(fc135kw_t* fc);
+static void host_timeout(void* arg);
+static can_codec_frame_t* tx_update(fc135kw_t* fc, fc135kw_command_t type);
 
 /**
  * @brief logger
@@ -78,14 +101,43 @@ static void start(fc135kw_t* fc, bool enable, bool deinit)
  */
 void fc135kw_init(fc135kw_t* fc, fc135kw_config_t* config)
 {
+    uint8_t i;
+
     assert(fc);
     assert(config);
 
     fc->config = config;
     fc->flag.all = 0;
     fc->power_setup = 0;
+    fc->trip = false;
+    fc->purge.charge = 0;
+    fc->purge.tick = 0;
+    fc->purge.h2_last = 0;
+    fc->purge.h2_trend = 0;
+    fc->purge.period = 0;
+    fc->purge.open_time = 0;
+    memset(&fc->tx, 0, sizeof(fc135kw_tx_t));
+
+    for (i = 0; i < FC135KW_TX_MAX; i++)
+    {
+        fc->tx.frame[i].dirty = true;
+    }
+
+    fc->warmup.elapsed = 0;
+    fc->warmup.stall = 0;
+    fc->warmup.rate = FC135KW_WARMUP_RATE;
+    fc->warmup.eta = FC135KW_WARMUP_UNKNOWN;
+    memset(&fc->fault, 0, sizeof(fc135kw_fault_list_t));
     fc->status = FC135KW_INIT;
     fc->status_old = FC135KW_STATUS_MAX;
+
+    for (i = 0; i < FC135KW_SIGNAL_MAX; i++)
+    {
+        can_signal_init(&fc->signal[i], signal_period[i]);
+    }
+
+    deadline_set(&fc->update_timeout, FC135KW_UPDATE_TIMEOUT);
+    timebase_timer_start(&fc->host_timer, FC135KW_HOST_TIMEOUT, 0, host_timeout, fc);
 }
 
 /**
@@ -122,7 +174,8 @@ fc135kw_status_t fc135kw_status(fc135kw_t* fc)
  *
  * @param fc fuel cell 物件
  *
- * @note 內建時間計數器，需以 10ms 間隔時間調用
+ * @note 內建時間計數器，需以 10ms 間隔時間調用；
+ *       通訊逾時由 timebase 計算，與調用間隔無關
  */
 void fc135kw_task(fc135kw_t* fc)
 {
@@ -137,9 +190,21 @@ void fc135kw_task(fc135kw_t* fc)
         [FC135KW_DEINIT] = deinit,
     };
 
+    uint8_t i;
+
     assert(fc);
 
+    if (fc->trip && (fc->status != FC135KW_ERROR))
+    {
+        /* 快速路徑已先關閉 IGN，狀態機跟上 */
+        fc135kw_start(fc, false);
+        fc->flag.bits.ign_key = 0;
+        fc->status = FC135KW_ERROR;
+        logger(fc, "fast path trip\r\n");
+    }
+
     fc_function[fc->status](fc);
+    purge(fc);
 
     if (fc->config->light_tower)
     {
@@ -153,26 +218,20 @@ void fc135kw_task(fc135kw_t* fc)
 
     if (fc->status > FC135KW_INIT)
     {
-        if (fc->update_timeout < 200)
+        if (deadline_expired(&fc->update_timeout))
         {
-            if (++fc->update_timeout >= 200)
-            {
-                fc135kw_error_stop(fc);
-                logger(fc, "data update timeout\r\n");
-            }
+            deadline_stop(&fc->update_timeout);
+            fc135kw_error_stop(fc);
+            logger(fc, "data update timeout\r\n");
         }
     }
     else
     {
-        fc->update_timeout = 0;
-    }
+        deadline_set(&fc->update_timeout, FC135KW_UPDATE_TIMEOUT);
 
-    if (fc->host_timeout < 200)
-    {
-        if (++fc->host_timeout >= 200)
+        for (i = 0; i < FC135KW_SIGNAL_MAX; i++)
         {
-            fc135kw_error_stop(fc);
-            logger(fc, "host connect timeout\r\n");
+            can_signal_reset(&fc->signal[i]);
         }
     }
 
@@ -199,6 +258,21 @@ void fc135kw_start(fc135kw_t* fc, bool enable)
     }
 }
 
+/**
+ * @brief fuel cell 熱待機設定
+ *
+ * @param fc fuel cell 物件
+ * @param enable true: 停止運行後維持上電與點火並回到 IDLE，false: 停止後斷電重新初始化
+ *
+ * @note deinit 時一律斷電
+ */
+void fc135kw_standby(fc135kw_t* fc, bool enable)
+{
+    assert(fc);
+
+    fc->flag.bits.standby = enable;
+}
+
 /**
  * @brief fuel cell 清除錯誤
  *
@@ -224,9 +298,11 @@ void fc135kw_error_stop(fc135kw_t* fc)
 {
     assert(fc);
 
+    /* 已在 error 時同樣要停止，避免清除錯誤後自行重新啟動 */
+    fc135kw_start(fc, false);
+
     if (fc->status != FC135KW_ERROR)
     {
-        fc135kw_start(fc, false);
         fc->status = FC135KW_ERROR;
         logger(fc, "other error stop\r\n");
     }
@@ -248,6 +324,18 @@ void fc135kw_emerg_stop(fc135kw_t* fc)
     }
 }
 
+/**
+ * @brief fuel cell 快速路徑觸發，功率設定立即歸零，由 fc135kw_task() 進入錯誤狀態
+ *
+ * @param fc fuel cell 物件
+ *
+ * @note 可在接收中斷內調用，只設定旗標
+ */
+void fc135kw_trip(fc135kw_t* fc)
+{
+    fc->trip = true;
+}
+
 void fc135kw_remove_bubble(fc135kw_t* fc, bool enable)
 {
     assert(fc);
@@ -258,6 +346,36 @@ void fc135kw_remove_bubble(fc135kw_t* fc, bool enable)
     }
 }
 
+/**
+ * @brief 手動排水 (診斷用)
+ *
+ * @param fc fuel cell 物件
+ * @param manual true: 手動模式，false: 回到自動排程
+ * @param open 手動模式下排水閥開啟
+ *
+ * @note 變更後由 fc135kw_purge_pending() 立即發送
+ */
+void fc135kw_purge(fc135kw_t* fc, bool manual, bool open)
+{
+    assert(fc);
+
+    fc->flag.bits.purge_manual = manual;
+    fc->flag.bits.purge_open = manual && open;
+}
+
+/**
+ * @brief 主機連線逾時 (timebase_task() 內調用)
+ *
+ * @param arg fuel cell 物件
+ */
+static void host_timeout(void* arg)
+{
+    fc135kw_t* fc = (fc135kw_t*)arg;
+
+    fc135kw_error_stop(fc);
+    logger(fc, "host connect timeout\r\n");
+}
+
 /**
  * @brief fuel cell 主機連接
  *
@@ -267,7 +385,7 @@ void fc135kw_host_connect(fc135kw_t* fc)
 {
     assert(fc);
 
-    fc->host_timeout = 0;
+    timebase_timer_start(&fc->host_timer, FC135KW_HOST_TIMEOUT, 0, host_timeout, fc);
 }
 
 /**
@@ -281,20 +399,20 @@ void fc135kw_host_packet(fc135kw_t* fc, uint8_t data[8])
     assert(fc);
     assert(data);
 
-    fc135kw_data_t* packet = (fc135kw_data_t*)data;
-
-    packet->bytes[0] = fc->status;
-    packet->bytes[1] = fc->error;
-    packet->bits[2].b0 = fc->flag.bits.start;
-    packet->bytes[3] = (uint8_t)(fc->power_setup / 100);
-    packet->bytes[4] = 0x00;
-    packet->bytes[5] = 0x00;
-    packet->bytes[6] = 0x00;
+    host_fc135kw_status_t packet =
+    {
+        .status = fc->status,
+        .error_level = fc->error,
+        .start = fc->flag.bits.start,
+        .power_setup = (uint8_t)(fc->power_setup / 100),
+        .warmup_time = fc135kw_warmup_eta(fc),
+        .light_green = fc->light_tower.lg,
+        .light_yellow = fc->light_tower.ly,
+        .light_red = fc->light_tower.lr,
+        .buzzer = fc->light_tower.bz,
+    };
 
-    packet->bits[7].b0 = fc->light_tower.lg;
-    packet->bits[7].b1 = fc->light_tower.ly;
-    packet->bits[7].b2 = fc->light_tower.lr;
-    packet->bits[7].b3 = fc->light_tower.bz;
+    host_fc135kw_status_pack(&packet, data);
 }
 
 /**
@@ -303,45 +421,62 @@ void fc135kw_host_packet(fc135kw_t* fc, uint8_t data[8])
  * @param fc fuel cell 物件
  * @param type 指令類型
  * @param data 指令內容
+ *
+ * @note 內容未變更時直接複製上次編碼的結果，發送端可保留同一個緩衝週期發送
  */
 void fc135kw_command(fc135kw_t* fc, fc135kw_command_t type, uint8_t data[8])
 {
+    can_codec_frame_t* frame;
+
     assert(fc);
     assert(data);
 
-    fc135kw_data_t* command = (fc135kw_data_t*)data;
+    frame = tx_update(fc, type);
 
-    switch (type)
+    if (!frame)
     {
-        case FC135KW_SET_STATUS:
-        {
-            command->bits[0].b2 = fc->flag.bits.power_on_sig;
-            command->bits[0].b4 = fc->flag.bits.emerg_stop;
-            command->bits[0].b5 = fc->flag.bits.start;
+        return;
+    }
 
-            if (fc->status == FC135KW_PRECHARGE)
-            {
-                fc->power_setup = 2000;
-            }
+    frame->dirty = false;
+    can_codec_copy(data, frame->data);
+}
 
-            command->bytes[1] = fc->power_setup & 0xFFU;
-            command->bytes[2] = ((fc->power_setup >> 8) & 0xFFU);
-            break;
-        }
-        case FC135KW_DRAIN_VALVE:
-        {
-            command->lbyte[0] = 0;
-            command->lbyte[1] = 0;
-            break;
-        }
-        case FC135KW_REMOVE_BUBBLE:
-        {
-            command->lbyte[0] = 0;
-            command->lbyte[1] = 0;
-            command->bits[0].b6 = fc->flag.bits.remove_bubble;
-            break;
-        }
-        default: { break; }
+/**
+ * @brief 排水排程是否變更
+ *
+ * @param fc fuel cell 物件
+ *
+ * @return true 需要發送 FC135KW_DRAIN_VALVE，發送後清除
+ * @return false 排程未變更
+ */
+bool fc135kw_purge_pending(fc135kw_t* fc)
+{
+    assert(fc);
+
+    return tx_update(fc, FC135KW_DRAIN_VALVE)->dirty;
+}
+
+/**
+ * @brief 預估到達目標水溫的時間
+ *
+ * @param fc fuel cell 物件
+ *
+ * @return uint16_t 秒，FC135KW_WARMUP_UNKNOWN: 無法預估
+ *
+ * @note 預充中使用本次的升溫速率，待機時以上次啟動學到的速率預估，
+ *       供主機在預定啟動前安排預熱
+ */
+uint16_t fc135kw_warmup_eta(fc135kw_t* fc)
+{
+    assert(fc);
+
+    switch (fc->status)
+    {
+        case FC135KW_PRECHARGE: { return fc->warmup.eta; }
+        case FC135KW_RUNNING: { return 0; }
+        case FC135KW_IDLE: { return eta(fc); }
+        default: { return FC135KW_WARMUP_UNKNOWN; }
     }
 }
 
@@ -352,45 +487,155 @@ void fc135kw_command(fc135kw_t* fc, fc135kw_command_t type, uint8_t data[8])
  * @param type 資料類型
  * @param data 資料內容
  */
-void fc135kw_update(fc135kw_t* fc, fc135kw_update_t type, uint8_t data[8])
+RAMFUNC void fc135kw_update(fc135kw_t* fc, fc135kw_update_t type, uint8_t data[8])
 {
+    union
+    {
+        fc135kw_sys_status_t status;
+        fc135kw_sys_h2_t h2;
+        fc135kw_sys_water_t water;
+        fc135kw_sys_error_t error;
+    } d;
+
     assert(fc);
     assert(data);
 
-    fc135kw_data_t* d = (fc135kw_data_t*)data;
-
     switch (type)
     {
         case FC135KW_SYS_STATUS:
         {
-            if (fc->system_status != d->bytes[0])
+            fc135kw_sys_status_unpack(&d.status, data);
+
+            if (fc->system_status != d.status.system_status)
             {
-                fc->system_status = d->bytes[0];
+                fc->system_status = d.status.system_status;
                 logger(fc, "system status = %d\r\n", fc->system_status);
             }
+
+            can_signal_update(&fc->signal[FC135KW_SIGNAL_STATUS], true);
             break;
         }
         case FC135KW_SYS_H2:
         {
-            fc->H2_pressure = (d->wbyte[0] / 10);
-            fc->H2_src_pressure = (d->wbyte[3] / 10);
+            fc135kw_sys_h2_unpack(&d.h2, data);
+            fc->H2_pressure = (d.h2.h2_pressure / 10);
+            fc->H2_src_pressure = (d.h2.h2_src_pressure / 10);
+            can_signal_update(&fc->signal[FC135KW_SIGNAL_H2], true);
             break;
         }
         case FC135KW_SYS_WATER:
         {
-            fc->water_temp = ((int8_t)d->bytes[4] - 40);
-            fc->water_temp_target = ((int8_t)d->bytes[6] - 40);
+            fc135kw_sys_water_unpack(&d.water, data);
+            fc->water_temp = (int8_t)(d.water.water_temp - 40);
+            fc->water_temp_target = (int8_t)(d.water.water_temp_target - 40);
+            can_signal_update(&fc->signal[FC135KW_SIGNAL_WATER], true);
             break;
         }
         case FC135KW_SYS_ERROR:
         {
-            fc->error = d->bytes[0];
-            fc->error_code = (((uint16_t)d->bytes[2] << 8) | d->bytes[1]);
+            fc135kw_sys_error_unpack(&d.error, data);
+            fc->error = d.error.error_level;
+            fc->error_code = d.error.error_code;
+            can_signal_update(&fc->signal[FC135KW_SIGNAL_ERROR], true);
+            break;
+        }
+        case FC135KW_SYS_DM1:
+        {
+            /* 0 或 1 個故障碼時不經 TP，與多封包使用同一個解析 */
+            fc135kw_message(fc, FC135KW_PGN_DM1, data, 8);
             break;
         }
     }
 
-    fc->update_timeout = 0;
+    deadline_set(&fc->update_timeout, FC135KW_UPDATE_TIMEOUT);
+}
+
+/**
+ * @brief fuel cell 多封包訊息 (J1939 TP 重組完成，單封包的 DM1 也由此解析)
+ *
+ * @param fc fuel cell 物件
+ * @param pgn 訊息的 PGN
+ * @param data 資料
+ * @param size 長度
+ *
+ * @note DM1 故障清單保存前 FC135KW_DTC_MAX 個故障碼，新出現的故障碼記錄 log；其他 PGN 只記錄長度
+ */
+void fc135kw_message(fc135kw_t* fc, uint32_t pgn, const uint8_t* data, uint16_t size)
+{
+    uint32_t dtc[FC135KW_DTC_MAX];
+    uint32_t value;
+    uint16_t k;
+    uint8_t count;
+    uint8_t i;
+    uint8_t j;
+
+    assert(fc);
+    assert(data);
+
+    if (pgn != FC135KW_PGN_DM1)
+    {
+        logger(fc, "message pgn 0x%05lX, %d bytes\r\n", (unsigned long)pgn, size);
+        return;
+    }
+
+    if (size < 2)
+    {
+        return;
+    }
+
+    count = 0;
+    i = 0;
+
+    for (k = 0; k < ((size - 2) / 4); k++)
+    {
+        value = (uint32_t)data[2 + (k * 4)]
+            | ((uint32_t)data[3 + (k * 4)] << 8)
+            | ((uint32_t)data[4 + (k * 4)] << 16)
+            | ((uint32_t)data[5 + (k * 4)] << 24);
+
+        /* SPN 0 為「無故障」的填充 (單封包 DM1 沒有故障碼時) */
+        if (FC135KW_DTC_SPN(value) == 0)
+        {
+            continue;
+        }
+
+        count++;
+
+        if (i >= FC135KW_DTC_MAX)
+        {
+            continue;
+        }
+
+        dtc[i] = value;
+
+        /* SPN + FMI 相同 (bit 0 ~ 23) 視為同一個故障，只有發生次數變化不記錄 */
+        for (j = 0; (j < fc->fault.count) && (j < FC135KW_DTC_MAX); j++)
+        {
+            if ((fc->fault.dtc[j] & 0x00FFFFFFUL) == (dtc[i] & 0x00FFFFFFUL))
+            {
+                break;
+            }
+        }
+
+        if ((j == fc->fault.count) || (j == FC135KW_DTC_MAX))
+        {
+            logger(fc, "dtc spn %lu fmi %d oc %d\r\n", (unsigned long)FC135KW_DTC_SPN(dtc[i]),
+                FC135KW_DTC_FMI(dtc[i]), FC135KW_DTC_OC(dtc[i]));
+        }
+
+        i++;
+    }
+
+    memcpy(&fc->fault.dtc[0], &dtc[0], i * sizeof(uint32_t));
+    memset(&fc->fault.dtc[i], 0, (FC135KW_DTC_MAX - i) * sizeof(uint32_t));
+
+    if (fc->fault.count != count)
+    {
+        logger(fc, "fault list %d\r\n", count);
+    }
+
+    fc->fault.lamp = data[0];
+    fc->fault.count = count;
 }
 
 /**
@@ -417,6 +662,26 @@ void fc135kw_power(fc135kw_t* fc, uint16_t power_kw)
     }
 }
 
+/**
+ * @brief fuel cell 通訊異常通知
+ *
+ * @param fc fuel cell 物件
+ * @param fault true:匯流排異常(error passive/bus-off), false:恢復正常
+ *
+ * @note 異常期間發送的功率會限制在 FC135KW_DERATE_POWER，
+ *       在 update_timeout 觸發前先行降載
+ */
+void fc135kw_bus_fault(fc135kw_t* fc, bool fault)
+{
+    assert(fc);
+
+    if (fc->flag.bits.bus_fault != fault)
+    {
+        fc->flag.bits.bus_fault = fault;
+        logger(fc, "bus %s\r\n", fault ? "fault, derate" : "recovered");
+    }
+}
+
 /*--------------------------------------------------------------------------------------------------------*/
 
 /**
@@ -442,6 +707,17 @@ static bool ems(fc135kw_t* fc)
 
     if (fc->status == FC135KW_RUNNING)
     {
+        /* 氣源壓力停止更新時，不能沿用舊值判斷 */
+        if (!can_signal_valid(&fc->signal[FC135KW_SIGNAL_H2]))
+        {
+            fc->status = FC135KW_ERROR;
+            fc135kw_error_stop(fc);
+            logger(fc, "H2 signal lost, age: %d ms\r\n",
+                (int)(can_signal_age(&fc->signal[FC135KW_SIGNAL_H2]) / 1000U));
+
+            return true;
+        }
+
         /* 檢查氣源壓力 */
         if ((fc->H2_src_pressure < 600) ||
             (fc->H2_src_pressure >= 1000))
@@ -458,6 +734,266 @@ static bool ems(fc135kw_t* fc)
     return false;
 }
 
+/**
+ * @brief 依目前狀態更新發送內容，欄位有變化才重新編碼並標記 dirty
+ *
+ * @param fc fuel cell 物件
+ * @param type 指令類型
+ *
+ * @return can_codec_frame_t* 該指令的發送幀，NULL: 不支援的指令
+ */
+static can_codec_frame_t* tx_update(fc135kw_t* fc, fc135kw_command_t type)
+{
+    fc135kw_tx_t* tx = &fc->tx;
+    can_codec_frame_t* frame;
+    uint16_t power;
+
+    switch (type)
+    {
+        case FC135KW_SET_STATUS:
+        {
+            frame = &tx->frame[TX_SET_STATUS];
+
+            if (fc->status == FC135KW_PRECHARGE)
+            {
+                fc->power_setup = 2000;
+            }
+
+            power = fc->power_setup;
+
+            if (fc->flag.bits.bus_fault && (power > FC135KW_DERATE_POWER))
+            {
+                /* 通訊異常時先降載，不改變主機的設定值 */
+                power = FC135KW_DERATE_POWER;
+            }
+
+            if (fc->trip)
+            {
+                power = 0;
+            }
+
+            if (frame->dirty ||
+                (tx->set_status.power_on_sig != fc->flag.bits.power_on_sig) ||
+                (tx->set_status.emerg_stop != fc->flag.bits.emerg_stop) ||
+                (tx->set_status.start != fc->flag.bits.start) ||
+                (tx->set_status.power_setup != power))
+            {
+                tx->set_status.power_on_sig = fc->flag.bits.power_on_sig;
+                tx->set_status.emerg_stop = fc->flag.bits.emerg_stop;
+                tx->set_status.start = fc->flag.bits.start;
+                tx->set_status.power_setup = power;
+                fc135kw_set_status_pack(&tx->set_status, frame->data);
+                frame->dirty = true;
+            }
+            break;
+        }
+        case FC135KW_DRAIN_VALVE:
+        {
+            frame = &tx->frame[TX_DRAIN_VALVE];
+
+            if (frame->dirty ||
+                (tx->drain_valve.drain_valve_mc != fc->flag.bits.purge_manual) ||
+                (tx->drain_valve.drain_valve_switch != fc->flag.bits.purge_open) ||
+                (tx->drain_valve.drain_valve_period_set != fc->purge.period) ||
+                (tx->drain_valve.drain_valve_open_time_set != fc->purge.open_time))
+            {
+                /* 平時為自動模式，由控制器依設定的周期排水；手動模式由診斷直接開關 */
+                tx->drain_valve.drain_valve_mc = fc->flag.bits.purge_manual;
+                tx->drain_valve.drain_valve_switch = fc->flag.bits.purge_open;
+                tx->drain_valve.drain_valve_period_set = fc->purge.period;
+                tx->drain_valve.drain_valve_open_time_set = fc->purge.open_time;
+                fc135kw_drain_valve_pack(&tx->drain_valve, frame->data);
+                frame->dirty = true;
+            }
+            break;
+        }
+        case FC135KW_REMOVE_BUBBLE:
+        {
+            frame = &tx->frame[TX_REMOVE_BUBBLE];
+
+            if (frame->dirty || (tx->remove_bubble.remove_bubble != fc->flag.bits.remove_bubble))
+            {
+                tx->remove_bubble.remove_bubble = fc->flag.bits.remove_bubble;
+                fc135kw_remove_bubble_pack(&tx->remove_bubble, frame->data);
+                frame->dirty = true;
+            }
+            break;
+        }
+        default: { frame = NULL; break; }
+    }
+
+    return frame;
+}
+
+/**
+ * @brief 依目前水溫與升溫速率估計到達目標水溫的時間
+ *
+ * @param fc fuel cell 物件
+ *
+ * @return uint16_t 秒，FC135KW_WARMUP_UNKNOWN: 速率不足無法預估
+ */
+static uint16_t eta(fc135kw_t* fc)
+{
+    int32_t remain = (int32_t)fc->water_temp_target - fc->water_temp;
+    uint32_t time;
+
+    if (remain <= 0)
+    {
+        return 0;
+    }
+
+    if (fc->warmup.rate < FC135KW_WARMUP_STALL_RATE)
+    {
+        return FC135KW_WARMUP_UNKNOWN;
+    }
+
+    time = ((uint32_t)remain * 6000UL) / (uint32_t)fc->warmup.rate;
+
+    return (time >= FC135KW_WARMUP_UNKNOWN) ? (FC135KW_WARMUP_UNKNOWN - 1U) : (uint16_t)time;
+}
+
+/**
+ * @brief 預充升溫監控，每 FC135KW_WARMUP_SAMPLE 秒取樣水溫，以一階濾波估計升溫速率
+ *
+ * @param fc fuel cell 物件
+ *
+ * @return true 升溫停滯或超過最長時間
+ * @return false 正常
+ *
+ * @note 水溫未達目標且速率低於 FC135KW_WARMUP_STALL_RATE 持續 FC135KW_WARMUP_STALL_TIME 視為停滯；
+ *       已達目標水溫時只受 FC135KW_WARMUP_TIMEOUT 限制
+ */
+static bool warmup(fc135kw_t* fc)
+{
+    fc135kw_warmup_t* w = &fc->warmup;
+    int32_t sample;
+
+    if (fc->time_count != 1)
+    {
+        return false;
+    }
+
+    fc->time_count = 100;
+
+    if (++w->elapsed >= FC135KW_WARMUP_TIMEOUT)
+    {
+        logger(fc, "warm-up timeout, water %d/%d\r\n", fc->water_temp, fc->water_temp_target);
+        return true;
+    }
+
+    if ((w->elapsed % FC135KW_WARMUP_SAMPLE) != 0)
+    {
+        return false;
+    }
+
+    sample = ((int32_t)fc->water_temp - w->temp_last) * (6000 / (int32_t)FC135KW_WARMUP_SAMPLE);
+    w->temp_last = fc->water_temp;
+
+    if (fc->water_temp < fc->water_temp_target)
+    {
+        w->rate = (int16_t)(w->rate + ((sample - w->rate) / 4));
+        w->eta = eta(fc);
+
+        if ((w->elapsed > FC135KW_WARMUP_GRACE) && (w->rate < FC135KW_WARMUP_STALL_RATE))
+        {
+            w->stall += FC135KW_WARMUP_SAMPLE;
+        }
+        else
+        {
+            w->stall = 0;
+        }
+    }
+    else
+    {
+        w->eta = 0;
+        w->stall = 0;
+    }
+
+    if (w->stall >= FC135KW_WARMUP_STALL_TIME)
+    {
+        logger(fc, "warm-up stalled, water %d/%d\r\n", fc->water_temp, fc->water_temp_target);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief 排水排程，每個 tick 累計電量，每秒更新進氣壓力趨勢，每 FC135KW_PURGE_WINDOW 重新計算
+ *
+ * @param fc fuel cell 物件
+ *
+ * @note 周期 = FC135KW_PURGE_CHARGE / 視窗平均功率，部分負載時拉長周期減少排氫；
+ *       開啟時間隨負載增加，低水溫時 x 1.5，進氣壓力持續下降時周期縮短 1/4；
+ *       變化超過 10 % (周期) 或 0.1 s (開啟時間) 才更新，非運行中交回控制器預設排程
+ */
+static void purge(fc135kw_t* fc)
+{
+    fc135kw_purge_t* p = &fc->purge;
+    uint32_t power;
+    uint32_t period;
+    uint32_t open_time;
+    int32_t delta;
+
+    if (fc->status != FC135KW_RUNNING)
+    {
+        p->charge = 0;
+        p->tick = 0;
+        p->h2_trend = 0;
+        p->h2_last = fc->H2_pressure;
+
+        p->period = 0;
+        p->open_time = 0;
+        return;
+    }
+
+    p->charge += fc->power_setup;
+    p->tick++;
+
+    if ((p->tick % 100U) == 0)
+    {
+        /* 一階濾波 1/4 */
+        delta = (int32_t)fc->H2_pressure - (int32_t)p->h2_last;
+        p->h2_trend = (int16_t)(p->h2_trend + ((delta - p->h2_trend) / 4));
+        p->h2_last = fc->H2_pressure;
+    }
+
+    if (p->tick < FC135KW_PURGE_WINDOW)
+    {
+        return;
+    }
+
+    power = p->charge / p->tick;
+    p->charge = 0;
+    p->tick = 0;
+
+    period = power ? ((FC135KW_PURGE_CHARGE * 1000UL) / power) : FC135KW_PURGE_PERIOD_MAX;
+
+    if (p->h2_trend < -FC135KW_PURGE_H2_DROP)
+    {
+        period -= period / 4U;
+    }
+
+    period = (period < FC135KW_PURGE_PERIOD_MIN) ? FC135KW_PURGE_PERIOD_MIN :
+        (period > FC135KW_PURGE_PERIOD_MAX) ? FC135KW_PURGE_PERIOD_MAX : period;
+
+    open_time = FC135KW_PURGE_OPEN_MIN + ((FC135KW_PURGE_OPEN_LOAD * power) / FC135KW_PURGE_RATED);
+
+    if (fc->water_temp < FC135KW_PURGE_COLD_TEMP)
+    {
+        open_time += open_time / 2U;
+    }
+
+    if (((period * 10U) > ((uint32_t)p->period * 11U)) || ((period * 10U) < ((uint32_t)p->period * 9U)) ||
+        (open_time != p->open_time))
+    {
+        p->period = (uint16_t)period;
+        p->open_time = (uint8_t)open_time;
+        logger(fc, "purge period %u.%u s, open %u.%u s\r\n",
+            p->period / 10U, p->period % 10U, p->open_time / 10U, p->open_time % 10U);
+    }
+}
+
 /**
  * @brief fuel cell 初始化流程
  *
@@ -568,10 +1104,14 @@ static void precharge(fc135kw_t* fc)
         fc->light_tower.ly = true;
         fc->light_tower.lr = false;
         fc->light_tower.bz = false;
-        fc->time_count = 200;
+        fc->time_count = 100;
         fc->step = 0;
+        fc->warmup.elapsed = 0;
+        fc->warmup.stall = 0;
+        fc->warmup.temp_last = fc->water_temp;
+        fc->warmup.eta = eta(fc);
 
-        logger(fc, "%s\r\n", __func__);
+        logger(fc, "%s, water %d/%d, eta %u s\r\n", __func__, fc->water_temp, fc->water_temp_target, fc->warmup.eta);
     }
 
     if (!ems(fc))
@@ -579,10 +1119,10 @@ static void precharge(fc135kw_t* fc)
         if (fc->system_status == 6)
         {
             fc->status = FC135KW_RUNNING;
+            logger(fc, "warm-up %u s\r\n", fc->warmup.elapsed);
         }
-        // TODO 這裡要改 因為冷啟動溫度爬升至少等 20 min
-        //else if (fc->time_count == 1) 
-        else if (0)
+        /* 冷啟動升溫可能超過 20 min，以升溫趨勢判斷而非固定逾時 */
+        else if (warmup(fc))
         {
             fc->status = FC135KW_ERROR;
             logger(fc, "precharge failed\r\n");
@@ -661,7 +1201,14 @@ static void shutdown(fc135kw_t* fc)
             default:
             case STOP:
             {
-                if (fc->system_status == 3)
+                if ((fc->system_status == 3) &&
+                    fc->flag.bits.standby && !fc->flag.bits.deinit)
+                {
+                    /* 熱待機，控制器維持在狀態 3 可直接再預充 */
+                    fc->status = FC135KW_IDLE;
+                    logger(fc, "hot standby\r\n");
+                }
+                else if (fc->system_status == 3)
                 {
                     fc->time_count = 6000;
                     fc->flag.bits.power_on_sig = 0;
@@ -726,6 +1273,8 @@ static void error(fc135kw_t* fc)
 
         fc->error = 0;
         fc->error_code = 0;
+        fc->trip = false;
+        memset(&fc->fault, 0, sizeof(fc135kw_fault_list_t));
         fc->status = !fc->flag.bits.deinit ? FC135KW_INIT : FC135KW_DEINIT;
         fc->flag.bits.clear_error = 0;
     }
@@ -743,6 +1292,7 @@ static void deinit(fc135kw_t* fc)
         fc->status_old = fc->status;
         fc->flag.bits.power_on = 0;
         fc->flag.bits.ign_key = 0;
+        memset(&fc->fault, 0, sizeof(fc135kw_fault_list_t));
 
         logger(fc, "%s\r\n", __func__);
     }
@@ -3,6 +3,41 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "timebase.h"
+#include "can_signal.h"
+#include "fc135kw_codec.h"
+
+#define FC135KW_UPDATE_TIMEOUT                  TIMEBASE_S(2)       /** 數據更新逾時 */
+#define FC135KW_HOST_TIMEOUT                    TIMEBASE_S(2)       /** 主機連線逾時 */
+#define FC135KW_DERATE_POWER                    (2000U)     /** 通訊異常時的降載功率(0.01x) */
+
+#define FC135KW_TX_MAX                          (3U)        /** 發送幀數量 (fc135kw_command_t) */
+
+#define FC135KW_PURGE_WINDOW                    (1000U)     /** 排程計算週期 (10 ms) */
+#define FC135KW_PURGE_CHARGE                    (1080UL)    /** 兩次排水間的電量 (KW x s)，滿載約 8 s 一次 */
+#define FC135KW_PURGE_RATED                     (13500UL)   /** 額定功率 (0.01x) */
+#define FC135KW_PURGE_PERIOD_MIN                (50U)       /** 排水周期下限 (0.1 s) */
+#define FC135KW_PURGE_PERIOD_MAX                (600U)      /** 排水周期上限 (0.1 s) */
+#define FC135KW_PURGE_OPEN_MIN                  (3U)        /** 開啟時間，空載 (0.1 s) */
+#define FC135KW_PURGE_OPEN_LOAD                 (4U)        /** 開啟時間，滿載增加量 (0.1 s) */
+#define FC135KW_PURGE_COLD_TEMP                 (60)        /** 水溫低於此值(度)開啟時間 x 1.5 */
+#define FC135KW_PURGE_H2_DROP                   (20)        /** 進氣壓力下降超過此速率時縮短周期 (0.1 kPa/s，同 H2_pressure) */
+
+#define FC135KW_WARMUP_SAMPLE                   (30U)       /** 水溫取樣間隔 (s) */
+#define FC135KW_WARMUP_RATE                     (300)       /** 首次啟動的升溫速率預設值 (0.01 度/min) */
+#define FC135KW_WARMUP_GRACE                    (180U)      /** 預充開始後不判斷停滯的時間 (s) */
+#define FC135KW_WARMUP_STALL_RATE               (20)        /** 升溫速率低於此值視為停滯 (0.01 度/min) */
+#define FC135KW_WARMUP_STALL_TIME               (300U)      /** 停滯持續時間 (s) */
+#define FC135KW_WARMUP_TIMEOUT                  (2700U)     /** 預充最長時間 (s) */
+#define FC135KW_WARMUP_UNKNOWN                  (0xFFFFU)   /** 無法預估 */
+
+#define FC135KW_PGN_DM1                         (0x00FECAUL)        /** 多封包故障清單 (J1939 TP) */
+#define FC135KW_DTC_MAX                         (16U)       /** 保存的故障碼數量，超過的只計數 */
+
+/* DM1 故障碼 (J1939-73 版本 4，小端序)：SPN 低 16 位元、FMI 5 位元、SPN 高 3 位元、CM 1 位元、發生次數 7 位元 */
+#define FC135KW_DTC_SPN(dtc)                    (((dtc) & 0xFFFFUL) | ((((dtc) >> 21) & 0x7UL) << 16))
+#define FC135KW_DTC_FMI(dtc)                    ((uint8_t)(((dtc) >> 16) & 0x1FU))
+#define FC135KW_DTC_OC(dtc)                     ((uint8_t)(((dtc) >> 24) & 0x7FU))
 
 typedef enum fc135kw_status
 {
@@ -35,26 +70,17 @@ typedef enum fc135kw_update
     FC135KW_SYS_H2 = 0x18FC0040,
     FC135KW_SYS_WATER = 0x18FC0050,
     FC135KW_SYS_ERROR = 0x120BB001,
+    FC135KW_SYS_DM1 = 0x18FECA10,           /** 單封包 DM1 (0 或 1 個故障碼) */
 } fc135kw_update_t;
 
-typedef union fc135kw_data
+typedef enum fc135kw_signal
 {
-    struct
-    {
-        uint8_t b0 : 1;
-        uint8_t b1 : 1;
-        uint8_t b2 : 1;
-        uint8_t b3 : 1;
-        uint8_t b4 : 1;
-        uint8_t b5 : 1;
-        uint8_t b6 : 1;
-        uint8_t b7 : 1;
-    } bits[8];
-
-    uint8_t bytes[8];
-    uint16_t wbyte[4];
-    uint32_t lbyte[2];
-} fc135kw_data_t;
+    FC135KW_SIGNAL_STATUS = 0,              /** FC135KW_SYS_STATUS */
+    FC135KW_SIGNAL_H2,                      /** FC135KW_SYS_H2 */
+    FC135KW_SIGNAL_WATER,                   /** FC135KW_SYS_WATER */
+    FC135KW_SIGNAL_ERROR,                   /** FC135KW_SYS_ERROR */
+    FC135KW_SIGNAL_MAX,
+} fc135kw_signal_t;
 
 typedef struct fc135kw_light_tower
 {
@@ -64,6 +90,40 @@ typedef struct fc135kw_light_tower
     bool bz;
 } fc135kw_light_tower_t;
 
+typedef struct fc135kw_purge
+{
+    uint32_t charge;                /** 本視窗累計電量 (0.01 KW x 10 ms) */
+    uint16_t tick;                  /** basic = 10 ms */
+    uint16_t h2_last;               /** 上一秒的進氣壓力 */
+    int16_t h2_trend;               /** 進氣壓力變化率 (0.1 kPa/s，濾波後) */
+    uint16_t period;                /** 排水閥周期 (0.1 s)，0: 控制器預設 */
+    uint8_t open_time;              /** 排水閥開啟時間 (0.1 s)，0: 控制器預設 */
+} fc135kw_purge_t;
+
+typedef struct fc135kw_tx
+{
+    fc135kw_set_status_t set_status;        /** 目前的發送內容 (raw) */
+    fc135kw_drain_valve_t drain_valve;
+    fc135kw_remove_bubble_t remove_bubble;
+    can_codec_frame_t frame[FC135KW_TX_MAX];
+} fc135kw_tx_t;
+
+typedef struct fc135kw_warmup
+{
+    uint16_t elapsed;               /** 預充經過時間 (s) */
+    uint16_t stall;                 /** 升溫停滯累計時間 (s) */
+    int8_t temp_last;               /** 上次取樣的水溫 */
+    int16_t rate;                   /** 升溫速率估計 (0.01 度/min)，跨啟動保留供下次預估 */
+    uint16_t eta;                   /** 預估到達目標水溫的時間 (s) */
+} fc135kw_warmup_t;
+
+typedef struct fc135kw_fault_list
+{
+    uint8_t lamp;                   /** 故障燈狀態 (DM1 第 1 byte) */
+    uint8_t count;                  /** 清單中的故障碼總數 */
+    uint32_t dtc[FC135KW_DTC_MAX];  /** 原始故障碼，以 FC135KW_DTC_SPN/FMI/OC 解碼 */
+} fc135kw_fault_list_t;
+
 typedef union fc135kw_flag
 {
     struct
@@ -76,9 +136,14 @@ typedef union fc135kw_flag
         uint8_t emerg_stop : 1;
         uint8_t clear_error : 1;
         uint8_t remove_bubble : 1;
+        uint8_t bus_fault : 1;
+        uint8_t standby : 1;
+        uint8_t purge_manual : 1;
+        uint8_t purge_open : 1;
+        uint8_t : 4;
     } bits;
 
-    uint8_t all;
+    uint16_t all;
 
 } fc135kw_flag_t;
 
@@ -103,8 +168,14 @@ typedef struct fc135kw
 
     uint8_t step;
     uint32_t time_count;            /** basic = 10 ms */
-    uint16_t update_timeout;
-    uint16_t host_timeout;
+    deadline_t update_timeout;
+    timebase_timer_t host_timer;    /** 主機連線逾時，收到主機封包時重新計時 */
+    can_signal_t signal[FC135KW_SIGNAL_MAX];
+    volatile bool trip;             /** 接收中斷的快速路徑已觸發，清除錯誤前維持 */
+    fc135kw_purge_t purge;
+    fc135kw_warmup_t warmup;
+    fc135kw_fault_list_t fault;
+    fc135kw_tx_t tx;
 
     fc135kw_flag_t flag;
     fc135kw_status_t status;
@@ -118,14 +189,21 @@ void fc135kw_deinit(fc135kw_t* fc);
 void fc135kw_task(fc135kw_t* fc);
 fc135kw_status_t fc135kw_status(fc135kw_t* fc);
 void fc135kw_start(fc135kw_t* fc, bool enable);
+void fc135kw_standby(fc135kw_t* fc, bool enable);
 void fc135kw_clear_error(fc135kw_t* fc);
 void fc135kw_error_stop(fc135kw_t* fc);
 void fc135kw_emerg_stop(fc135kw_t* fc);
+void fc135kw_trip(fc135kw_t* fc);
 void fc135kw_remove_bubble(fc135kw_t* fc, bool enable);
+void fc135kw_purge(fc135kw_t* fc, bool manual, bool open);
 void fc135kw_host_connect(fc135kw_t* fc);
 void fc135kw_host_packet(fc135kw_t* fc, uint8_t data[8]);
 void fc135kw_command(fc135kw_t* fc, fc135kw_command_t type, uint8_t data[8]);
+bool fc135kw_purge_pending(fc135kw_t* fc);
+uint16_t fc135kw_warmup_eta(fc135kw_t* fc);
 void fc135kw_update(fc135kw_t* fc, fc135kw_update_t type, uint8_t data[8]);
+void fc135kw_message(fc135kw_t* fc, uint32_t pgn, const uint8_t* data, uint16_t size);
 void fc135kw_power(fc135kw_t* fc, uint16_t power_kw);
+void fc135kw_bus_fault(fc135kw_t* fc, bool fault);
 
 #endif
@@ -0,0 +1,456 @@
+#include "isotp.h"
+#include <string.h>
+#include <assert.h>
+
+#define PCI_SF                                  (0x00U)
+#define PCI_FF                                  (0x10U)
+#define PCI_CF                                  (0x20U)
+#define PCI_FC                                  (0x30U)
+
+#define FC_CTS                                  (0x00U)
+#define FC_WAIT                                 (0x01U)
+#define FC_OVERFLOW                             (0x02U)
+
+/**
+ * @brief 發送端資料的第 offset 個 byte (表頭之後接本體)
+ */
+static uint8_t tx_byte(const isotp_t* tp, uint16_t offset)
+{
+    return (offset < tp->tx_head_size) ? tp->tx_head[offset] : tp->tx_body[offset - tp->tx_head_size];
+}
+
+/**
+ * @brief 複製發送資料到訊框，不足 8 bytes 補 ISOTP_PADDING
+ *
+ * @return uint16_t 複製的長度
+ */
+static uint16_t tx_fill(isotp_t* tp, uint8_t frame[8], uint8_t start)
+{
+    uint16_t len = tp->tx_size - tp->tx_offset;
+    uint16_t i;
+
+    if (len > (uint16_t)(8U - start))
+    {
+        len = 8U - start;
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        frame[start + i] = tx_byte(tp, tp->tx_offset + i);
+    }
+
+    memset(&frame[start + len], ISOTP_PADDING, 8U - start - len);
+
+    return len;
+}
+
+/**
+ * @brief 發送流量控制
+ */
+static void fc_send(isotp_t* tp, uint8_t status)
+{
+    uint8_t frame[8];
+
+    frame[0] = PCI_FC | status;
+    frame[1] = tp->config->block_size;
+    frame[2] = tp->config->st_min;
+    memset(&frame[3], ISOTP_PADDING, 5);
+
+    (void)tp->config->tx(tp->handle, &frame[0]);
+}
+
+/**
+ * @brief STmin 編碼轉為 us
+ *
+ * @note 0x00 ~ 0x7F: ms，0xF1 ~ 0xF9: 100 ~ 900 us，保留值視為 127 ms
+ */
+static uint32_t st_min_decode(uint8_t st_min)
+{
+    if (st_min <= 0x7FU)
+    {
+        return TIMEBASE_MS(st_min);
+    }
+
+    if ((st_min >= 0xF1U) && (st_min <= 0xF9U))
+    {
+        return TIMEBASE_US((uint32_t)(st_min - 0xF0U) * 100UL);
+    }
+
+    return TIMEBASE_MS(0x7FU);
+}
+
+/**
+ * @brief 連續發送 CF，直到區塊結束、需要等待 STmin、發送佇列已滿或達到 ISOTP_TX_BURST
+ */
+static void cf_send(isotp_t* tp)
+{
+    uint8_t frame[8];
+    uint16_t len;
+    uint8_t burst;
+
+    for (burst = 0; burst < ISOTP_TX_BURST; burst++)
+    {
+        if (tp->tx_st_min && !deadline_expired(&tp->tx_timeout))
+        {
+            return;
+        }
+
+        frame[0] = PCI_CF | tp->tx_sn;
+        len = tx_fill(tp, frame, 1);
+
+        if (!tp->config->tx(tp->handle, &frame[0]))
+        {
+            return;
+        }
+
+        tp->tx_offset += len;
+        tp->tx_sn = (tp->tx_sn + 1U) & 0x0FU;
+
+        if (tp->tx_offset >= tp->tx_size)
+        {
+            tp->tx_state = ISOTP_TX_IDLE;
+            tp->tx_count++;
+            return;
+        }
+
+        if (tp->tx_bs && (++tp->tx_block >= tp->tx_bs))
+        {
+            tp->tx_state = ISOTP_TX_WAIT_FC;
+            deadline_set(&tp->tx_timeout, ISOTP_N_BS);
+            return;
+        }
+
+        if (tp->tx_st_min)
+        {
+            deadline_set(&tp->tx_timeout, tp->tx_st_min);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 收到 FF，回應 FC 或溢位
+ */
+static void ff_receive(isotp_t* tp, const uint8_t* data)
+{
+    uint16_t size = ((uint16_t)(data[0] & 0x0FU) << 8) | data[1];
+
+    if (size < 8U)
+    {
+        return;
+    }
+
+    if (size > ISOTP_RX_MAX)
+    {
+        tp->rx_active = false;
+        tp->error++;
+        fc_send(tp, FC_OVERFLOW);
+        return;
+    }
+
+    memcpy(&tp->rx_buffer[0], &data[2], 6);
+    tp->rx_size = size;
+    tp->rx_offset = 6;
+    tp->rx_sn = 1;
+    tp->rx_block = tp->config->block_size;
+    tp->rx_active = true;
+    deadline_set(&tp->rx_timeout, ISOTP_N_CR);
+
+    fc_send(tp, FC_CTS);
+}
+
+/**
+ * @brief 收到 CF，收齊後交給上層
+ */
+static void cf_receive(isotp_t* tp, const uint8_t* data, uint8_t dlc)
+{
+    uint16_t len;
+
+    if (!tp->rx_active)
+    {
+        return;
+    }
+
+    if ((data[0] & 0x0FU) != tp->rx_sn)
+    {
+        tp->rx_active = false;
+        tp->error++;
+        return;
+    }
+
+    len = tp->rx_size - tp->rx_offset;
+
+    if (len > 7U)
+    {
+        len = 7U;
+    }
+
+    if (dlc < (len + 1U))
+    {
+        tp->rx_active = false;
+        tp->error++;
+        return;
+    }
+
+    memcpy(&tp->rx_buffer[tp->rx_offset], &data[1], len);
+    tp->rx_offset += len;
+    tp->rx_sn = (tp->rx_sn + 1U) & 0x0FU;
+    deadline_set(&tp->rx_timeout, ISOTP_N_CR);
+
+    if (tp->rx_offset >= tp->rx_size)
+    {
+        tp->rx_active = false;
+        tp->rx_count++;
+        tp->config->deliver(tp->handle, &tp->rx_buffer[0], tp->rx_size, false);
+    }
+    else if (tp->config->block_size && (--tp->rx_block == 0))
+    {
+        tp->rx_block = tp->config->block_size;
+        fc_send(tp, FC_CTS);
+    }
+}
+
+/**
+ * @brief 收到 FC，依接收端的參數繼續發送
+ */
+static void fc_receive(isotp_t* tp, const uint8_t* data)
+{
+    if (tp->tx_state != ISOTP_TX_WAIT_FC)
+    {
+        return;
+    }
+
+    switch (data[0] & 0x0FU)
+    {
+        case FC_CTS:
+        {
+            tp->tx_bs = data[1];
+            tp->tx_block = 0;
+            tp->tx_st_min = st_min_decode(data[2]);
+            tp->tx_state = ISOTP_TX_SENDING;
+            deadline_set(&tp->tx_timeout, 0);
+            cf_send(tp);
+            break;
+        }
+        case FC_WAIT:
+        {
+            deadline_set(&tp->tx_timeout, ISOTP_N_BS);
+            break;
+        }
+        default:
+        {
+            tp->tx_state = ISOTP_TX_IDLE;
+            tp->error++;
+            break;
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief ISO 15765-2 傳輸層初始化 (normal addressing，傳統 CAN 8 bytes)
+ *
+ * @param tp 傳輸層物件
+ * @param handle 傳給 tx/deliver 的物件
+ * @param config 本機流量控制參數與回呼
+ */
+void isotp_init(isotp_t* tp, const void* handle, const isotp_config_t* config)
+{
+    assert(tp);
+    assert(config);
+    assert(config->tx);
+    assert(config->deliver);
+
+    tp->handle = handle;
+    tp->rx_active = false;
+    tp->tx_state = ISOTP_TX_IDLE;
+    tp->rx_count = 0;
+    tp->tx_count = 0;
+    tp->error = 0;
+    tp->config = config;
+
+    deadline_stop(&tp->rx_timeout);
+    deadline_stop(&tp->tx_timeout);
+}
+
+/**
+ * @brief 處理接收到的訊框
+ *
+ * @param tp 傳輸層物件
+ * @param data 資料
+ * @param dlc 長度
+ * @param functional true: 功能定址 (只接受 SF)
+ *
+ * @note 發送中收到新的請求會被忽略 (伺服器一次處理一個請求，發送中的表頭直接指向伺服器的回應緩衝，
+ *       處理新請求會覆寫)；上層的逾時 (例如 UDS S3) 需以 isotp_busy() 延後
+ */
+void isotp_receive(isotp_t* tp, const uint8_t* data, uint8_t dlc, bool functional)
+{
+    uint8_t len;
+
+    assert(tp);
+    assert(data);
+
+    if (dlc < 1U)
+    {
+        return;
+    }
+
+    switch (data[0] & 0xF0U)
+    {
+        case PCI_SF:
+        {
+            len = data[0] & 0x0FU;
+
+            if ((len == 0) || (len > 7U) || (len >= dlc) || (tp->tx_state != ISOTP_TX_IDLE))
+            {
+                return;
+            }
+
+            /* 新的請求取代接收中的多訊框請求 */
+            tp->rx_active = false;
+            tp->rx_count++;
+            tp->config->deliver(tp->handle, &data[1], len, functional);
+            break;
+        }
+        case PCI_FF:
+        {
+            if (!functional && (dlc == 8U) && (tp->tx_state == ISOTP_TX_IDLE))
+            {
+                ff_receive(tp, data);
+            }
+            break;
+        }
+        case PCI_CF:
+        {
+            if (!functional)
+            {
+                cf_receive(tp, data, dlc);
+            }
+            break;
+        }
+        case PCI_FC:
+        {
+            if (!functional && (dlc >= 3U))
+            {
+                fc_receive(tp, data);
+            }
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 發送一個訊息，超過 7 bytes 時分段
+ *
+ * @param tp 傳輸層物件
+ * @param head 表頭 (例如服務回應碼)，發送完成前不可修改
+ * @param head_size 表頭長度
+ * @param body 本體，直接由來源發送，發送完成前不可修改；NULL 表示沒有
+ * @param body_size 本體長度
+ *
+ * @return true 已開始發送
+ * @return false 發送中、長度超過 ISOTP_SIZE_MAX 或發送佇列已滿
+ */
+bool isotp_send(isotp_t* tp, const uint8_t* head, uint16_t head_size, const uint8_t* body, uint16_t body_size)
+{
+    uint8_t frame[8];
+    uint16_t size = head_size + body_size;
+
+    assert(tp);
+    assert(head || (head_size == 0));
+    assert(body || (body_size == 0));
+
+    if ((tp->tx_state != ISOTP_TX_IDLE) || (size == 0) || (size > ISOTP_SIZE_MAX))
+    {
+        return false;
+    }
+
+    tp->tx_head = head;
+    tp->tx_head_size = head_size;
+    tp->tx_body = body;
+    tp->tx_size = size;
+    tp->tx_offset = 0;
+
+    if (size <= 7U)
+    {
+        frame[0] = PCI_SF | (uint8_t)size;
+        (void)tx_fill(tp, frame, 1);
+
+        if (!tp->config->tx(tp->handle, &frame[0]))
+        {
+            return false;
+        }
+
+        tp->tx_count++;
+        return true;
+    }
+
+    frame[0] = PCI_FF | (uint8_t)(size >> 8);
+    frame[1] = (uint8_t)size;
+    tp->tx_offset = tx_fill(tp, frame, 2);
+
+    if (!tp->config->tx(tp->handle, &frame[0]))
+    {
+        return false;
+    }
+
+    tp->tx_sn = 1;
+    tp->tx_state = ISOTP_TX_WAIT_FC;
+    deadline_set(&tp->tx_timeout, ISOTP_N_BS);
+
+    return true;
+}
+
+/**
+ * @brief 是否正在發送
+ */
+bool isotp_busy(const isotp_t* tp)
+{
+    assert(tp);
+
+    return tp->tx_state != ISOTP_TX_IDLE;
+}
+
+/**
+ * @brief 逾時處理與連續發送，每次主迴圈調用
+ *
+ * @note STmin = 0 時每次調用排入 ISOTP_TX_BURST 個 CF，由發送佇列決定實際速率
+ */
+void isotp_task(isotp_t* tp)
+{
+    assert(tp);
+
+    if (tp->rx_active && deadline_expired(&tp->rx_timeout))
+    {
+        tp->rx_active = false;
+        tp->error++;
+    }
+
+    switch (tp->tx_state)
+    {
+        case ISOTP_TX_WAIT_FC:
+        {
+            if (deadline_expired(&tp->tx_timeout))
+            {
+                tp->tx_state = ISOTP_TX_IDLE;
+                tp->error++;
+            }
+            break;
+        }
+        case ISOTP_TX_SENDING:
+        {
+            cf_send(tp);
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef _isotp_h_
+#define _isotp_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timebase.h"
+
+#define ISOTP_RX_MAX                            (128U)      /** 接收 (請求) 緩衝大小 */
+#define ISOTP_SIZE_MAX                          (4095U)     /** 傳統 CAN 的 FF 長度上限 (12 位元) */
+#define ISOTP_TX_BURST                          (8U)        /** 每次 isotp_task() 最多排入的 CF 數，保留發送佇列給其他訊框 */
+#define ISOTP_N_BS                              TIMEBASE_MS(1000)   /** 等待 FC 逾時 */
+#define ISOTP_N_CR                              TIMEBASE_MS(1000)   /** 等待 CF 逾時 */
+#define ISOTP_PADDING                           (0xCCU)
+
+typedef enum isotp_tx_state
+{
+    ISOTP_TX_IDLE = 0,
+    ISOTP_TX_WAIT_FC,               /** FF 或一個區塊已送出，等待接收端的 FC */
+    ISOTP_TX_SENDING,               /** 依 FC 的 BS / STmin 連續發送 CF */
+} isotp_tx_state_t;
+
+typedef struct isotp_config
+{
+    uint8_t block_size;             /** 本機 FC 的 BS，0: 發送端不需再等待 FC */
+    uint8_t st_min;                 /** 本機 FC 的 STmin (ISO 15765-2 編碼)，0: 不限制 */
+    bool (*tx)(const void* handle, const uint8_t data[8]);
+    void (*deliver)(const void* handle, const uint8_t* data, uint16_t size, bool functional);
+} isotp_config_t;
+
+typedef struct isotp
+{
+    const void* handle;
+
+    uint8_t rx_buffer[ISOTP_RX_MAX];
+    uint16_t rx_size;
+    uint16_t rx_offset;
+    uint8_t rx_sn;                  /** 下一個預期的 CF 序號 */
+    uint8_t rx_block;               /** 本區塊剩餘的 CF 數 */
+    bool rx_active;
+    deadline_t rx_timeout;
+
+    /* 發送資料分為表頭與本體兩段，本體直接指向來源 (不複製) */
+    const uint8_t* tx_head;
+    uint16_t tx_head_size;
+    const uint8_t* tx_body;
+    uint16_t tx_size;
+    uint16_t tx_offset;
+    uint8_t tx_sn;
+    uint8_t tx_bs;                  /** 接收端的 BS，0: 不限制 */
+    uint8_t tx_block;               /** 本區塊已送出的 CF 數 */
+    uint32_t tx_st_min;             /** 接收端的 STmin (us) */
+    isotp_tx_state_t tx_state;
+    deadline_t tx_timeout;          /** 等待 FC 時為 N_Bs，發送中為 STmin */
+
+    uint32_t rx_count;
+    uint32_t tx_count;
+    uint32_t error;                 /** 逾時、序號錯誤或接收端溢位 */
+
+    const isotp_config_t* config;
+} isotp_t;
+
+void isotp_init(isotp_t* tp, const void* handle, const isotp_config_t* config);
+void isotp_receive(isotp_t* tp, const uint8_t* data, uint8_t dlc, bool functional);
+bool isotp_send(isotp_t* tp, const uint8_t* head, uint16_t head_size, const uint8_t* body, uint16_t body_size);
+bool isotp_busy(const isotp_t* tp);
+void isotp_task(isotp_t* tp);
+
+#endif
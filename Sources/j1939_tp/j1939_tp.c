@@ -0,0 +1,411 @@
+#include "j1939_tp.h"
+#include "ramfunc.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define TP_CM_RTS                               (16U)
+#define TP_CM_CTS                               (17U)
+#define TP_CM_EOMA                              (19U)
+#define TP_CM_BAM                               (32U)
+#define TP_CM_ABORT                             (255U)
+
+#define TP_PRIORITY                             (7UL)
+#define TP_PACKET_SIZE                          (7U)
+#define TP_SIZE_MIN                             (9U)
+
+#define TP_PF(id)                               ((uint8_t)((id) >> 16))
+#define TP_DA(id)                               ((uint8_t)((id) >> 8))
+#define TP_SA(id)                               ((uint8_t)(id))
+#define TP_PGN(data)                            ((uint32_t)(data)[5] | ((uint32_t)(data)[6] << 8) | ((uint32_t)(data)[7] << 16))
+
+/**
+ * @brief logger
+ *
+ * @param tp 傳輸協議物件
+ * @param fmt logger 訊息
+ * @param ... 可選參數
+ */
+static void logger(j1939_tp_t* tp, const char* fmt, ...)
+{
+    uint16_t len;
+    char buffer[128] = { 0 };
+
+    assert(tp);
+
+    if (tp->config->log)
+    {
+        va_list args;
+        va_start(args, fmt);
+
+        len = snprintf(buffer, 128, "[%s]", tp->config->name);
+        len += vsnprintf(&buffer[len], (128 - len), fmt, args);
+
+        va_end(args);
+
+        tp->config->log(&buffer[0], len);
+    }
+}
+
+/**
+ * @brief 發送 TP.CM 給指定位址
+ *
+ * @param tp 傳輸協議物件
+ * @param da 目的地位址
+ * @param control 控制碼
+ * @param b1 ~ b4 控制碼之後的四個 byte
+ * @param pgn 傳輸的 PGN
+ */
+static void cm_send(j1939_tp_t* tp, uint8_t da, uint8_t control, uint8_t b1, uint8_t b2, uint8_t b3, uint8_t b4, uint32_t pgn)
+{
+    uint8_t data[8];
+    uint32_t id;
+
+    data[0] = control;
+    data[1] = b1;
+    data[2] = b2;
+    data[3] = b3;
+    data[4] = b4;
+    data[5] = (uint8_t)pgn;
+    data[6] = (uint8_t)(pgn >> 8);
+    data[7] = (uint8_t)(pgn >> 16);
+
+    id = (TP_PRIORITY << 26) | (J1939_PGN_TP_CM << 8) | ((uint32_t)da << 8) | tp->config->address;
+    tp->config->tx(tp->handle, id, &data[0]);
+}
+
+/**
+ * @brief 允許發送端送出下一個視窗的封包
+ */
+static void cts_send(j1939_tp_t* tp, j1939_tp_session_t* s)
+{
+    uint8_t count = (uint8_t)(s->packets - s->next + 1U);
+
+    if (count > s->limit)
+    {
+        count = s->limit;
+    }
+
+    s->window = (uint8_t)(s->next + count - 1U);
+    s->timer = J1939_TP_T2;
+
+    cm_send(tp, s->sa, TP_CM_CTS, count, s->next, 0xFF, 0xFF, s->pgn);
+}
+
+/**
+ * @brief 中止點對點 session 並通知發送端 (BAM 只釋放)
+ */
+static void abort_session(j1939_tp_t* tp, j1939_tp_session_t* s, j1939_tp_abort_t reason)
+{
+    if (!s->bam)
+    {
+        cm_send(tp, s->sa, TP_CM_ABORT, reason, 0xFF, 0xFF, 0xFF, s->pgn);
+    }
+
+    logger(tp, "abort %s from 0x%02X, pgn 0x%05lX, reason %d\r\n",
+        s->bam ? "bam" : "rts", s->sa, (unsigned long)s->pgn, reason);
+
+    s->active = false;
+    tp->aborted++;
+}
+
+/**
+ * @brief 找出發送端對應的 session (每個發送端最多一個 BAM 與一個 RTS/CTS)
+ *
+ * @return NULL: 不存在
+ */
+static j1939_tp_session_t* session_find(j1939_tp_t* tp, uint8_t sa, bool bam)
+{
+    uint8_t i;
+
+    for (i = 0; i < J1939_TP_SESSION_MAX; i++)
+    {
+        if (tp->session[i].active && (tp->session[i].sa == sa) && (tp->session[i].bam == bam))
+        {
+            return &tp->session[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 取得發送端的 session，已存在時重新開始 (發送端重送 RTS/BAM 表示放棄前一個)
+ *
+ * @return NULL: session 用盡
+ */
+static j1939_tp_session_t* session_open(j1939_tp_t* tp, uint8_t sa, bool bam)
+{
+    j1939_tp_session_t* s = session_find(tp, sa, bam);
+    uint8_t i;
+
+    for (i = 0; (s == NULL) && (i < J1939_TP_SESSION_MAX); i++)
+    {
+        if (!tp->session[i].active)
+        {
+            s = &tp->session[i];
+        }
+    }
+
+    if (s)
+    {
+        s->active = true;
+        s->bam = bam;
+        s->sa = sa;
+        s->next = 1;
+    }
+
+    return s;
+}
+
+/**
+ * @brief 處理 TP.CM
+ */
+static void cm_receive(j1939_tp_t* tp, uint8_t da, uint8_t sa, const uint8_t data[8])
+{
+    j1939_tp_session_t* s;
+    uint16_t size = (uint16_t)data[1] | ((uint16_t)data[2] << 8);
+    uint8_t packets = data[3];
+    bool bam;
+
+    switch (data[0])
+    {
+        case TP_CM_BAM:
+        case TP_CM_RTS:
+        {
+            bam = (data[0] == TP_CM_BAM);
+
+            if (bam != (da == J1939_ADDRESS_GLOBAL))
+            {
+                return;
+            }
+
+            if ((size < TP_SIZE_MIN) || (packets != ((size + TP_PACKET_SIZE - 1U) / TP_PACKET_SIZE)))
+            {
+                return;
+            }
+
+            s = (size <= J1939_TP_SIZE_MAX) ? session_open(tp, sa, bam) : NULL;
+
+            if (s == NULL)
+            {
+                tp->rejected++;
+
+                if (!bam)
+                {
+                    cm_send(tp, sa, TP_CM_ABORT,
+                        (size <= J1939_TP_SIZE_MAX) ? J1939_TP_ABORT_BUSY : J1939_TP_ABORT_RESOURCE,
+                        0xFF, 0xFF, 0xFF, TP_PGN(data));
+                }
+
+                logger(tp, "reject %s from 0x%02X, pgn 0x%05lX, %d bytes\r\n",
+                    bam ? "bam" : "rts", sa, (unsigned long)TP_PGN(data), size);
+                return;
+            }
+
+            s->pgn = TP_PGN(data);
+            s->size = size;
+            s->packets = packets;
+
+            if (bam)
+            {
+                s->timer = J1939_TP_T1;
+            }
+            else
+            {
+                /* 0xFF: 發送端不限制 */
+                s->limit = ((data[4] == 0) || (data[4] > J1939_TP_CTS_WINDOW)) ? J1939_TP_CTS_WINDOW : data[4];
+                cts_send(tp, s);
+            }
+            break;
+        }
+        case TP_CM_ABORT:
+        {
+            s = session_find(tp, sa, false);
+
+            if (s && (da == tp->config->address) && (s->pgn == TP_PGN(data)))
+            {
+                s->active = false;
+                tp->aborted++;
+            }
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 處理 TP.DT，收齊後交給上層
+ */
+static void dt_receive(j1939_tp_t* tp, uint8_t da, uint8_t sa, const uint8_t data[8])
+{
+    j1939_tp_session_t* s = session_find(tp, sa, (da == J1939_ADDRESS_GLOBAL));
+    uint16_t offset;
+    uint16_t len;
+
+    if (s == NULL)
+    {
+        return;
+    }
+
+    if (data[0] != s->next)
+    {
+        /* 點對點時重複的最後一包可忽略，其餘序號錯誤中止；BAM 無法要求重送，直接放棄 */
+        if (!s->bam && (data[0] == (uint8_t)(s->next - 1U)))
+        {
+            return;
+        }
+
+        abort_session(tp, s, J1939_TP_ABORT_SEQUENCE);
+        return;
+    }
+
+    offset = (uint16_t)(s->next - 1U) * TP_PACKET_SIZE;
+    len = s->size - offset;
+
+    if (len > TP_PACKET_SIZE)
+    {
+        len = TP_PACKET_SIZE;
+    }
+
+    memcpy(&s->buffer[offset], &data[1], len);
+    s->timer = J1939_TP_T1;
+
+    if (s->next == s->packets)
+    {
+        if (!s->bam)
+        {
+            cm_send(tp, s->sa, TP_CM_EOMA, (uint8_t)s->size, (uint8_t)(s->size >> 8), s->packets, 0xFF, s->pgn);
+        }
+
+        s->active = false;
+        tp->completed++;
+
+        if (tp->config->deliver)
+        {
+            tp->config->deliver(tp->handle, s->pgn, s->sa, &s->buffer[0], s->size);
+        }
+    }
+    else
+    {
+        s->next++;
+
+        if (!s->bam && (s->next > s->window))
+        {
+            cts_send(tp, s);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief J1939 傳輸協議 (TP) 接收端初始化
+ *
+ * @param tp 傳輸協議物件
+ * @param handle 傳給 tx/deliver 的物件
+ * @param config 本機位址與回呼
+ *
+ * @note session 與重組緩衝皆為固定配置 (J1939_TP_SESSION_MAX x J1939_TP_SIZE_MAX)，
+ *       超過時 RTS 回應中止、BAM 忽略，記憶體用量與同時進行的 session 數無關
+ */
+void j1939_tp_init(j1939_tp_t* tp, const void* handle, const j1939_tp_config_t* config)
+{
+    uint8_t i;
+
+    assert(tp);
+    assert(config);
+    assert(config->tx);
+
+    for (i = 0; i < J1939_TP_SESSION_MAX; i++)
+    {
+        tp->session[i].active = false;
+    }
+
+    tp->handle = handle;
+    tp->completed = 0;
+    tp->aborted = 0;
+    tp->rejected = 0;
+    tp->config = config;
+}
+
+/**
+ * @brief 處理接收到的訊框
+ *
+ * @param tp 傳輸協議物件
+ * @param id 29 位元 ID
+ * @param data 資料
+ *
+ * @return true TP.CM / TP.DT (已處理)
+ * @return false 其他訊框，由呼叫者繼續處理
+ *
+ * @note 只處理廣播或目的地為本機的 TP；需要回應的 CTS/EOMA/中止在此直接發送
+ */
+RAMFUNC bool j1939_tp_receive(j1939_tp_t* tp, uint32_t id, const uint8_t data[8])
+{
+    uint8_t pf = TP_PF(id);
+    uint8_t da = TP_DA(id);
+
+    assert(tp);
+    assert(data);
+
+    if ((pf != (uint8_t)(J1939_PGN_TP_CM >> 8)) && (pf != (uint8_t)(J1939_PGN_TP_DT >> 8)))
+    {
+        return false;
+    }
+
+    if ((da != J1939_ADDRESS_GLOBAL) && (da != tp->config->address))
+    {
+        return true;
+    }
+
+    if (pf == (uint8_t)(J1939_PGN_TP_CM >> 8))
+    {
+        cm_receive(tp, da, TP_SA(id), data);
+    }
+    else
+    {
+        dt_receive(tp, da, TP_SA(id), data);
+    }
+
+    return true;
+}
+
+/**
+ * @brief session 逾時處理
+ *
+ * @param tp 傳輸協議物件
+ *
+ * @note 10 ms 調用一次
+ */
+void j1939_tp_task(j1939_tp_t* tp)
+{
+    j1939_tp_session_t* s;
+    uint8_t i;
+
+    assert(tp);
+
+    for (i = 0; i < J1939_TP_SESSION_MAX; i++)
+    {
+        s = &tp->session[i];
+
+        if (!s->active)
+        {
+            continue;
+        }
+
+        if (s->timer)
+        {
+            s->timer--;
+        }
+
+        if (!s->timer)
+        {
+            abort_session(tp, s, J1939_TP_ABORT_TIMEOUT);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef _j1939_tp_h_
+#define _j1939_tp_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define J1939_TP_SESSION_MAX                    (4U)        /** 同時進行的接收 session 數 (BAM + RTS/CTS 共用) */
+#define J1939_TP_SIZE_MAX                       (256U)      /** 每個 session 的重組緩衝 (bytes)，協議上限 1785 */
+#define J1939_TP_CTS_WINDOW                     (8U)        /** 每次 CTS 允許的封包數 */
+#define J1939_TP_T1                             (75U)       /** 資料封包間隔逾時 (10 ms) */
+#define J1939_TP_T2                             (125U)      /** 送出 CTS 後等待資料逾時 (10 ms) */
+
+#define J1939_PGN_TP_CM                         (0x00EC00UL)
+#define J1939_PGN_TP_DT                         (0x00EB00UL)
+#define J1939_ADDRESS_GLOBAL                    (0xFFU)
+
+typedef enum j1939_tp_abort
+{
+    J1939_TP_ABORT_BUSY = 1,        /** 已在其他 session 中，無法再建立 */
+    J1939_TP_ABORT_RESOURCE = 2,    /** 資源不足 (緩衝不夠大) */
+    J1939_TP_ABORT_TIMEOUT = 3,
+    J1939_TP_ABORT_SEQUENCE = 7,    /** 封包序號錯誤 */
+} j1939_tp_abort_t;
+
+typedef struct j1939_tp_session
+{
+    bool active;
+    bool bam;                       /** true: 廣播 (BAM)，false: 點對點 (RTS/CTS) */
+    uint8_t sa;                     /** 發送端位址 */
+    uint8_t packets;                /** 總封包數 */
+    uint8_t next;                   /** 下一個預期的序號 (1 起算) */
+    uint8_t window;                 /** 本次 CTS 視窗的最後一個序號 */
+    uint8_t limit;                  /** 發送端每次 CTS 可接受的最大封包數 */
+    uint16_t size;
+    uint16_t timer;                 /** basic = 10 ms，0: 逾時 */
+    uint32_t pgn;
+    uint8_t buffer[J1939_TP_SIZE_MAX];
+} j1939_tp_session_t;
+
+typedef struct j1939_tp_config
+{
+    const char* name;
+    uint8_t address;                /** 本機位址，RTS 需以此為目的地 */
+    void (*log)(const char* str, uint16_t size);
+    void (*tx)(const void* handle, uint32_t id, const uint8_t data[8]);
+    void (*deliver)(const void* handle, uint32_t pgn, uint8_t sa, const uint8_t* data, uint16_t size);
+} j1939_tp_config_t;
+
+typedef struct j1939_tp
+{
+    const void* handle;
+    j1939_tp_session_t session[J1939_TP_SESSION_MAX];
+    uint32_t completed;
+    uint32_t aborted;               /** 逾時、序號錯誤或發送端中止 */
+    uint32_t rejected;              /** session 用盡或訊息過長而拒絕 */
+
+    const j1939_tp_config_t* config;
+} j1939_tp_t;
+
+void j1939_tp_init(j1939_tp_t* tp, const void* handle, const j1939_tp_config_t* config);
+bool j1939_tp_receive(j1939_tp_t* tp, uint32_t id, const uint8_t data[8]);
+void j1939_tp_task(j1939_tp_t* tp);
+
+#endif
@@ -7,14 +7,43 @@ void menu_main_start(void);
 void menu_main(void);
 void menu_main_stop(void);
 void menu_main_pause(void);
+static void menu_key(input_id_t id, input_event_t event, uint64_t time);
 
 /*--------------------------------------------------------------------------------------------------------*/
 
 pFunction menu_level_new = menu_main_start;
 pFunction menu_level_old = 0;
 
+static bool key_start;
+static bool key_stop;
+
+/** 待機時綠燈每 3.2 秒亮 0.2 秒，啟動/關機中綠燈閃爍 */
+static const annunciator_pattern_t tower_wait[ANNUNCIATOR_CHANNEL_MAX] =
+{
+    [TOWER_LG] = { 20, 300 },
+    [TOWER_LY] = ANNUNCIATOR_OFF,
+    [TOWER_LR] = ANNUNCIATOR_OFF,
+    [TOWER_BZ] = ANNUNCIATOR_OFF,
+};
+static const annunciator_pattern_t tower_busy[ANNUNCIATOR_CHANNEL_MAX] =
+{
+    [TOWER_LG] = ANNUNCIATOR_BLINK,
+    [TOWER_LY] = ANNUNCIATOR_OFF,
+    [TOWER_LR] = ANNUNCIATOR_OFF,
+    [TOWER_BZ] = ANNUNCIATOR_OFF,
+};
+
 /*--------------------------------------------------------------------------------------------------------*/
 
+void menu_init(void)
+{
+    /* 啟動長按 1.5 s，停止長按 0.5 s */
+    app_input_subscribe(INPUT_BUTTON_ON, INPUT_EVENT_LONG, TIMEBASE_MS(1500), menu_key);
+    app_input_subscribe(INPUT_KEY_1, INPUT_EVENT_LONG, TIMEBASE_MS(1500), menu_key);
+    app_input_subscribe(INPUT_BUTTON_OFF, INPUT_EVENT_LONG, TIMEBASE_MS(500), menu_key);
+    app_input_subscribe(INPUT_KEY_2, INPUT_EVENT_LONG, TIMEBASE_MS(500), menu_key);
+}
+
 void menu(void)
 {
     pFunction menu_level = menu_level_new;
@@ -43,63 +72,43 @@ void menu_main_start(void)
 
     static uint8_t step;
     static uint8_t time_count;
-    static uint16_t light_tower;
 
     if (menu_level_old != menu_level_new)
     {
         menu_level_old = menu_level_new;
-        light_tower = 0;
+        key_start = false;
         time_count = 0;
         step = WAIT;
+        annunciator_set(&tower, TOWER_SOURCE_MENU, TOWER_PRIORITY_SYSTEM, &tower_wait[0]);
         app_logger("waiting for system startup\r\n");
 
         FC_TYT60KW_HOST_POWER(1);
         FC_135KW_HOST_POWER(1);
     }
 
-    if (time_flag.bits.t0_10s)
+    if (key_start)
     {
-        switch (key_scan())
+        key_start = false;
+
+        if (step == WAIT)
         {
-            default:
-            case 0x0000: { break; }
-            case 0x0001: { key_timer_set(15); break; }
-            case 0x01FF:
-            {
-                if (step == WAIT)
-                {
-                    app_logger("system startup\r\n");
-                    step = FC1_RELAY_ON;
-                    time_count = 0;
-                    light_tower = 0;
-                }
-                break;
-            }
+            app_standby_exit();
+            app_logger("system startup\r\n");
+            step = FC1_RELAY_ON;
+            time_count = 0;
+            annunciator_set(&tower, TOWER_SOURCE_MENU, TOWER_PRIORITY_SYSTEM, &tower_busy[0]);
         }
     }
 
     time_count += time_flag.bits.t1_00s;
 
-    if (step != WAIT)
-    {
-        LIGHT_TOWER(time_flag.bits.t0_50s_clock, 0, 0, 0);
-    }
-
     switch (step)
     {
         default:
         case WAIT:
         {
-            if (time_flag.bits.t0_20s)
-            {
-                if (light_tower == 0)
-                {
-                    light_tower = 0x0001;
-                }
-
-                LIGHT_TOWER((light_tower & 0x0001), 0, 0, 0);
-                light_tower <<= 1;
-            }
+            /* 等待啟動期間只需追燈號與按鍵，降頻待機 */
+            app_standby_enter();
             break;
         }
         case FC1_RELAY_ON:
@@ -118,7 +127,7 @@ void menu_main_start(void)
                 FC_135KW_HIGH_POWER_RELAY(1);
                 FC_135KW_HOST_POWER(1);
                 app_logger("fc2 high power relay on\r\n");
-                bidc300100_set_ctrl(&dcdc, BIDC300100_ON);
+                bidc300100_bank_set_ctrl(&dcdc, BIDC300100_ON);
                 app_logger("enable dcdc\r\n");
                 time_count = 0;
                 step = DCDC_ON;
@@ -130,9 +139,11 @@ void menu_main_start(void)
             if (time_count > 5)
             {
                 step = WAIT;
+                annunciator_set(&tower, TOWER_SOURCE_MENU, TOWER_PRIORITY_SYSTEM, &tower_wait[0]);
                 app_logger("enable dcdc failed\r\n");
             }
-            else if (bidc300100_status(&dcdc).power_output == true)
+            else if ((bidc300100_bank_online(&dcdc) != 0) &&
+                (bidc300100_bank_output(&dcdc) == bidc300100_bank_online(&dcdc)))
             {
                 menu_level_new = menu_main;
             }
@@ -148,65 +159,31 @@ void menu_main(void)
     if (menu_level_old != menu_level_new)
     {
         menu_level_old = menu_level_new;
+        key_stop = false;
         idle_time = 0;
+        annunciator_clear(&tower, TOWER_SOURCE_MENU);
 
-        if (fc135kw_status(&fc135kw) != FC135KW_INIT)
-        {
-            fc135kw_start(&fc135kw, true);
-        }
-
-        if (tyt60kw_status(&tyt60kw) != FC135KW_INIT)
-        {
-            tyt60kw_start(&tyt60kw, true);
-        }
+        /* 依主機需求決定運行台數，其餘 stack 維持熱待機 */
+        stage_enable(&stage, true);
     }
 
-    if (time_flag.bits.t0_10s)
+    if (time_flag.bits.t1_00s)
     {
-        switch (key_scan())
-        {
-            default:
-            case 0x0000: { break; }
-            case 0x0002: { key_timer_set(5); break; }
-            case 0x02FF:
-            {
-                menu_level_new = menu_main_stop;
-                app_logger("system shutdown\r\n");
-                break;
-            }
-        }
+        stage_task(&stage);
     }
 
-    if ((fc135kw_status(&fc135kw) == FC135KW_IDLE) &&
-        (tyt60kw_status(&tyt60kw) == TYT60KW_IDLE))
+    if (key_stop)
     {
-        LIGHT_TOWER(1, 0, 0, 0);
+        key_stop = false;
+        menu_level_new = menu_main_stop;
+        app_logger("system shutdown\r\n");
     }
-    else
+
+    /* 燈號由各 stack 的 light_tower 回呼送到 annunciator 仲裁 */
+    if ((fc135kw_status(&fc135kw) != FC135KW_IDLE) ||
+        (tyt60kw_status(&tyt60kw) != TYT60KW_IDLE))
     {
         idle_time = 0;
-
-        if ((fc135kw_status(&fc135kw) == FC135KW_ERROR) ||
-            (tyt60kw_status(&tyt60kw) == TYT60KW_ERROR))
-        {
-            LIGHT_TOWER(0, 0,
-                time_flag.bits.t1_00s_clock,
-                time_flag.bits.t1_00s_clock);
-        }
-        else if ((fc135kw_status(&fc135kw) == FC135KW_RUNNING) ||
-            (tyt60kw_status(&tyt60kw) == TYT60KW_RUNNING))
-        {
-            LIGHT_TOWER(0, 1, 0, 0);
-        }
-        else if ((fc135kw_status(&fc135kw) == FC135KW_PRECHARGE) ||
-            (tyt60kw_status(&tyt60kw) == TYT60KW_PRECHARGE))
-        {
-            LIGHT_TOWER(0, time_flag.bits.t0_20s_clock, 0, 0);
-        }
-        else
-        {
-            LIGHT_TOWER(0, 0, 0, 0);
-        }
     }
 
 // TODO
@@ -233,13 +210,13 @@ void menu_main_stop(void)
         menu_level_old = menu_level_new;
         step = 0;
         timeout = 1800;
+        stage_enable(&stage, false);
         fc135kw_deinit(&fc135kw);
         tyt60kw_deinit(&tyt60kw);
         app_logger("deinit fc modules\r\n");
+        annunciator_set(&tower, TOWER_SOURCE_MENU, TOWER_PRIORITY_SYSTEM, &tower_busy[0]);
     }
 
-    LIGHT_TOWER(time_flag.bits.t0_50s_clock, 0, 0, 0);
-
     if (time_flag.bits.t0_10s)
     {
         if (timeout > 1)
@@ -262,7 +239,7 @@ void menu_main_stop(void)
             }
             case 1:
             {
-                bidc300100_set_ctrl(&dcdc, BIDC300100_OFF);
+                bidc300100_bank_set_ctrl(&dcdc, BIDC300100_OFF);
                 app_logger("disable dcdc\r\n");
                 step++;
                 timeout = 1;
@@ -270,7 +247,7 @@ void menu_main_stop(void)
             }
             case 2:
             {
-                if (bidc300100_status(&dcdc).power_output == false)
+                if (bidc300100_bank_output(&dcdc) == 0)
                 {
                     // TODO
                     // FC_TYT60KW_HIGH_POWER_RELAY(0);
@@ -283,7 +260,7 @@ void menu_main_stop(void)
                 else if (timeout == 1)
                 {
                     timeout = 5;
-                    bidc300100_set_ctrl(&dcdc, BIDC300100_OFF);
+                    bidc300100_bank_set_ctrl(&dcdc, BIDC300100_OFF);
                 }
                 break;
             }
@@ -299,3 +276,20 @@ void menu_main_pause(void)
         app_logger("menu_main_pause\r\n");
     }
 }
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void menu_key(input_id_t id, input_event_t event, uint64_t time)
+{
+    (void)event;
+    (void)time;
+
+    if ((id == INPUT_BUTTON_ON) || (id == INPUT_KEY_1))
+    {
+        key_start = true;
+    }
+    else
+    {
+        key_stop = true;
+    }
+}
@@ -3,6 +3,7 @@
 
 #include "app.h"
 
+void menu_init(void);
 void menu(void);
 
 #endif
@@ -0,0 +1,320 @@
+#include "modbus_rtu.h"
+#include <assert.h>
+
+/** CRC-16/MODBUS (多項式 0xA001 反射)，逐 byte 查表 */
+static const uint16_t crc_table[256] =
+{
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+
+/**
+ * @brief 暫存器表項目佔用的暫存器數
+ */
+static uint8_t reg_count(const modbus_reg_t* reg)
+{
+    return (reg->size == 4U) ? 2U : 1U;
+}
+
+/**
+ * @brief 讀取表項目指向的即時資料，轉為 32 位元 (有號數做符號延伸)
+ */
+static uint32_t reg_read(const modbus_reg_t* reg)
+{
+    switch (reg->size)
+    {
+        case 1:
+        {
+            return reg->sign ? (uint32_t)(int32_t)*(const volatile int8_t*)reg->data : *(const volatile uint8_t*)reg->data;
+        }
+        case 2:
+        {
+            return reg->sign ? (uint32_t)(int32_t)*(const volatile int16_t*)reg->data : *(const volatile uint16_t*)reg->data;
+        }
+        default:
+        {
+            return *(const volatile uint32_t*)reg->data;
+        }
+    }
+}
+
+/**
+ * @brief 找出包含指定位址的表項目 (二分搜尋)
+ *
+ * @return 表項目索引，count: 位址未對應
+ */
+static uint16_t reg_find(const modbus_rtu_config_t* config, uint16_t address)
+{
+    uint16_t low = 0;
+    uint16_t high = config->count;
+    uint16_t mid;
+
+    /* 找最後一個起始位址 <= address 的項目 */
+    while (low < high)
+    {
+        mid = (uint16_t)((low + high) / 2U);
+
+        if (config->map[mid].address <= address)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if ((low == 0) || (address >= ((uint32_t)config->map[low - 1U].address + reg_count(&config->map[low - 1U]))))
+    {
+        return config->count;
+    }
+
+    return low - 1U;
+}
+
+/**
+ * @brief 加上 CRC (低位在前)
+ *
+ * @return uint16_t 完整訊框長度
+ */
+static uint16_t frame_end(uint8_t* frame, uint16_t size)
+{
+    uint16_t crc = modbus_rtu_crc(frame, size);
+
+    frame[size] = (uint8_t)crc;
+    frame[size + 1U] = (uint8_t)(crc >> 8);
+
+    return size + 2U;
+}
+
+/**
+ * @brief 例外回應
+ */
+static uint16_t exception(modbus_rtu_t* mb, uint8_t function, uint8_t code, uint8_t* response)
+{
+    mb->exception++;
+
+    response[0] = mb->config->address;
+    response[1] = function | 0x80U;
+    response[2] = code;
+
+    return frame_end(response, 3);
+}
+
+/**
+ * @brief 讀取保持/輸入暫存器 (0x03, 0x04，兩者共用同一份表)
+ */
+static uint16_t read_registers(modbus_rtu_t* mb, const uint8_t* request, uint16_t size, uint8_t* response)
+{
+    const modbus_rtu_config_t* config = mb->config;
+    const modbus_reg_t* reg;
+    uint16_t start;
+    uint16_t quantity;
+    uint16_t index;
+    uint16_t offset;
+    uint16_t value;
+    uint16_t len;
+    uint16_t i;
+
+    if (size != 8U)
+    {
+        return exception(mb, request[1], MODBUS_EX_ILLEGAL_VALUE, response);
+    }
+
+    start = ((uint16_t)request[2] << 8) | request[3];
+    quantity = ((uint16_t)request[4] << 8) | request[5];
+
+    if ((quantity == 0) || (quantity > MODBUS_RTU_READ_MAX))
+    {
+        return exception(mb, request[1], MODBUS_EX_ILLEGAL_VALUE, response);
+    }
+
+    if (((uint32_t)start + quantity) > 0x10000UL)
+    {
+        return exception(mb, request[1], MODBUS_EX_ILLEGAL_ADDRESS, response);
+    }
+
+    index = reg_find(config, start);
+
+    if (index == config->count)
+    {
+        return exception(mb, request[1], MODBUS_EX_ILLEGAL_ADDRESS, response);
+    }
+
+    response[0] = config->address;
+    response[1] = request[1];
+    response[2] = (uint8_t)(quantity * 2U);
+    len = 3;
+
+    /* 表格依位址排列，區間內的項目依序走訪，中間有空缺時回應位址錯誤 */
+    for (i = 0; i < quantity; i++)
+    {
+        reg = &config->map[index];
+        offset = (uint16_t)(start + i - reg->address);
+
+        if (offset >= reg_count(reg))
+        {
+            index++;
+
+            if ((index == config->count) || (config->map[index].address != (uint16_t)(start + i)))
+            {
+                return exception(mb, request[1], MODBUS_EX_ILLEGAL_ADDRESS, response);
+            }
+
+            reg = &config->map[index];
+            offset = 0;
+        }
+
+        if (reg_count(reg) == 2U)
+        {
+            value = (uint16_t)(reg_read(reg) >> (offset ? 0 : 16));
+        }
+        else
+        {
+            value = (uint16_t)reg_read(reg);
+        }
+
+        response[len++] = (uint8_t)(value >> 8);
+        response[len++] = (uint8_t)value;
+    }
+
+    return frame_end(response, len);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Modbus RTU 從站初始化
+ *
+ * @param mb 從站物件
+ * @param config 站號與暫存器表，暫存器表需依位址遞增且不重疊
+ */
+void modbus_rtu_init(modbus_rtu_t* mb, const modbus_rtu_config_t* config)
+{
+    uint16_t i;
+
+    assert(mb);
+    assert(config);
+    assert(config->map || (config->count == 0));
+    assert((config->address >= 1U) && (config->address <= 247U));
+
+    for (i = 1; i < config->count; i++)
+    {
+        assert(config->map[i].address >= ((uint32_t)config->map[i - 1U].address + reg_count(&config->map[i - 1U])));
+    }
+
+    mb->request = 0;
+    mb->crc_error = 0;
+    mb->exception = 0;
+    mb->ignored = 0;
+    mb->config = config;
+}
+
+/**
+ * @brief 處理一個完整的請求訊框 (由 t3.5 間隔切分)
+ *
+ * @param mb 從站物件
+ * @param request 請求訊框 (含 CRC)
+ * @param size 請求長度
+ * @param response 回應緩衝，至少 MODBUS_RTU_FRAME_MAX
+ *
+ * @return uint16_t 回應長度，0: 不回應 (CRC 錯誤、非本站、廣播)
+ *
+ * @note 回應時直接讀取暫存器表指向的即時資料，不另外保存影像
+ */
+uint16_t modbus_rtu_handle(modbus_rtu_t* mb, const uint8_t* request, uint16_t size, uint8_t* response)
+{
+    uint16_t crc;
+
+    assert(mb);
+    assert(request);
+    assert(response);
+
+    if ((size < 4U) || (size > MODBUS_RTU_FRAME_MAX))
+    {
+        mb->ignored++;
+        return 0;
+    }
+
+    crc = ((uint16_t)request[size - 1U] << 8) | request[size - 2U];
+
+    if (crc != modbus_rtu_crc(request, size - 2U))
+    {
+        mb->crc_error++;
+        return 0;
+    }
+
+    /* 只提供讀取，廣播不需回應也沒有意義 */
+    if (request[0] != mb->config->address)
+    {
+        mb->ignored++;
+        return 0;
+    }
+
+    mb->request++;
+
+    switch (request[1])
+    {
+        case MODBUS_FC_READ_HOLDING:
+        case MODBUS_FC_READ_INPUT:
+        {
+            return read_registers(mb, request, size, response);
+        }
+        default:
+        {
+            return exception(mb, request[1], MODBUS_EX_ILLEGAL_FUNCTION, response);
+        }
+    }
+}
+
+/**
+ * @brief CRC-16/MODBUS
+ *
+ * @param data 資料
+ * @param size 長度
+ *
+ * @return uint16_t CRC，訊框中低位在前
+ */
+uint16_t modbus_rtu_crc(const uint8_t* data, uint16_t size)
+{
+    uint16_t crc = 0xFFFF;
+
+    assert(data || (size == 0));
+
+    while (size--)
+    {
+        crc = (crc >> 8) ^ crc_table[(uint8_t)(crc ^ *data++)];
+    }
+
+    return crc;
+}
@@ -0,0 +1,53 @@
+#ifndef _modbus_rtu_h_
+#define _modbus_rtu_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MODBUS_RTU_FRAME_MAX                    (256U)      /** RTU 最大訊框長度 (位址 + PDU + CRC) */
+#define MODBUS_RTU_READ_MAX                     (125U)      /** 單次讀取的暫存器上限 */
+
+#define MODBUS_FC_READ_HOLDING                  (0x03U)
+#define MODBUS_FC_READ_INPUT                    (0x04U)
+
+#define MODBUS_EX_ILLEGAL_FUNCTION              (0x01U)
+#define MODBUS_EX_ILLEGAL_ADDRESS               (0x02U)
+#define MODBUS_EX_ILLEGAL_VALUE                 (0x03U)
+
+/**
+ * 暫存器表項目，直接指向即時資料 (不複製)，依 sizeof 決定佔用的暫存器數：
+ * 1/2 bytes 佔一個暫存器，4 bytes 佔兩個 (高位在前)；bool 與 enum 皆可直接對應
+ */
+#define MODBUS_UNSIGNED(addr, var)              { (addr), sizeof(var), false, &(var) }
+#define MODBUS_SIGNED(addr, var)                { (addr), sizeof(var), true, &(var) }
+
+typedef struct modbus_reg
+{
+    uint16_t address;               /** 暫存器位址 (0 起算)，表格需依位址遞增排列 */
+    uint8_t size;                   /** 資料長度 (bytes): 1, 2, 4 */
+    bool sign;                      /** 有號數，1 byte 時做符號延伸 */
+    const volatile void* data;
+} modbus_reg_t;
+
+typedef struct modbus_rtu_config
+{
+    uint8_t address;                /** 從站位址 1 ~ 247 */
+    const modbus_reg_t* map;
+    uint16_t count;
+} modbus_rtu_config_t;
+
+typedef struct modbus_rtu
+{
+    uint32_t request;               /** 本站請求數 (含例外回應) */
+    uint32_t crc_error;
+    uint32_t exception;
+    uint32_t ignored;               /** 非本站、廣播或長度不足 */
+
+    const modbus_rtu_config_t* config;
+} modbus_rtu_t;
+
+void modbus_rtu_init(modbus_rtu_t* mb, const modbus_rtu_config_t* config);
+uint16_t modbus_rtu_handle(modbus_rtu_t* mb, const uint8_t* request, uint16_t size, uint8_t* response);
+uint16_t modbus_rtu_crc(const uint8_t* data, uint16_t size);
+
+#endif
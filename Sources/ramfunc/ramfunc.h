@@ -0,0 +1,26 @@
+#ifndef _ramfunc_h_
+#define _ramfunc_h_
+
+/**
+ * 標記在 SRAM 執行的函式 (中斷與接收解碼的熱路徑)
+ *
+ * 放入 .code_ram，由連結檔配置在 m_data (SRAM_L，走 Code bus，取指令不需等待)，
+ * 開機時 init_data_bss() 從 flash 複製；flash 與 SRAM 之間的呼叫由連結器自動加入 veneer。
+ * 非 ARM 編譯 (PC 上的 tools/) 時為空，模組可直接在 PC 上建置。
+ * SDK 的 FlexCAN / eDMA 中斷路徑 (flexcan_irq、flexcan_driver、flexcan_hw_access、edma_irq、edma_driver)
+ * 不修改原始碼，由 S32K144_64_flash.ld 以物件檔為單位自 .text 排除並放入同一個 .code 區段。
+ *
+ * 比較前後差異：將 RAMFUNC_ENABLE 設為 0 重新建置，兩次的 APP_BENCH 輸出用 compare.py 比較
+ */
+
+#ifndef RAMFUNC_ENABLE
+#define RAMFUNC_ENABLE                          (1)
+#endif
+
+#if RAMFUNC_ENABLE && defined(__GNUC__) && defined(__arm__)
+#define RAMFUNC                                 __attribute__((section(".code_ram"), noinline))
+#else
+#define RAMFUNC
+#endif
+
+#endif
@@ -0,0 +1,480 @@
+#include "stage.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <assert.h>
+
+#define STAGE_NONE                              (STAGE_STACK_MAX)
+
+/**
+ * @brief logger
+ *
+ * @param stage 排程物件
+ * @param fmt logger 訊息
+ * @param ... 可選參數
+ */
+static void logger(stage_t* stage, const char* fmt, ...)
+{
+    uint16_t len;
+    char buffer[128] = { 0 };
+
+    if (stage->config->log)
+    {
+        va_list args;
+        va_start(args, fmt);
+
+        len = snprintf(buffer, 128, "[stage]");
+        len += vsnprintf(&buffer[len], (128 - len), fmt, args);
+
+        va_end(args);
+
+        stage->config->log(&buffer[0], len);
+    }
+}
+
+/**
+ * @brief 設定 stack 運行或回到熱待機，只在變化時調用回呼
+ *
+ * @param stage 排程物件
+ * @param i stack
+ * @param run true: 運行, false: 熱待機
+ */
+static void command(stage_t* stage, uint8_t i, bool run)
+{
+    if (stage->run[i] != run)
+    {
+        stage->run[i] = run;
+        stage->config->stack[i].run(run);
+        logger(stage, "%s %s, demand %lu KW\r\n", stage->config->stack[i].name, run ? "run" : "standby",
+            (unsigned long)((stage->demand + 8U) / 16U));
+    }
+}
+
+/**
+ * @brief 主機允許運行的 stack 需求總和
+ *
+ * @param stage 排程物件
+ *
+ * @return uint32_t KW
+ */
+static uint32_t demand(stage_t* stage)
+{
+    uint32_t sum = 0;
+    uint8_t i;
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        if (stage->allow[i])
+        {
+            sum += stage->request[i];
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * @brief 依額定功率比例分配需求給運行中的 stack，預充中的 stack 先以額定比例預設
+ *
+ * @param stage 排程物件
+ */
+static void split(stage_t* stage)
+{
+    const stage_stack_config_t* stack = &stage->config->stack[0];
+    uint32_t total = demand(stage);
+    uint32_t capacity = 0;
+    uint32_t power;
+    bool running = false;
+    uint8_t i;
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        running |= (stage->run[i] && (stack[i].state() == STAGE_RUNNING));
+    }
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        if (stage->run[i] && (!running || (stack[i].state() == STAGE_RUNNING)))
+        {
+            capacity += stack[i].capacity;
+        }
+    }
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        if (capacity && stage->run[i] && (!running || (stack[i].state() == STAGE_RUNNING)))
+        {
+            power = (total * stack[i].capacity) / capacity;
+            stack[i].power((uint16_t)((power > stack[i].capacity) ? stack[i].capacity : power));
+        }
+    }
+}
+
+/**
+ * @brief 選出可加開的 stack，累計運行時間最少者優先
+ *
+ * @param stage 排程物件
+ * @param state 各 stack 狀態
+ *
+ * @return uint8_t stack，STAGE_NONE: 無
+ */
+static uint8_t pick_start(stage_t* stage, const stage_state_t state[])
+{
+    uint8_t pick = STAGE_NONE;
+    uint8_t i;
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        if (stage->allow[i] && !stage->run[i] && (state[i] == STAGE_STANDBY) &&
+            ((pick == STAGE_NONE) || (stage->run_time[i] < stage->run_time[pick])))
+        {
+            pick = i;
+        }
+    }
+
+    return pick;
+}
+
+/**
+ * @brief 選出可減開的 stack，剩餘容量仍足夠時累計運行時間最多者優先
+ *
+ * @param stage 排程物件
+ * @param state 各 stack 狀態
+ * @param load 過濾後的需求 (KW)
+ * @param capacity 排程運行中的容量 (KW)
+ *
+ * @return uint8_t stack，STAGE_NONE: 無
+ */
+static uint8_t pick_stop(stage_t* stage, const stage_state_t state[], uint32_t load, uint32_t capacity)
+{
+    uint8_t pick = STAGE_NONE;
+    uint8_t others;
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        if (!stage->run[i] ||
+            ((load * 100U) >= ((capacity - stage->config->stack[i].capacity) * STAGE_DOWN_PERCENT)))
+        {
+            continue;
+        }
+
+        /* 其他 stack 需已在運行才能減開 */
+        others = 0;
+
+        for (j = 0; j < STAGE_STACK_MAX; j++)
+        {
+            others += ((j != i) && stage->run[j] && (state[j] == STAGE_RUNNING));
+        }
+
+        if (others && ((pick == STAGE_NONE) || (stage->run_time[i] > stage->run_time[pick])))
+        {
+            pick = i;
+        }
+    }
+
+    return pick;
+}
+
+/**
+ * @brief 運行時間差過大時以待機 stack 替換運行中的 stack，先啟動再停止
+ *
+ * @param stage 排程物件
+ * @param state 各 stack 狀態
+ * @param load 過濾後的需求 (KW)
+ * @param capacity 排程運行中的容量 (KW)
+ */
+static void rotate(stage_t* stage, const stage_state_t state[], uint32_t load, uint32_t capacity)
+{
+    bool others = false;
+    bool ready = true;
+    uint8_t stop = STAGE_NONE;
+    uint8_t start;
+    uint8_t i;
+
+    if (stage->rotate != STAGE_NONE)
+    {
+        for (i = 0; i < STAGE_STACK_MAX; i++)
+        {
+            if ((i != stage->rotate) && stage->run[i])
+            {
+                others = true;
+                ready &= (state[i] == STAGE_RUNNING);
+            }
+        }
+
+        /* 替換的 stack 進入運行才停止，替換失敗時取消 */
+        if (!others || !stage->run[stage->rotate])
+        {
+            stage->rotate = STAGE_NONE;
+        }
+        else if (ready)
+        {
+            command(stage, stage->rotate, false);
+            stage->rotate = STAGE_NONE;
+        }
+
+        return;
+    }
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        if (stage->run[i] && (state[i] == STAGE_RUNNING) &&
+            ((stop == STAGE_NONE) || (stage->run_time[i] > stage->run_time[stop])))
+        {
+            stop = i;
+        }
+    }
+
+    start = pick_start(stage, state);
+
+    if ((stop != STAGE_NONE) && (start != STAGE_NONE) &&
+        (stage->run_time[stop] > (stage->run_time[start] + STAGE_ROTATE_TIME)) &&
+        ((load * 100U) <= ((capacity - stage->config->stack[stop].capacity + stage->config->stack[start].capacity) * STAGE_UP_PERCENT)))
+    {
+        logger(stage, "rotate %s -> %s\r\n", stage->config->stack[stop].name, stage->config->stack[start].name);
+        command(stage, start, true);
+        stage->rotate = stop;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 多 stack 運行排程初始化，預設停用
+ *
+ * @param stage 排程物件
+ * @param config 配置結構體
+ */
+void stage_init(stage_t* stage, const stage_config_t* config)
+{
+    uint8_t i;
+
+    assert(stage);
+    assert(config);
+
+    stage->config = config;
+    stage->enable = false;
+    stage->demand = 0;
+    stage->rotate = STAGE_NONE;
+    stage->up_count = 0;
+    stage->down_count = 0;
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        assert(config->stack[i].state);
+        assert(config->stack[i].run);
+        assert(config->stack[i].power);
+
+        stage->request[i] = 0;
+        stage->allow[i] = false;
+        stage->run[i] = false;
+        stage->run_time[i] = 0;
+    }
+}
+
+/**
+ * @brief 啟用/停用排程
+ *
+ * @param stage 排程物件
+ * @param enable true: 開始依需求排程, false: 停止排程 (stack 由呼叫端停止)
+ *
+ * @note 啟用時濾波器直接載入目前需求，不等待濾波爬升
+ */
+void stage_enable(stage_t* stage, bool enable)
+{
+    uint8_t i;
+
+    assert(stage);
+
+    if (stage->enable == enable)
+    {
+        return;
+    }
+
+    stage->enable = enable;
+    stage->demand = demand(stage) * 16U;
+    stage->rotate = STAGE_NONE;
+    stage->up_count = 0;
+    stage->down_count = 0;
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        stage->run[i] = false;
+    }
+
+    logger(stage, "%s\r\n", enable ? "enable" : "disable");
+}
+
+/**
+ * @brief 主機的運行請求
+ *
+ * @param stage 排程物件
+ * @param stack stack
+ * @param start 主機允許運行
+ * @param power_kw 主機需求功率 (KW)，允許運行的 stack 加總為整體需求
+ *
+ * @note 主機停止時立即回到熱待機，不經過減開延遲
+ */
+void stage_request(stage_t* stage, uint8_t stack, bool start, uint16_t power_kw)
+{
+    assert(stage);
+    assert(stack < STAGE_STACK_MAX);
+
+    stage->allow[stack] = start;
+    stage->request[stack] = power_kw;
+
+    if (stage->enable)
+    {
+        if (!start)
+        {
+            command(stage, stack, false);
+        }
+
+        split(stage);
+    }
+}
+
+/**
+ * @brief 排程週期處理
+ *
+ * @param stage 排程物件
+ *
+ * @note 每秒調用；需求超過運行容量 STAGE_UP_PERCENT 持續 STAGE_UP_DELAY 秒加開一台，
+ *       減開一台後仍低於剩餘容量 STAGE_DOWN_PERCENT 持續 STAGE_DOWN_DELAY 秒減開一台
+ */
+void stage_task(stage_t* stage)
+{
+    stage_state_t state[STAGE_STACK_MAX];
+    uint32_t capacity = 0;
+    uint32_t load;
+    uint8_t count = 0;
+    uint8_t pick;
+    uint8_t i;
+
+    assert(stage);
+
+    if (!stage->enable)
+    {
+        return;
+    }
+
+    load = demand(stage) * 16U;
+    stage->demand = (load >= stage->demand) ?
+        (stage->demand + ((load - stage->demand) / STAGE_FILTER)) :
+        (stage->demand - ((stage->demand - load) / STAGE_FILTER));
+    load = (stage->demand + 8U) / 16U;
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        state[i] = stage->config->stack[i].state();
+
+        if (state[i] == STAGE_RUNNING)
+        {
+            stage->run_time[i]++;
+        }
+
+        /* 主機停止或 stack 故障時移出排程，由其他 stack 補上 */
+        if (stage->run[i] && (!stage->allow[i] || (state[i] == STAGE_UNAVAILABLE)))
+        {
+            command(stage, i, false);
+        }
+
+        if (stage->run[i])
+        {
+            capacity += stage->config->stack[i].capacity;
+            count++;
+        }
+    }
+
+    if (count == 0)
+    {
+        stage->up_count = 0;
+        stage->down_count = 0;
+        stage->rotate = STAGE_NONE;
+
+        pick = pick_start(stage, state);
+
+        if ((demand(stage) > 0) && (pick != STAGE_NONE))
+        {
+            command(stage, pick, true);
+        }
+    }
+    else
+    {
+        if ((load * 100U) > (capacity * STAGE_UP_PERCENT))
+        {
+            pick = pick_start(stage, state);
+
+            if ((pick != STAGE_NONE) && (++stage->up_count >= STAGE_UP_DELAY))
+            {
+                command(stage, pick, true);
+                stage->up_count = 0;
+            }
+        }
+        else
+        {
+            stage->up_count = 0;
+        }
+
+        pick = (stage->rotate == STAGE_NONE) ? pick_stop(stage, state, load, capacity) : STAGE_NONE;
+
+        if (pick != STAGE_NONE)
+        {
+            if (++stage->down_count >= STAGE_DOWN_DELAY)
+            {
+                command(stage, pick, false);
+                stage->down_count = 0;
+            }
+        }
+        else
+        {
+            stage->down_count = 0;
+        }
+
+        if ((stage->up_count == 0) && (stage->down_count == 0))
+        {
+            rotate(stage, state, load, capacity);
+        }
+    }
+
+    split(stage);
+}
+
+/**
+ * @brief 排程運行中的 stack 數量
+ *
+ * @param stage 排程物件
+ *
+ * @return uint8_t
+ */
+uint8_t stage_running(stage_t* stage)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    assert(stage);
+
+    for (i = 0; i < STAGE_STACK_MAX; i++)
+    {
+        count += stage->run[i];
+    }
+
+    return count;
+}
+
+/**
+ * @brief 累計運行時間
+ *
+ * @param stage 排程物件
+ * @param stack stack
+ *
+ * @return uint32_t 秒，重新上電後歸零
+ */
+uint32_t stage_run_time(stage_t* stage, uint8_t stack)
+{
+    assert(stage);
+    assert(stack < STAGE_STACK_MAX);
+
+    return stage->run_time[stack];
+}
@@ -0,0 +1,60 @@
+#ifndef _stage_h_
+#define _stage_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STAGE_STACK_MAX                         (2U)
+#define STAGE_FILTER                            (4U)        /** 需求一階濾波時間常數 (s) */
+#define STAGE_UP_PERCENT                        (90U)       /** 需求超過運行容量的比例時加開 */
+#define STAGE_UP_DELAY                          (30U)       /** 加開需持續的時間 (s) */
+#define STAGE_DOWN_PERCENT                      (70U)       /** 減少一台後需求仍低於剩餘容量的比例時減開 */
+#define STAGE_DOWN_DELAY                        (300U)      /** 減開需持續的時間 (s) */
+#define STAGE_ROTATE_TIME                       (36000UL)   /** 運行時間差超過時輪替 (s) */
+
+typedef enum stage_state
+{
+    STAGE_UNAVAILABLE = 0,                      /** 初始化、錯誤、去初始化 */
+    STAGE_STANDBY,                              /** 熱待機 (IDLE)，可直接預充 */
+    STAGE_STARTING,                             /** 預充中 */
+    STAGE_RUNNING,
+    STAGE_STOPPING,                             /** 關機回到待機中 */
+} stage_state_t;
+
+typedef struct stage_stack_config
+{
+    const char* name;
+    uint16_t capacity;                          /** 額定功率 (KW) */
+    stage_state_t(*state)(void);
+    void (*run)(bool enable);
+    void (*power)(uint16_t power_kw);
+} stage_stack_config_t;
+
+typedef struct stage_config
+{
+    void (*log)(const char* str, uint16_t size);
+    stage_stack_config_t stack[STAGE_STACK_MAX];
+} stage_config_t;
+
+typedef struct stage
+{
+    uint32_t demand;                            /** 過濾後的需求 (KW x 16) */
+    uint16_t request[STAGE_STACK_MAX];          /** 主機需求 (KW) */
+    bool allow[STAGE_STACK_MAX];                /** 主機允許運行 */
+    bool run[STAGE_STACK_MAX];                  /** 排程結果 */
+    uint32_t run_time[STAGE_STACK_MAX];         /** 累計運行時間 (s) */
+    uint16_t up_count;
+    uint16_t down_count;
+    uint8_t rotate;                             /** 輪替中等待停止的 stack，STAGE_STACK_MAX: 無 */
+    bool enable;
+    const stage_config_t* config;
+} stage_t;
+
+void stage_init(stage_t* stage, const stage_config_t* config);
+void stage_enable(stage_t* stage, bool enable);
+void stage_request(stage_t* stage, uint8_t stack, bool start, uint16_t power_kw);
+void stage_task(stage_t* stage);
+uint8_t stage_running(stage_t* stage);
+uint32_t stage_run_time(stage_t* stage, uint8_t stack);
+
+#endif
@@ -0,0 +1,317 @@
+#include "timebase.h"
+#include "ramfunc.h"
+#include <stddef.h>
+#include <assert.h>
+
+static struct
+{
+    volatile uint64_t base;                     /** 已經過的完整週期 (us) */
+    uint64_t wheel_tick;                        /** 最後處理的 wheel 槽 */
+    timebase_timer_t* wheel[TIMEBASE_WHEEL_SLOTS];
+    const timebase_config_t* config;
+} timebase;
+
+/**
+ * @brief 將 timer 放入對應的槽
+ *
+ * @param timer timer 物件
+ */
+static void wheel_insert(timebase_timer_t* timer)
+{
+    uint32_t slot = (uint32_t)(timer->expire >> TIMEBASE_WHEEL_SHIFT) & (TIMEBASE_WHEEL_SLOTS - 1U);
+
+    timer->next = timebase.wheel[slot];
+    timebase.wheel[slot] = timer;
+    timer->armed = true;
+}
+
+/**
+ * @brief 將 timer 從槽中移除
+ *
+ * @param timer timer 物件
+ */
+static void wheel_remove(timebase_timer_t* timer)
+{
+    uint32_t slot = (uint32_t)(timer->expire >> TIMEBASE_WHEEL_SHIFT) & (TIMEBASE_WHEEL_SLOTS - 1U);
+    timebase_timer_t** node = &timebase.wheel[slot];
+
+    while (*node)
+    {
+        if (*node == timer)
+        {
+            *node = timer->next;
+            break;
+        }
+
+        node = &(*node)->next;
+    }
+
+    timer->next = NULL;
+    timer->armed = false;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 時基初始化
+ *
+ * @param config 配置結構體
+ *
+ * @note 硬體計數器需在 config->period 週期溢位並產生中斷，
+ *       中斷內需調用 timebase_irq() 延伸為 64 bits
+ */
+void timebase_init(const timebase_config_t* config)
+{
+    uint32_t i;
+
+    assert(config);
+    assert(config->period);
+    assert(config->counter);
+
+    timebase.config = config;
+    timebase.base = 0;
+    timebase.wheel_tick = 0;
+
+    for (i = 0; i < TIMEBASE_WHEEL_SLOTS; i++)
+    {
+        timebase.wheel[i] = NULL;
+    }
+}
+
+/**
+ * @brief 計數器溢位，需在硬體溢位中斷內調用
+ */
+RAMFUNC void timebase_irq(void)
+{
+    timebase.base += timebase.config->period;
+}
+
+/**
+ * @brief 取得單調遞增的時間
+ *
+ * @return uint64_t 開機後經過的時間 (us)
+ *
+ * @note 可在中斷內調用；若溢位中斷尚未處理(中斷被遮罩或優先權較低)，
+ *       會自行補上一個週期
+ */
+uint64_t timebase_now(void)
+{
+    uint64_t base;
+    uint32_t count;
+
+    assert(timebase.config);
+
+    do
+    {
+        base = timebase.base;
+        count = timebase.config->counter();
+
+        if (timebase.config->pending && timebase.config->pending())
+        {
+            /*
+                溢位旗標已設定但 base 還沒更新，重新讀取計數器：
+                讀到前半週期代表已歸零，需補上一個週期；
+                讀到後半週期代表旗標在歸零前就已設定(比較相等時)
+             */
+            count = timebase.config->counter();
+
+            if (count < (timebase.config->period / 2U))
+            {
+                count += timebase.config->period;
+            }
+        }
+    } while (base != timebase.base);
+
+    return base + count;
+}
+
+/**
+ * @brief 取得開機後經過的時間
+ *
+ * @return uint32_t 開機後經過的時間 (ms)，約 49 天溢位
+ */
+uint32_t timebase_now_ms(void)
+{
+    return (uint32_t)(timebase_now() / 1000U);
+}
+
+/**
+ * @brief timer wheel 任務，觸發到期的 timer
+ *
+ * @note 需在主迴圈調用，callback 在此函式內執行
+ */
+void timebase_task(void)
+{
+    uint64_t now = timebase_now();
+    uint64_t tick = now >> TIMEBASE_WHEEL_SHIFT;
+    uint64_t first = timebase.wheel_tick;
+    timebase_timer_t* expired = NULL;
+    timebase_timer_t* timer;
+    timebase_timer_t** node;
+    uint32_t slot;
+
+    if ((tick - first) >= TIMEBASE_WHEEL_SLOTS)
+    {
+        /* 間隔太久，所有槽都需要檢查 */
+        first = tick - (TIMEBASE_WHEEL_SLOTS - 1U);
+    }
+
+    for (; first <= tick; first++)
+    {
+        slot = (uint32_t)first & (TIMEBASE_WHEEL_SLOTS - 1U);
+        node = &timebase.wheel[slot];
+
+        while (*node)
+        {
+            timer = *node;
+
+            if (timer->expire <= now)
+            {
+                /* 先移到暫存串列，避免週期 timer 重新放入同一槽時被重複處理 */
+                *node = timer->next;
+                timer->next = expired;
+                timer->armed = false;
+                expired = timer;
+            }
+            else
+            {
+                node = &timer->next;
+            }
+        }
+    }
+
+    timebase.wheel_tick = tick;
+
+    while (expired)
+    {
+        timer = expired;
+        expired = timer->next;
+        timer->next = NULL;
+
+        if (timer->period)
+        {
+            timer->expire += timer->period;
+
+            if (timer->expire <= now)
+            {
+                /* 錯過太多週期時不追趕，從現在重新計算 */
+                timer->expire = now + timer->period;
+            }
+
+            wheel_insert(timer);
+        }
+
+        if (timer->callback)
+        {
+            timer->callback(timer->arg);
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 設定期限
+ *
+ * @param deadline 期限物件
+ * @param us 從現在起多久後到期 (us)
+ */
+void deadline_set(deadline_t* deadline, uint32_t us)
+{
+    assert(deadline);
+
+    deadline->expire = timebase_now() + us;
+    deadline->armed = true;
+}
+
+/**
+ * @brief 停止期限，停止後 deadline_expired() 固定回傳 false
+ *
+ * @param deadline 期限物件
+ */
+void deadline_stop(deadline_t* deadline)
+{
+    assert(deadline);
+
+    deadline->armed = false;
+}
+
+/**
+ * @brief 期限是否到期
+ *
+ * @param deadline 期限物件
+ *
+ * @return true 已到期
+ * @return false 未到期或已停止
+ */
+bool deadline_expired(deadline_t* deadline)
+{
+    assert(deadline);
+
+    return deadline->armed && (timebase_now() >= deadline->expire);
+}
+
+/**
+ * @brief 期限剩餘時間
+ *
+ * @param deadline 期限物件
+ *
+ * @return uint32_t 剩餘時間 (us)，已到期或已停止回傳 0
+ */
+uint32_t deadline_remaining(deadline_t* deadline)
+{
+    uint64_t now = timebase_now();
+
+    assert(deadline);
+
+    if (!deadline->armed || (now >= deadline->expire))
+    {
+        return 0;
+    }
+
+    return (uint32_t)(deadline->expire - now);
+}
+
+/**
+ * @brief 啟動 timer
+ *
+ * @param timer timer 物件
+ * @param delay 第一次觸發的延遲 (us)
+ * @param period 0: 單次, 其他: 之後的觸發週期 (us)
+ * @param callback 到期時調用
+ * @param arg callback 參數
+ *
+ * @note 只能在主迴圈調用 (與 timebase_task() 相同的執行環境)
+ */
+void timebase_timer_start(timebase_timer_t* timer, uint32_t delay, uint32_t period,
+    void (*callback)(void* arg), void* arg)
+{
+    assert(timer);
+
+    if (timer->armed)
+    {
+        wheel_remove(timer);
+    }
+
+    timer->expire = timebase_now() + delay;
+    timer->period = period;
+    timer->callback = callback;
+    timer->arg = arg;
+
+    wheel_insert(timer);
+}
+
+/**
+ * @brief 停止 timer
+ *
+ * @param timer timer 物件
+ */
+void timebase_timer_stop(timebase_timer_t* timer)
+{
+    assert(timer);
+
+    if (timer->armed)
+    {
+        wheel_remove(timer);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef _timebase_h_
+#define _timebase_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TIMEBASE_US(n)                          ((uint32_t)(n))
+#define TIMEBASE_MS(n)                          ((uint32_t)(n) * 1000UL)
+#define TIMEBASE_S(n)                           ((uint32_t)(n) * 1000000UL)
+
+#define TIMEBASE_WHEEL_SLOTS                    (32U)       /** timer wheel 槽數 (2 的冪次) */
+#define TIMEBASE_WHEEL_SHIFT                    (10U)       /** 每槽寬度 = 2^10 us (約 1 ms) */
+
+typedef struct timebase_config
+{
+    uint32_t period;                        /** 硬體計數器溢位週期 (us) */
+    uint32_t(*counter)(void);               /** 讀取目前週期內經過的時間 (us) */
+    bool (*pending)(void);                  /** 溢位中斷是否尚未處理 */
+} timebase_config_t;
+
+typedef struct deadline
+{
+    uint64_t expire;                        /** 到期時間 (us) */
+    bool armed;
+} deadline_t;
+
+typedef struct timebase_timer
+{
+    uint64_t expire;                        /** 到期時間 (us) */
+    uint32_t period;                        /** 0: 單次, 其他: 週期 (us) */
+    void (*callback)(void* arg);
+    void* arg;
+    bool armed;
+    struct timebase_timer* next;
+} timebase_timer_t;
+
+void timebase_init(const timebase_config_t* config);
+void timebase_irq(void);
+uint64_t timebase_now(void);
+uint32_t timebase_now_ms(void);
+void timebase_task(void);
+
+void deadline_set(deadline_t* deadline, uint32_t us);
+void deadline_stop(deadline_t* deadline);
+bool deadline_expired(deadline_t* deadline);
+uint32_t deadline_remaining(deadline_t* deadline);
+
+void timebase_timer_start(timebase_timer_t* timer, uint32_t delay, uint32_t period,
+    void (*callback)(void* arg), void* arg);
+void timebase_timer_stop(timebase_timer_t* timer);
+
+#endif
@@ -1,10 +1,29 @@
 #include "toyota60kw.h"
+#include "ramfunc.h"
+#include "host_codec.h"
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 typedef void (*fc_fun_t)(tyt60kw_t* fc);
 
+enum
+{
+    TX_04E = 0,
+    TX_215,
+};
+
+/* 各訊號預期的更新週期 (us)，狀態與錯誤等級 100 ms，溫度與錯誤碼 500 ms */
+static const uint32_t signal_period[TYT60KW_SIGNAL_MAX] =
+{
+    [TYT60KW_SIGNAL_050] = TIMEBASE_MS(100),
+    [TYT60KW_SIGNAL_051] = TIMEBASE_MS(100),
+    [TYT60KW_SIGNAL_222] = TIMEBASE_MS(500),
+    [TYT60KW_SIGNAL_225] = TIMEBASE_MS(500),
+    [TYT60KW_SIGNAL_508] = TIMEBASE_MS(500),
+};
+
 static void init(tyt60kw_t* fc);
 static void idle(tyt60kw_t* fc);
 static void precharge(tyt60kw_t* fc);
@@ -12,6 +31,8 @@ static void running(tyt60kw_t* fc);
 static void shutdown(tyt60kw_t* fc);
 static void error(tyt60kw_t* fc);
 static void deinit(tyt60kw_t* fc);
+static can_codec_frame_t* tx_update(tyt60kw_t* fc, tyt60kw_command_t type);
+static void host_timeout(void* arg);
 
 static void logger(tyt60kw_t* fc, const char* fmt, ...)
 {
@@ -88,15 +109,33 @@ static void cooling(tyt60kw_t* fc)
 
 void tyt60kw_init(tyt60kw_t* fc, tyt60kw_config_t* config)
 {
+    uint8_t i;
+
     assert(fc);
     assert(config);
 
     fc->config = config;
     fc->flag.all = 0;
     fc->power_setup = 0;
+    fc->trip = false;
     fc->start_command = TYT60KW_OFF;
+    memset(&fc->tx, 0, sizeof(tyt60kw_tx_t));
+
+    for (i = 0; i < TYT60KW_TX_MAX; i++)
+    {
+        fc->tx.frame[i].dirty = true;
+    }
+
     fc->status = TYT60KW_INIT;
     fc->status_old = TYT60KW_STATUS_MAX;
+
+    for (i = 0; i < TYT60KW_SIGNAL_MAX; i++)
+    {
+        can_signal_init(&fc->signal[i], signal_period[i]);
+    }
+
+    deadline_set(&fc->update_timeout, TYT60KW_UPDATE_TIMEOUT);
+    timebase_timer_start(&fc->host_timer, TYT60KW_HOST_TIMEOUT, 0, host_timeout, fc);
 }
 
 void tyt60kw_deinit(tyt60kw_t* fc)
@@ -118,8 +157,19 @@ void tyt60kw_task(tyt60kw_t* fc)
         [TYT60KW_DEINIT] = deinit,
     };
 
+    uint8_t i;
+
     assert(fc);
 
+    if (fc->trip && (fc->status != TYT60KW_ERROR))
+    {
+        /* 快速路徑已先關閉 IGN，狀態機跟上 */
+        tyt60kw_start(fc, false);
+        fc->flag.bits.ign_key = 0;
+        fc->status = TYT60KW_ERROR;
+        logger(fc, "fast path trip\r\n");
+    }
+
     fc_function[fc->status](fc);
 
     if (fc->config->light_tower)
@@ -134,26 +184,20 @@ void tyt60kw_task(tyt60kw_t* fc)
 
     if (fc->flag.bits.ign_key)
     {
-        if (fc->update_timeout < 200)
+        if (deadline_expired(&fc->update_timeout))
         {
-            if (++fc->update_timeout >= 200)
-            {
-                tyt60kw_error_stop(fc);
-                logger(fc, "data update timeout\r\n");
-            }
+            deadline_stop(&fc->update_timeout);
+            tyt60kw_error_stop(fc);
+            logger(fc, "data update timeout\r\n");
         }
     }
     else
     {
-        fc->update_timeout = 0;
-    }
+        deadline_set(&fc->update_timeout, TYT60KW_UPDATE_TIMEOUT);
 
-    if (fc->host_timeout < 200)
-    {
-        if (++fc->host_timeout >= 200)
+        for (i = 0; i < TYT60KW_SIGNAL_MAX; i++)
         {
-            tyt60kw_error_stop(fc);
-            logger(fc, "host connect timeout\r\n");
+            can_signal_reset(&fc->signal[i]);
         }
     }
 
@@ -189,6 +233,14 @@ void tyt60kw_start(tyt60kw_t* fc, bool enable)
     }
 }
 
+/* true: 停止運行後維持上電與點火並回到 IDLE，deinit 時一律斷電 */
+void tyt60kw_standby(tyt60kw_t* fc, bool enable)
+{
+    assert(fc);
+
+    fc->flag.bits.standby = enable;
+}
+
 void tyt60kw_clear_error(tyt60kw_t* fc)
 {
     assert(fc);
@@ -204,9 +256,11 @@ void tyt60kw_error_stop(tyt60kw_t* fc)
 {
     assert(fc);
 
+    /* 已在 error 時同樣要停止，避免清除錯誤後自行重新啟動 */
+    tyt60kw_start(fc, false);
+
     if (fc->status != TYT60KW_ERROR)
     {
-        tyt60kw_start(fc, false);
         fc->status = TYT60KW_ERROR;
         logger(fc, "other error stop\r\n");
     }
@@ -223,11 +277,32 @@ void tyt60kw_emerg_stop(tyt60kw_t* fc)
     }
 }
 
+/**
+ * @brief fuel cell 快速路徑觸發，功率命令立即歸零並要求斷開輸出 relay，由 tyt60kw_task() 進入錯誤狀態
+ *
+ * @param fc fuel cell 物件
+ *
+ * @note 可在接收中斷內調用，只設定旗標
+ */
+void tyt60kw_trip(tyt60kw_t* fc)
+{
+    fc->trip = true;
+}
+
+/* 主機連線逾時 (timebase_task() 內調用) */
+static void host_timeout(void* arg)
+{
+    tyt60kw_t* fc = (tyt60kw_t*)arg;
+
+    tyt60kw_error_stop(fc);
+    logger(fc, "host connect timeout\r\n");
+}
+
 void tyt60kw_host_connect(tyt60kw_t* fc)
 {
     assert(fc);
 
-    fc->host_timeout = 0;
+    timebase_timer_start(&fc->host_timer, TYT60KW_HOST_TIMEOUT, 0, host_timeout, fc);
 }
 
 void tyt60kw_host_packet(tyt60kw_t* fc, uint8_t data[8])
@@ -235,101 +310,98 @@ void tyt60kw_host_packet(tyt60kw_t* fc, uint8_t data[8])
     assert(fc);
     assert(data);
 
-    tyt60kw_data_t* packet = (tyt60kw_data_t*)data;
-
-    packet->bytes[0] = fc->status;
-    packet->bytes[1] = fc->error;
-    packet->bits[2].b0 = fc->flag.bits.start;
-    packet->bytes[3] = fc->power_setup;
-    packet->bytes[4] = 0x00;
-    packet->bytes[5] = 0x00;
-    packet->bytes[6] = 0x00;
+    host_tyt60kw_status_t packet =
+    {
+        .status = fc->status,
+        .error_level = fc->error,
+        .start = fc->flag.bits.start,
+        .power_setup = fc->power_setup,
+        .light_green = fc->light_tower.lg,
+        .light_yellow = fc->light_tower.ly,
+        .light_red = fc->light_tower.lr,
+        .buzzer = fc->light_tower.bz,
+    };
 
-    packet->bits[7].b0 = fc->light_tower.lg;
-    packet->bits[7].b1 = fc->light_tower.ly;
-    packet->bits[7].b2 = fc->light_tower.lr;
-    packet->bits[7].b3 = fc->light_tower.bz;
+    host_tyt60kw_status_pack(&packet, data);
 }
 
+/* 內容未變更時直接複製上次編碼的結果 */
 void tyt60kw_command(tyt60kw_t* fc, tyt60kw_command_t type, uint8_t data[8])
 {
-    uint16_t temp;
+    can_codec_frame_t* frame;
 
     assert(fc);
     assert(data);
 
-    tyt60kw_data_t* command = (tyt60kw_data_t*)data;
+    frame = tx_update(fc, type);
 
-    switch (type)
+    if (!frame)
     {
-        case TYT60KW_CMD_04E:
-        {
-            command->bytes[0] = 0;
-            command->bytes[1] = fc->power_max;
-
-            temp = fc->power_setup * 10;
-
-            command->bytes[2] = (uint8_t)((temp >> 8) & 0x0FU);
-            command->bits[2].b4 = fc->flag.bits.relay_off;
-
-            command->bytes[3] = (uint8_t)(temp & 0xFFU);
-            command->bytes[4] = 0;
-            command->bytes[5] = 0;
-            command->bytes[6] = ((uint8_t)fc->start_command << 4);
-            command->bytes[7] = 0;
-            break;
-        }
-        case TYT60KW_CMD_215:
-        {
-            command->lbyte[0] = 0;
-            command->lbyte[1] = 0;
-            break;
-        }
-        default: { break; }
+        return;
     }
+
+    frame->dirty = false;
+    can_codec_copy(data, frame->data);
 }
 
-void tyt60kw_update(tyt60kw_t* fc, tyt60kw_update_t type, uint8_t data[8])
+RAMFUNC void tyt60kw_update(tyt60kw_t* fc, tyt60kw_update_t type, uint8_t data[8])
 {
+    union
+    {
+        tyt60kw_fc_050_t fc_050;
+        tyt60kw_fc_051_t fc_051;
+        tyt60kw_fc_222_t fc_222;
+        tyt60kw_fc_225_t fc_225;
+        tyt60kw_fc_508_t fc_508;
+    } d;
+
     assert(fc);
     assert(data);
 
-    tyt60kw_data_t* d = (tyt60kw_data_t*)data;
-
     switch (type)
     {
         case TYT60KW_UPDATE_050:
         {
-            fc->fc_status = (tyt60kw_fc_status_t)((d->bytes[0] & 0x70U) >> 4);
-            fc->flag.bits.relay_status = d->bits[0].b7;
+            tyt60kw_fc_050_unpack(&d.fc_050, data);
+            fc->fc_status = (tyt60kw_fc_status_t)d.fc_050.fc_status;
+            fc->flag.bits.relay_status = d.fc_050.relay_status;
+            can_signal_update(&fc->signal[TYT60KW_SIGNAL_050], true);
             break;
         }
         case TYT60KW_UPDATE_051:
         {
-            fc->error = ((d->bytes[5] & 0xC0U) >> 6);
-            fc->pcu_voltage = ((d->bytes[6] << 8) | d->bytes[7]) & 0x7FFU;
+            tyt60kw_fc_051_unpack(&d.fc_051, data);
+            fc->error = d.fc_051.error_level;
+            fc->pcu_voltage = d.fc_051.pcu_voltage;
+            can_signal_update(&fc->signal[TYT60KW_SIGNAL_051], true);
             break;
         }
         case TYT60KW_UPDATE_222:
         {
-            fc->w_temp_fco = d->bytes[0];
+            tyt60kw_fc_222_unpack(&d.fc_222, data);
+            fc->w_temp_fco = d.fc_222.water_temp_fco;
+            can_signal_update(&fc->signal[TYT60KW_SIGNAL_222], true);
             break;
         }
         case TYT60KW_UPDATE_225:
         {
-            fc->pcu_temp = d->bytes[1];
+            tyt60kw_fc_225_unpack(&d.fc_225, data);
+            fc->pcu_temp = d.fc_225.pcu_temp;
+            can_signal_update(&fc->signal[TYT60KW_SIGNAL_225], true);
             break;
         }
         case TYT60KW_UPDATE_508:
         {
-            fc->error_code = d->bytes[7];
+            tyt60kw_fc_508_unpack(&d.fc_508, data);
+            fc->error_code = d.fc_508.error_code;
+            can_signal_update(&fc->signal[TYT60KW_SIGNAL_508], true);
             break;
         }
 
         default: { break; }
     }
 
-    fc->update_timeout = 0;
+    deadline_set(&fc->update_timeout, TYT60KW_UPDATE_TIMEOUT);
 }
 
 void tyt60kw_power(tyt60kw_t* fc, uint16_t power_kw)
@@ -343,10 +415,34 @@ void tyt60kw_power(tyt60kw_t* fc, uint16_t power_kw)
     }
 }
 
+void tyt60kw_bus_fault(tyt60kw_t* fc, bool fault)
+{
+    assert(fc);
+
+    if (fc->flag.bits.bus_fault != fault)
+    {
+        fc->flag.bits.bus_fault = fault;
+        logger(fc, "bus %s\r\n", fault ? "fault, derate" : "recovered");
+    }
+}
+
 /*--------------------------------------------------------------------------------------------------------*/
 
 static bool ems(tyt60kw_t* fc)
 {
+    if (fc->flag.bits.ign_key &&
+        (!can_signal_valid(&fc->signal[TYT60KW_SIGNAL_051]) ||
+        !can_signal_valid(&fc->signal[TYT60KW_SIGNAL_222])))
+    {
+        /* 錯誤等級或水溫停止更新時，不能沿用舊值判斷 */
+        fc->status = TYT60KW_ERROR;
+        logger(fc, "ems error, signal lost, 051: %d ms, 222: %d ms\r\n",
+            (int)(can_signal_age(&fc->signal[TYT60KW_SIGNAL_051]) / 1000U),
+            (int)(can_signal_age(&fc->signal[TYT60KW_SIGNAL_222]) / 1000U));
+
+        return true;
+    }
+
     if (fc->error > 0)
     {
         fc->status = TYT60KW_ERROR;
@@ -620,7 +716,15 @@ static void shutdown(tyt60kw_t* fc)
         }
         case WAIT:
         {
-            if ((fc->fc_status == TYT60KW_STOPPED) ||
+            if ((fc->fc_status == TYT60KW_STOPPED) &&
+                fc->flag.bits.standby && !fc->flag.bits.deinit)
+            {
+                /* 熱待機，維持上電與點火 */
+                fc->flag.bits.relay_off = 0;
+                fc->status = TYT60KW_IDLE;
+                logger(fc, "hot standby\r\n");
+            }
+            else if ((fc->fc_status == TYT60KW_STOPPED) ||
                 (fc->time_count == 1))
             {
                 fc->time_count = 450;
@@ -685,7 +789,8 @@ static void error(tyt60kw_t* fc)
     if (fc->flag.bits.clear_error)
     {
         logger(fc, "clear error\r\n");
-        fc->update_timeout = 0;
+        deadline_set(&fc->update_timeout, TYT60KW_UPDATE_TIMEOUT);
+        fc->trip = false;
         fc->status = !fc->flag.bits.deinit ? TYT60KW_INIT : TYT60KW_DEINIT;
         fc->flag.bits.clear_error = 0;
     }
@@ -697,6 +802,11 @@ static void deinit(tyt60kw_t* fc)
     {
         fc->status_old = fc->status;
 
+        /* 由 error 清除錯誤進入時不會經過 shutdown 的下電流程 */
+        fc->flag.bits.power_on = 0;
+        fc->flag.bits.ign_key = 0;
+        fc->flag.bits.relay_off = 0;
+
         logger(fc, "%s\r\n", __func__);
     }
 
@@ -706,3 +816,63 @@ static void deinit(tyt60kw_t* fc)
         fc->status = TYT60KW_INIT;
     }
 }
+
+/* 依目前狀態更新發送內容，欄位有變化才重新編碼並標記 dirty (215 固定為 0，只在初始化後編碼一次) */
+static can_codec_frame_t* tx_update(tyt60kw_t* fc, tyt60kw_command_t type)
+{
+    tyt60kw_ev_hv_1_t* cmd = &fc->tx.ev_hv_1;
+    can_codec_frame_t* frame;
+    uint16_t power;
+    uint8_t relay_off;
+
+    switch (type)
+    {
+        case TYT60KW_CMD_04E:
+        {
+            frame = &fc->tx.frame[TX_04E];
+            power = fc->power_setup;
+
+            if (fc->flag.bits.bus_fault && (power > TYT60KW_DERATE_POWER))
+            {
+                /* 通訊異常時先降載，不改變主機的設定值 */
+                power = TYT60KW_DERATE_POWER;
+            }
+
+            if (fc->trip)
+            {
+                power = 0;
+            }
+
+            power *= 10;
+            relay_off = (fc->flag.bits.relay_off | fc->trip);
+
+            if (frame->dirty ||
+                (cmd->power_max != fc->power_max) ||
+                (cmd->power_cmd != power) ||
+                (cmd->relay_off != relay_off) ||
+                (cmd->start_command != (uint8_t)fc->start_command))
+            {
+                cmd->power_max = fc->power_max;
+                cmd->power_cmd = power;
+                cmd->relay_off = relay_off;
+                cmd->start_command = (uint8_t)fc->start_command;
+                tyt60kw_ev_hv_1_pack(cmd, frame->data);
+                frame->dirty = true;
+            }
+            break;
+        }
+        case TYT60KW_CMD_215:
+        {
+            frame = &fc->tx.frame[TX_215];
+
+            if (frame->dirty)
+            {
+                tyt60kw_ev_hv_2_pack(&fc->tx.ev_hv_2, frame->data);
+            }
+            break;
+        }
+        default: { frame = NULL; break; }
+    }
+
+    return frame;
+}
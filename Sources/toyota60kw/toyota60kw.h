@@ -3,6 +3,14 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "timebase.h"
+#include "can_signal.h"
+#include "tyt60kw_codec.h"
+
+#define TYT60KW_UPDATE_TIMEOUT                  TIMEBASE_S(2)       /** 數據更新逾時 */
+#define TYT60KW_HOST_TIMEOUT                    TIMEBASE_S(2)       /** 主機連線逾時 */
+#define TYT60KW_DERATE_POWER                    (20U)       /** 通訊異常時的降載功率(KW) */
+#define TYT60KW_TX_MAX                          (2U)        /** 發送幀數量 (tyt60kw_command_t) */
 
 typedef enum tyt60kw_status
 {
@@ -58,24 +66,15 @@ typedef enum tyt60kw_update
     TYT60KW_UPDATE_508 = 0x508,
 } tyt60kw_update_t;
 
-typedef union tyt60kw_data
+typedef enum tyt60kw_signal
 {
-    struct
-    {
-        uint8_t b0 : 1;
-        uint8_t b1 : 1;
-        uint8_t b2 : 1;
-        uint8_t b3 : 1;
-        uint8_t b4 : 1;
-        uint8_t b5 : 1;
-        uint8_t b6 : 1;
-        uint8_t b7 : 1;
-    } bits[8];
-
-    uint8_t bytes[8];
-    uint16_t wbyte[4];
-    uint32_t lbyte[2];
-} tyt60kw_data_t;
+    TYT60KW_SIGNAL_050 = 0,                 /** fc_status, relay_status */
+    TYT60KW_SIGNAL_051,                     /** error, pcu_voltage */
+    TYT60KW_SIGNAL_222,                     /** w_temp_fco */
+    TYT60KW_SIGNAL_225,                     /** pcu_temp */
+    TYT60KW_SIGNAL_508,                     /** error_code */
+    TYT60KW_SIGNAL_MAX,
+} tyt60kw_signal_t;
 
 typedef struct tyt60kw_light_tower
 {
@@ -98,13 +97,22 @@ typedef union tyt60kw_flag
         uint8_t relay_off : 1;
         uint8_t relay_status : 1;
         // uint8_t relay_reliability : 1;   
-        uint8_t : 8;
+        uint8_t bus_fault : 1;
+        uint8_t standby : 1;
+        uint8_t : 6;
     } bits;
 
     uint16_t all;
 
 } tyt60kw_flag_t;
 
+typedef struct tyt60kw_tx
+{
+    tyt60kw_ev_hv_1_t ev_hv_1;      /** 目前的發送內容 (raw) */
+    tyt60kw_ev_hv_2_t ev_hv_2;
+    can_codec_frame_t frame[TYT60KW_TX_MAX];
+} tyt60kw_tx_t;
+
 typedef struct tyt60kw_config
 {
     const char* name;
@@ -129,11 +137,14 @@ typedef struct tyt60kw
     uint8_t step;
     uint32_t time_count;
     uint16_t cooling_time;
-    uint16_t update_timeout;
-    uint16_t host_timeout;
+    deadline_t update_timeout;
+    timebase_timer_t host_timer;    /** 主機連線逾時，收到主機封包時重新計時 */
+    can_signal_t signal[TYT60KW_SIGNAL_MAX];
+    volatile bool trip;             /** 接收中斷的快速路徑已觸發，清除錯誤前維持 */
     uint8_t cooling_fan_speed_ps_h;
     uint8_t cooling_fan_speed_ps_l;
 
+    tyt60kw_tx_t tx;
     tyt60kw_flag_t flag;
     tyt60kw_status_t status;
     tyt60kw_status_t status_old;
@@ -146,13 +157,16 @@ void tyt60kw_deinit(tyt60kw_t* fc);
 void tyt60kw_task(tyt60kw_t* fc);
 tyt60kw_status_t tyt60kw_status(tyt60kw_t* fc);
 void tyt60kw_start(tyt60kw_t* fc, bool enable);
+void tyt60kw_standby(tyt60kw_t* fc, bool enable);
 void tyt60kw_clear_error(tyt60kw_t* fc);
 void tyt60kw_error_stop(tyt60kw_t* fc);
 void tyt60kw_emerg_stop(tyt60kw_t* fc);
+void tyt60kw_trip(tyt60kw_t* fc);
 void tyt60kw_host_connect(tyt60kw_t* fc);
 void tyt60kw_host_packet(tyt60kw_t* fc, uint8_t data[8]);
 void tyt60kw_command(tyt60kw_t* fc, tyt60kw_command_t type, uint8_t data[8]);
 void tyt60kw_update(tyt60kw_t* fc, tyt60kw_update_t type, uint8_t data[8]);
 void tyt60kw_power(tyt60kw_t* fc, uint16_t power_kw);
+void tyt60kw_bus_fault(tyt60kw_t* fc, bool fault);
 
 #endif
@@ -0,0 +1,258 @@
+#include "uart_txq.h"
+#include <string.h>
+#include <assert.h>
+
+#define UART_TXQ_NO_ARENA                       (0xFFFFU)
+
+/**
+ * @brief 由 arena 配置一段連續空間，尾端不足時從頭開始 (尾端空間在釋放前不再使用)
+ *
+ * @return 起始位置，UART_TXQ_NO_ARENA: 空間不足
+ */
+static uint16_t arena_alloc(uart_txq_t* q, uint16_t size)
+{
+    uint16_t head = q->arena_head;
+    uint16_t tail = q->arena_tail;
+    uint16_t start;
+
+    if (head == tail)
+    {
+        /* 已全部釋放，沒有待釋放的 arena 描述項，中斷不會再更新 arena_tail，可從頭開始 */
+        q->arena_tail = 0;
+        head = 0;
+        tail = 0;
+    }
+
+    if (head >= tail)
+    {
+        /* 寫入位置不可追上讀取位置，否則無法區分滿與空 */
+        if (((uint32_t)head + size < q->arena_size) || (((uint32_t)head + size == q->arena_size) && (tail != 0U)))
+        {
+            start = head;
+        }
+        else if (size < tail)
+        {
+            start = 0;
+        }
+        else
+        {
+            return UART_TXQ_NO_ARENA;
+        }
+    }
+    else if (size < (uint16_t)(tail - head))
+    {
+        start = head;
+    }
+    else
+    {
+        return UART_TXQ_NO_ARENA;
+    }
+
+    q->arena_head = (uint16_t)((start + size) % q->arena_size);
+
+    return start;
+}
+
+/**
+ * @brief 放入一個描述項
+ */
+static void push(uart_txq_t* q, const uint8_t* data, uint16_t size, uint16_t arena_end)
+{
+    uart_txq_entry_t* entry;
+
+    entry = &q->entry[UART_TXQ_SLOT(q->head)];
+    entry->data = data;
+    entry->size = size;
+    entry->arena_end = arena_end;
+
+    /* 描述項與 arena 的內容需在 head 公開前完成寫入 (Cortex-M4 上為 DMB，同時是編譯器屏障) */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    q->head++;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 發送佇列初始化
+ *
+ * @param q 佇列物件
+ * @param arena 複製暫存區，NULL 表示只接受 uart_txq_post()
+ * @param size 暫存區大小
+ */
+void uart_txq_init(uart_txq_t* q, uint8_t* arena, uint16_t size)
+{
+    assert(q);
+    assert(arena || (size == 0));
+
+    q->head = 0;
+    q->issued = 0;
+    q->tail = 0;
+    q->arena = arena;
+    q->arena_size = size;
+    q->arena_head = 0;
+    q->arena_tail = 0;
+    q->dropped = 0;
+}
+
+/**
+ * @brief 直接以呼叫者的緩衝排入發送 (zero-copy)
+ *
+ * @param q 佇列物件
+ * @param data 資料，uart_txq_sent() 回傳 true 前不可修改
+ * @param size 長度
+ *
+ * @return true 已排入
+ * @return false 佇列已滿，資料丟棄
+ *
+ * @note 只能由單一生產者 (主迴圈) 調用，不會阻塞
+ */
+bool uart_txq_post(uart_txq_t* q, const uint8_t* data, uint16_t size)
+{
+    assert(q);
+    assert(data || (size == 0));
+
+    if ((size == 0) || (size > UART_TXQ_SIZE_MAX))
+    {
+        return false;
+    }
+
+    if ((uint8_t)(q->head - q->tail) >= UART_TXQ_ENTRY_MAX)
+    {
+        q->dropped += size;
+        return false;
+    }
+
+    push(q, data, size, UART_TXQ_NO_ARENA);
+
+    return true;
+}
+
+/**
+ * @brief 複製到 arena 後排入發送，給呼叫後即失效的緩衝 (堆疊上的 log 字串)
+ *
+ * @param q 佇列物件
+ * @param data 資料
+ * @param size 長度
+ *
+ * @return true 已排入
+ * @return false 佇列或 arena 已滿，資料丟棄
+ *
+ * @note 只能由單一生產者 (主迴圈) 調用，不會阻塞
+ */
+bool uart_txq_write(uart_txq_t* q, const uint8_t* data, uint16_t size)
+{
+    uint16_t start;
+
+    assert(q);
+    assert(data || (size == 0));
+
+    if ((size == 0) || (size > UART_TXQ_SIZE_MAX))
+    {
+        return false;
+    }
+
+    if (((uint8_t)(q->head - q->tail) >= UART_TXQ_ENTRY_MAX) || (size >= q->arena_size))
+    {
+        q->dropped += size;
+        return false;
+    }
+
+    start = arena_alloc(q, size);
+
+    if (start == UART_TXQ_NO_ARENA)
+    {
+        q->dropped += size;
+        return false;
+    }
+
+    memcpy(&q->arena[start], data, size);
+
+    push(q, &q->arena[start], size, q->arena_head);
+
+    return true;
+}
+
+/**
+ * @brief 取出尚未交給 DMA 的描述項
+ *
+ * @param q 佇列物件
+ * @param first 第一個描述項的位置 (UART_TXQ_SLOT() 之前的序號)
+ *
+ * @return uint8_t 數量，0: 沒有新資料
+ *
+ * @note 取出的描述項在 uart_txq_release() 前保持不變，可直接建立 DMA 串接
+ */
+uint8_t uart_txq_issue(uart_txq_t* q, uint8_t* first)
+{
+    uint8_t count;
+
+    assert(q);
+    assert(first);
+
+    *first = q->issued;
+    count = (uint8_t)(q->head - q->issued);
+    q->issued = q->head;
+
+    return count;
+}
+
+/**
+ * @brief 釋放已發送完成的描述項與 arena 空間
+ *
+ * @param q 佇列物件
+ * @param count 完成的數量 (依 uart_txq_issue() 的順序)
+ *
+ * @note 在 DMA 完成中斷內調用
+ */
+void uart_txq_release(uart_txq_t* q, uint8_t count)
+{
+    const uart_txq_entry_t* entry;
+
+    assert(q);
+
+    while (count--)
+    {
+        entry = &q->entry[UART_TXQ_SLOT(q->tail)];
+
+        if (entry->arena_end != UART_TXQ_NO_ARENA)
+        {
+            q->arena_tail = entry->arena_end;
+        }
+
+        q->tail++;
+    }
+}
+
+/**
+ * @brief 是否有已交給 DMA 但尚未完成的描述項
+ */
+bool uart_txq_busy(const uart_txq_t* q)
+{
+    assert(q);
+
+    return q->issued != q->tail;
+}
+
+/**
+ * @brief uart_txq_post() 的緩衝是否已發送完成，可重新使用
+ *
+ * @param q 佇列物件
+ * @param data uart_txq_post() 傳入的緩衝
+ */
+bool uart_txq_sent(const uart_txq_t* q, const uint8_t* data)
+{
+    uint8_t i;
+
+    assert(q);
+
+    for (i = q->tail; i != q->head; i++)
+    {
+        if (q->entry[UART_TXQ_SLOT(i)].data == data)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef _uart_txq_h_
+#define _uart_txq_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UART_TXQ_ENTRY_MAX                      (16U)       /** 描述項數量 (2 的冪次)，即一次 DMA 串接的最大段數 */
+#define UART_TXQ_SIZE_MAX                       (32767U)    /** 單段最大長度 (eDMA CITER 15 bits) */
+#define UART_TXQ_SLOT(n)                        ((uint8_t)((n) & (UART_TXQ_ENTRY_MAX - 1U)))
+
+typedef struct uart_txq_entry
+{
+    const uint8_t* data;
+    uint16_t size;
+    uint16_t arena_end;             /** 釋放後 arena 的讀取位置，UART_TXQ_NO_ARENA: 不在 arena 內 (zero-copy) */
+} uart_txq_entry_t;
+
+typedef struct uart_txq
+{
+    uart_txq_entry_t entry[UART_TXQ_ENTRY_MAX];
+    volatile uint8_t head;          /** 下一個寫入的描述項 (生產者) */
+    volatile uint8_t issued;        /** 下一個交給 DMA 的描述項 */
+    volatile uint8_t tail;          /** 下一個待釋放的描述項 (DMA 完成中斷) */
+    uint8_t* arena;                 /** 複製暫存區，給呼叫後即失效的緩衝使用 */
+    uint16_t arena_size;
+    uint16_t arena_head;
+    volatile uint16_t arena_tail;
+    uint32_t dropped;               /** 佇列或 arena 已滿而丟棄的 bytes */
+} uart_txq_t;
+
+void uart_txq_init(uart_txq_t* q, uint8_t* arena, uint16_t size);
+bool uart_txq_post(uart_txq_t* q, const uint8_t* data, uint16_t size);
+bool uart_txq_write(uart_txq_t* q, const uint8_t* data, uint16_t size);
+uint8_t uart_txq_issue(uart_txq_t* q, uint8_t* first);
+void uart_txq_release(uart_txq_t* q, uint8_t count);
+bool uart_txq_busy(const uart_txq_t* q);
+bool uart_txq_sent(const uart_txq_t* q, const uint8_t* data);
+
+#endif
@@ -0,0 +1,566 @@
+#include "uds.h"
+#include <stddef.h>
+#include <assert.h>
+
+#define SID_SESSION_CONTROL                     (0x10U)
+#define SID_READ_DATA                           (0x22U)
+#define SID_READ_MEMORY                         (0x23U)
+#define SID_IO_CONTROL                          (0x2FU)
+#define SID_ROUTINE_CONTROL                     (0x31U)
+#define SID_TESTER_PRESENT                      (0x3EU)
+#define SID_NEGATIVE                            (0x7FU)
+#define SID_POSITIVE                            (0x40U)
+
+#define SUPPRESS_POSITIVE                       (0x80U)     /** sub-function 最高位元: 不需要正面回應 */
+
+typedef uint8_t (*service_handler_t)(uds_t* uds, const uint8_t* data, uint16_t size);
+
+typedef struct service
+{
+    uint8_t sid;                    /** 表格依 SID 遞增排列 */
+    uint8_t min_size;               /** 含 SID 的最短請求長度 */
+    bool subfunction;               /** 第 2 byte 為 sub-function (可抑制正面回應) */
+    bool extended;                  /** 只允許在 extended session 使用 */
+    service_handler_t handler;
+} service_t;
+
+static uint8_t session_control(uds_t* uds, const uint8_t* data, uint16_t size);
+static uint8_t read_data(uds_t* uds, const uint8_t* data, uint16_t size);
+static uint8_t read_memory(uds_t* uds, const uint8_t* data, uint16_t size);
+static uint8_t io_control(uds_t* uds, const uint8_t* data, uint16_t size);
+static uint8_t routine_control(uds_t* uds, const uint8_t* data, uint16_t size);
+static uint8_t tester_present(uds_t* uds, const uint8_t* data, uint16_t size);
+
+static const service_t service[] =
+{
+    { SID_SESSION_CONTROL, 2, true, false, session_control, },
+    { SID_READ_DATA, 3, false, false, read_data, },
+    { SID_READ_MEMORY, 4, false, false, read_memory, },
+    { SID_IO_CONTROL, 4, false, true, io_control, },
+    { SID_ROUTINE_CONTROL, 4, true, true, routine_control, },
+    { SID_TESTER_PRESENT, 2, true, false, tester_present, },
+};
+
+/**
+ * @brief 以 SID 找出服務 (二分搜尋)
+ *
+ * @return NULL: 不支援
+ */
+static const service_t* service_find(uint8_t sid)
+{
+    uint8_t low = 0;
+    uint8_t high = sizeof(service) / sizeof(service[0]);
+    uint8_t mid;
+
+    while (low < high)
+    {
+        mid = (uint8_t)((low + high) / 2U);
+
+        if (service[mid].sid == sid)
+        {
+            return &service[mid];
+        }
+
+        if (service[mid].sid < sid)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 以 DID 找出表項目 (二分搜尋)
+ *
+ * @return NULL: 不支援
+ */
+static const uds_did_t* did_find(const uds_config_t* config, uint16_t did)
+{
+    uint16_t low = 0;
+    uint16_t high = config->did_count;
+    uint16_t mid;
+
+    while (low < high)
+    {
+        mid = (uint16_t)((low + high) / 2U);
+
+        if (config->did[mid].did == did)
+        {
+            return &config->did[mid];
+        }
+
+        if (config->did[mid].did < did)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 以 ID 找出 IO 控制或 routine 表項目 (二分搜尋)
+ *
+ * @return NULL: 不支援
+ */
+static const uds_control_t* control_find(const uds_control_t* table, uint16_t count, uint16_t id)
+{
+    uint16_t low = 0;
+    uint16_t high = count;
+    uint16_t mid;
+
+    while (low < high)
+    {
+        mid = (uint16_t)((low + high) / 2U);
+
+        if (table[mid].id == id)
+        {
+            return &table[mid];
+        }
+
+        if (table[mid].id < id)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 切換 session 並通知上層
+ */
+static void session_change(uds_t* uds, uds_session_t session)
+{
+    if (uds->session == session)
+    {
+        return;
+    }
+
+    uds->session = session;
+
+    if (session == UDS_SESSION_DEFAULT)
+    {
+        deadline_stop(&uds->s3);
+    }
+
+    if (uds->config->session)
+    {
+        uds->config->session(uds->handle, session);
+    }
+}
+
+/**
+ * @brief DiagnosticSessionControl (0x10)
+ */
+static uint8_t session_control(uds_t* uds, const uint8_t* data, uint16_t size)
+{
+    uint8_t session = data[1] & (uint8_t)~SUPPRESS_POSITIVE;
+
+    if (size != 2U)
+    {
+        return UDS_NRC_INCORRECT_LENGTH;
+    }
+
+    if ((session != UDS_SESSION_DEFAULT) && (session != UDS_SESSION_EXTENDED))
+    {
+        return UDS_NRC_SUBFUNCTION_NOT_SUPPORTED;
+    }
+
+    session_change(uds, (uds_session_t)session);
+
+    if (session != UDS_SESSION_DEFAULT)
+    {
+        deadline_set(&uds->s3, UDS_S3_TIMEOUT);
+    }
+
+    uds->response[uds->length++] = session;
+    uds->response[uds->length++] = (uint8_t)(UDS_P2 >> 8);
+    uds->response[uds->length++] = (uint8_t)UDS_P2;
+    uds->response[uds->length++] = (uint8_t)(UDS_P2_EXT >> 8);
+    uds->response[uds->length++] = (uint8_t)UDS_P2_EXT;
+
+    return UDS_NRC_NONE;
+}
+
+/**
+ * @brief ReadDataByIdentifier (0x22)，可一次讀取多個 DID
+ *
+ * @note 陣列或結構的 DID 單獨讀取時直接由來源發送，與其他 DID 一起讀取時複製到回應表頭
+ */
+static uint8_t read_data(uds_t* uds, const uint8_t* data, uint16_t size)
+{
+    const uds_did_t* did;
+    const volatile uint8_t* src;
+    uint32_t value;
+    uint16_t count = (size - 1U) / 2U;
+    uint16_t i;
+    uint16_t j;
+
+    if (((size - 1U) % 2U) != 0)
+    {
+        return UDS_NRC_INCORRECT_LENGTH;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        did = did_find(uds->config, ((uint16_t)data[1 + (i * 2)] << 8) | data[2 + (i * 2)]);
+
+        if (did == NULL)
+        {
+            return UDS_NRC_OUT_OF_RANGE;
+        }
+
+        if ((uds->length + 2U + did->size) > UDS_RESPONSE_MAX)
+        {
+            if ((count == 1U) && (did->size <= UDS_READ_MAX))
+            {
+                uds->response[uds->length++] = data[1];
+                uds->response[uds->length++] = data[2];
+                uds->body = (const uint8_t*)did->data;
+                uds->body_size = did->size;
+                return UDS_NRC_NONE;
+            }
+
+            return UDS_NRC_RESPONSE_TOO_LONG;
+        }
+
+        uds->response[uds->length++] = data[1 + (i * 2)];
+        uds->response[uds->length++] = data[2 + (i * 2)];
+
+        switch (did->size)
+        {
+            case 1: { value = *(const volatile uint8_t*)did->data; break; }
+            case 2: { value = *(const volatile uint16_t*)did->data; break; }
+            case 4: { value = *(const volatile uint32_t*)did->data; break; }
+            default:
+            {
+                src = (const volatile uint8_t*)did->data;
+
+                for (j = 0; j < did->size; j++)
+                {
+                    uds->response[uds->length++] = src[j];
+                }
+                continue;
+            }
+        }
+
+        for (j = did->size; j > 0; j--)
+        {
+            uds->response[uds->length++] = (uint8_t)(value >> ((j - 1U) * 8U));
+        }
+    }
+
+    return UDS_NRC_NONE;
+}
+
+/**
+ * @brief ReadMemoryByAddress (0x23)，資料直接由記憶體發送
+ *
+ * @note 只允許讀取 config->memory 內的區間，位址與長度各 1 ~ 4 bytes (大端序)
+ */
+static uint8_t read_memory(uds_t* uds, const uint8_t* data, uint16_t size)
+{
+    uint8_t address_len = data[1] & 0x0FU;
+    uint8_t size_len = data[1] >> 4;
+    uint32_t address = 0;
+    uint32_t length = 0;
+    uint8_t i;
+
+    if ((address_len == 0) || (address_len > 4U) || (size_len == 0) || (size_len > 4U))
+    {
+        return UDS_NRC_OUT_OF_RANGE;
+    }
+
+    if (size != (2U + address_len + size_len))
+    {
+        return UDS_NRC_INCORRECT_LENGTH;
+    }
+
+    for (i = 0; i < address_len; i++)
+    {
+        address = (address << 8) | data[2 + i];
+    }
+
+    for (i = 0; i < size_len; i++)
+    {
+        length = (length << 8) | data[2 + address_len + i];
+    }
+
+    if ((length == 0) || (length > UDS_READ_MAX))
+    {
+        return UDS_NRC_OUT_OF_RANGE;
+    }
+
+    for (i = 0; i < uds->config->memory_count; i++)
+    {
+        if ((address >= uds->config->memory[i].start) &&
+            (((uint64_t)address + length) <= ((uint64_t)uds->config->memory[i].start + uds->config->memory[i].size)))
+        {
+            uds->body = (const uint8_t*)(uintptr_t)address;
+            uds->body_size = (uint16_t)length;
+            return UDS_NRC_NONE;
+        }
+    }
+
+    return UDS_NRC_OUT_OF_RANGE;
+}
+
+/**
+ * @brief InputOutputControlByIdentifier (0x2F)
+ */
+static uint8_t io_control(uds_t* uds, const uint8_t* data, uint16_t size)
+{
+    const uds_control_t* io;
+    uint8_t nrc;
+    uint16_t i;
+
+    io = control_find(uds->config->io, uds->config->io_count, ((uint16_t)data[1] << 8) | data[2]);
+
+    if ((io == NULL) || (uds->config->io_control == NULL))
+    {
+        return UDS_NRC_OUT_OF_RANGE;
+    }
+
+    nrc = uds->config->io_control(uds->handle, io->arg, data[3], &data[4], size - 4U);
+
+    if (nrc != UDS_NRC_NONE)
+    {
+        return nrc;
+    }
+
+    /* 回應回傳 DID、控制參數與控制狀態 */
+    for (i = 1; (i < size) && (uds->length < UDS_RESPONSE_MAX); i++)
+    {
+        uds->response[uds->length++] = data[i];
+    }
+
+    return UDS_NRC_NONE;
+}
+
+/**
+ * @brief RoutineControl (0x31)
+ */
+static uint8_t routine_control(uds_t* uds, const uint8_t* data, uint16_t size)
+{
+    const uds_control_t* routine;
+    uint8_t type = data[1] & (uint8_t)~SUPPRESS_POSITIVE;
+    uint8_t nrc;
+
+    routine = control_find(uds->config->routine, uds->config->routine_count, ((uint16_t)data[2] << 8) | data[3]);
+
+    if ((routine == NULL) || (uds->config->routine_control == NULL))
+    {
+        return UDS_NRC_OUT_OF_RANGE;
+    }
+
+    nrc = uds->config->routine_control(uds->handle, routine->arg, type, &data[4], size - 4U);
+
+    if (nrc != UDS_NRC_NONE)
+    {
+        return nrc;
+    }
+
+    uds->response[uds->length++] = type;
+    uds->response[uds->length++] = data[2];
+    uds->response[uds->length++] = data[3];
+
+    return UDS_NRC_NONE;
+}
+
+/**
+ * @brief TesterPresent (0x3E)，維持目前的 session
+ */
+static uint8_t tester_present(uds_t* uds, const uint8_t* data, uint16_t size)
+{
+    if (size != 2U)
+    {
+        return UDS_NRC_INCORRECT_LENGTH;
+    }
+
+    if ((data[1] & (uint8_t)~SUPPRESS_POSITIVE) != 0)
+    {
+        return UDS_NRC_SUBFUNCTION_NOT_SUPPORTED;
+    }
+
+    uds->response[uds->length++] = 0x00;
+
+    return UDS_NRC_NONE;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief UDS (ISO 14229) 診斷伺服器初始化
+ *
+ * @param uds 伺服器物件
+ * @param handle 傳給回呼的物件
+ * @param config DID / IO / routine 表 (皆依 ID 遞增排列)、可讀取的記憶體區間與回呼
+ */
+void uds_init(uds_t* uds, const void* handle, const uds_config_t* config)
+{
+    uint16_t i;
+
+    assert(uds);
+    assert(config);
+    assert(config->send);
+
+    for (i = 1; i < (sizeof(service) / sizeof(service[0])); i++)
+    {
+        assert(service[i - 1U].sid < service[i].sid);
+    }
+
+    for (i = 1; i < config->did_count; i++)
+    {
+        assert(config->did[i - 1U].did < config->did[i].did);
+    }
+
+    for (i = 1; i < config->io_count; i++)
+    {
+        assert(config->io[i - 1U].id < config->io[i].id);
+    }
+
+    for (i = 1; i < config->routine_count; i++)
+    {
+        assert(config->routine[i - 1U].id < config->routine[i].id);
+    }
+
+    uds->handle = handle;
+    uds->session = UDS_SESSION_DEFAULT;
+    uds->request = 0;
+    uds->negative = 0;
+    uds->config = config;
+
+    deadline_stop(&uds->s3);
+}
+
+/**
+ * @brief 處理一個完整的請求 (傳輸層重組完成)
+ *
+ * @param uds 伺服器物件
+ * @param data 請求
+ * @param size 長度
+ * @param functional true: 功能定址，不支援的服務不回應
+ *
+ * @note 所有服務皆立即完成，不使用 response pending (0x78)
+ */
+void uds_request(uds_t* uds, const uint8_t* data, uint16_t size, bool functional)
+{
+    const service_t* s;
+    uint8_t nrc;
+    bool suppress = false;
+
+    assert(uds);
+    assert(data);
+
+    if (size == 0)
+    {
+        return;
+    }
+
+    uds->request++;
+    uds->response[0] = data[0] | SID_POSITIVE;
+    uds->length = 1;
+    uds->body = NULL;
+    uds->body_size = 0;
+
+    s = service_find(data[0]);
+
+    if (s == NULL)
+    {
+        nrc = UDS_NRC_SERVICE_NOT_SUPPORTED;
+    }
+    else if (size < s->min_size)
+    {
+        nrc = UDS_NRC_INCORRECT_LENGTH;
+    }
+    else if (s->extended && (uds->session != UDS_SESSION_EXTENDED))
+    {
+        nrc = UDS_NRC_NOT_IN_SESSION;
+    }
+    else
+    {
+        suppress = s->subfunction && (data[1] & SUPPRESS_POSITIVE);
+
+        if (uds->session != UDS_SESSION_DEFAULT)
+        {
+            deadline_set(&uds->s3, UDS_S3_TIMEOUT);
+        }
+
+        nrc = s->handler(uds, data, size);
+    }
+
+    if (nrc == UDS_NRC_NONE)
+    {
+        if (!suppress)
+        {
+            (void)uds->config->send(uds->handle, &uds->response[0], uds->length, uds->body, uds->body_size);
+        }
+        return;
+    }
+
+    uds->negative++;
+
+    /* 功能定址時不回應不支援的服務、sub-function 或參數 */
+    if (functional && ((nrc == UDS_NRC_SERVICE_NOT_SUPPORTED) || (nrc == UDS_NRC_SUBFUNCTION_NOT_SUPPORTED) ||
+        (nrc == UDS_NRC_OUT_OF_RANGE) || (nrc == UDS_NRC_NOT_IN_SESSION)))
+    {
+        return;
+    }
+
+    uds->response[0] = SID_NEGATIVE;
+    uds->response[1] = data[0];
+    uds->response[2] = nrc;
+
+    (void)uds->config->send(uds->handle, &uds->response[0], 3, NULL, 0);
+}
+
+/**
+ * @brief S3 逾時處理，每次主迴圈調用
+ *
+ * @note 發送中傳輸層不接受新請求 (含 TesterPresent)，而分段回應可能遠超過 S3
+ *       (4094 bytes 在 STmin 127 ms 時約 70 s)，因此發送期間持續重設 S3，由發送完畢起算
+ */
+void uds_task(uds_t* uds)
+{
+    assert(uds);
+
+    if (uds->session == UDS_SESSION_DEFAULT)
+    {
+        return;
+    }
+
+    if (uds->config->busy && uds->config->busy(uds->handle))
+    {
+        deadline_set(&uds->s3, UDS_S3_TIMEOUT);
+        return;
+    }
+
+    if (deadline_expired(&uds->s3))
+    {
+        session_change(uds, UDS_SESSION_DEFAULT);
+    }
+}
+
+/**
+ * @brief 目前的 session
+ */
+uds_session_t uds_session(uds_t* uds)
+{
+    assert(uds);
+
+    return uds->session;
+}
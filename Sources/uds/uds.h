@@ -0,0 +1,95 @@
+#ifndef _uds_h_
+#define _uds_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timebase.h"
+
+#define UDS_RESPONSE_MAX                        (64U)       /** 回應表頭 (複製部分)，大筆資料以本體直接指向來源 */
+#define UDS_READ_MAX                            (4094U)     /** 單次讀取的本體上限 (ISO-TP 4095 - 回應碼) */
+#define UDS_S3_TIMEOUT                          TIMEBASE_S(5)       /** 非預設 session 無請求時回到預設 (由回應發送完畢起算) */
+#define UDS_P2                                  (50U)       /** 回應時間 (ms) */
+#define UDS_P2_EXT                              (500U)      /** 延長回應時間 (10 ms) */
+
+#define UDS_NRC_NONE                            (0x00U)
+#define UDS_NRC_SERVICE_NOT_SUPPORTED           (0x11U)
+#define UDS_NRC_SUBFUNCTION_NOT_SUPPORTED       (0x12U)
+#define UDS_NRC_INCORRECT_LENGTH                (0x13U)
+#define UDS_NRC_RESPONSE_TOO_LONG               (0x14U)
+#define UDS_NRC_CONDITIONS_NOT_CORRECT          (0x22U)
+#define UDS_NRC_OUT_OF_RANGE                    (0x31U)
+#define UDS_NRC_NOT_IN_SESSION                  (0x7FU)
+
+/**
+ * DID 表項目，1/2/4 bytes 以大端序輸出數值 (bool 與 enum 皆可)，
+ * 其他長度 (陣列、結構) 原樣輸出記憶體內容，且需單獨讀取以直接由來源發送
+ */
+#define UDS_DID(id, var)                        { (id), sizeof(var), &(var) }
+
+typedef enum uds_session
+{
+    UDS_SESSION_DEFAULT = 0x01,
+    UDS_SESSION_EXTENDED = 0x03,
+} uds_session_t;
+
+typedef struct uds_did
+{
+    uint16_t did;                   /** 表格需依 DID 遞增排列 */
+    uint16_t size;
+    const volatile void* data;
+} uds_did_t;
+
+typedef struct uds_control
+{
+    uint16_t id;                    /** IO 控制的 DID 或 routine ID，表格需依 ID 遞增排列 */
+    uint32_t arg;                   /** 傳給回呼的參數 */
+} uds_control_t;
+
+typedef struct uds_memory
+{
+    uint32_t start;                 /** 可由 ReadMemoryByAddress 讀取的區間 */
+    uint32_t size;
+} uds_memory_t;
+
+typedef struct uds_config
+{
+    const uds_did_t* did;
+    uint16_t did_count;
+    const uds_control_t* io;
+    uint16_t io_count;
+    const uds_control_t* routine;
+    uint16_t routine_count;
+    const uds_memory_t* memory;
+    uint8_t memory_count;
+
+    /* 回傳 NRC，UDS_NRC_NONE: 成功 */
+    uint8_t (*io_control)(const void* handle, uint32_t arg, uint8_t param, const uint8_t* state, uint16_t size);
+    uint8_t (*routine_control)(const void* handle, uint32_t arg, uint8_t type, const uint8_t* option, uint16_t size);
+    void (*session)(const void* handle, uds_session_t session);
+    bool (*send)(const void* handle, const uint8_t* head, uint16_t head_size, const uint8_t* body, uint16_t body_size);
+    bool (*busy)(const void* handle);       /** 回應仍在發送 (分段)，可為 NULL */
+} uds_config_t;
+
+typedef struct uds
+{
+    const void* handle;
+    uds_session_t session;
+    deadline_t s3;
+
+    uint8_t response[UDS_RESPONSE_MAX];
+    uint16_t length;                /** 回應表頭長度 */
+    const uint8_t* body;            /** 回應本體，NULL: 沒有 */
+    uint16_t body_size;
+
+    uint32_t request;
+    uint32_t negative;
+
+    const uds_config_t* config;
+} uds_t;
+
+void uds_init(uds_t* uds, const void* handle, const uds_config_t* config);
+void uds_request(uds_t* uds, const uint8_t* data, uint16_t size, bool functional);
+void uds_task(uds_t* uds);
+uds_session_t uds_session(uds_t* uds);
+
+#endif
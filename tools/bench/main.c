@@ -0,0 +1,118 @@
+/*
+ * fc135kw / tyt60kw / bidc300100 驅動的 micro-benchmark，在 PC 上執行 Sources/bench/bench_suite.c 的項目
+ *
+ * build (repo 根目錄):
+ *   gcc -O2 -std=gnu99 -ISources/bench -ISources/timebase -ISources/can_signal -ISources/can_codec -ISources/ramfunc \
+ *       -ISources/fc135kw -ISources/toyota60kw -ISources/bidc300100 tools/bench/main.c \
+ *       Sources/bench/bench.c Sources/bench/bench_suite.c \
+ *       Sources/timebase/timebase.c Sources/can_signal/can_signal.c \
+ *       Sources/can_codec/fc135kw_codec.c Sources/can_codec/tyt60kw_codec.c Sources/can_codec/host_codec.c \
+ *       Sources/fc135kw/fc135kw.c Sources/toyota60kw/toyota60kw.c \
+ *       Sources/bidc300100/bidc300100.c Sources/bidc300100/bidc300100_bank.c -o bench
+ *   ./bench [-o file.json] [filter]         filter: 只量測名稱包含該字串的項目
+ *
+ * 輸出與 Google Benchmark 的 --benchmark_format=json 相容，可直接用 compare.py 比較兩次結果；
+ * 目標板上的量測見 Sources/app_bench.c (APP_BENCH)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "timebase.h"
+#include "bench_suite.h"
+
+#define CASE_MAX                                (64U)
+
+static FILE* out;
+
+/* 時基固定不前進，逾時不會在量測中觸發 */
+static uint32_t host_counter(void)
+{
+    return 0;
+}
+
+static const timebase_config_t host_timebase =
+{
+    .period = TIMEBASE_MS(1),
+    .counter = host_counter,
+    .pending = NULL,
+};
+
+static uint32_t host_clock(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+static void host_write(const char* str, uint16_t size)
+{
+    fwrite(str, 1, size, out);
+}
+
+static bench_config_t config =
+{
+    .name = "host",
+    .clock = host_clock,
+    .clock_hz = 1000000000UL,
+    .min_ticks = 100000000UL,
+    .write = host_write,
+};
+
+int main(int argc, char* argv[])
+{
+    static bench_case_t selected[CASE_MAX];
+    const bench_case_t* cases;
+    const char* filter = NULL;
+    const char* file = NULL;
+    bench_t bench;
+    uint16_t count;
+    uint16_t n = 0;
+    uint16_t i;
+    int opt;
+
+    for (opt = 1; opt < argc; opt++)
+    {
+        if ((strcmp(argv[opt], "-o") == 0) && ((opt + 1) < argc))
+        {
+            file = argv[++opt];
+        }
+        else
+        {
+            filter = argv[opt];
+        }
+    }
+
+    out = file ? fopen(file, "w") : stdout;
+
+    if (!out)
+    {
+        perror(file);
+        return 1;
+    }
+
+    timebase_init(&host_timebase);
+
+    count = bench_suite(&cases);
+
+    for (i = 0; (i < count) && (n < CASE_MAX); i++)
+    {
+        if (!filter || strstr(cases[i].name, filter))
+        {
+            selected[n++] = cases[i];
+        }
+    }
+
+    bench_init(&bench, &config, selected, n);
+    bench_run(&bench);
+
+    if (file)
+    {
+        fclose(out);
+    }
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+#!/usr/bin/env python3
+"""
+DBC -> C codec generator.
+
+Reads one DBC file per bus and emits <bus>_codec.h/.c with
+
+  - one struct per message holding the raw (unscaled) signal values,
+  - <bus>_<msg>_unpack()/<bus>_<msg>_pack() that go through a 64-bit
+    word, so decoding does not depend on compiler bitfield layout or on
+    host endianness, and contains no data-dependent branches,
+  - message/signal metadata tables (id, layout, factor, offset, range, unit).
+
+Usage:
+    python3 tools/dbcgen/dbcgen.py -o Sources/can_codec Sources/can_codec/dbc/*.dbc
+
+Only the DBC subset used by this project is supported: BO_, SG_ (no
+multiplexing), CM_ BO_. Messages are limited to 8 bytes (classic CAN).
+"""
+
+import argparse
+import os
+import re
+import sys
+
+RE_BO = re.compile(r'^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)')
+RE_SG = re.compile(
+    r'^\s*SG_\s+(\w+)\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*'
+    r'\(([^,]+),([^)]+)\)\s*\[([^|]*)\|([^\]]*)\]\s*"([^"]*)"')
+RE_CM_BO = re.compile(r'^CM_\s+BO_\s+(\d+)\s+"([^"]*)"\s*;')
+
+
+class Signal:
+    def __init__(self, name, start, length, motorola, signed, factor, offset, minimum, maximum, unit):
+        self.name = name
+        self.start = start
+        self.length = length
+        self.motorola = motorola
+        self.signed = signed
+        self.factor = factor
+        self.offset = offset
+        self.minimum = minimum
+        self.maximum = maximum
+        self.unit = unit
+
+    @property
+    def lsb(self):
+        """bit position of the LSB in the 64-bit word (LE word for Intel, BE word for Motorola)"""
+        if self.motorola:
+            msb = (7 - (self.start // 8)) * 8 + (self.start % 8)
+            return msb - (self.length - 1)
+        return self.start
+
+    @property
+    def ctype(self):
+        for bits in (8, 16, 32):
+            if self.length <= bits:
+                return ('int%d_t' if self.signed else 'uint%d_t') % bits
+        raise ValueError('signal %s wider than 32 bits' % self.name)
+
+    @property
+    def mask(self):
+        return (1 << self.length) - 1
+
+
+class Message:
+    def __init__(self, frame_id, name, dlc, sender):
+        self.extended = bool(frame_id & 0x80000000)
+        self.id = frame_id & 0x1FFFFFFF
+        self.name = name
+        self.dlc = dlc
+        self.sender = sender
+        self.signals = []
+        self.comment = ''
+
+
+def parse(path):
+    messages = []
+    current = None
+
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            m = RE_BO.match(line)
+            if m:
+                current = Message(int(m.group(1)), m.group(2), int(m.group(3)), m.group(4))
+                if current.dlc > 8:
+                    raise ValueError('%s: %s dlc > 8' % (path, current.name))
+                messages.append(current)
+                continue
+
+            m = RE_SG.match(line)
+            if m:
+                if current is None:
+                    raise ValueError('%s: SG_ before BO_' % path)
+                sig = Signal(m.group(1), int(m.group(2)), int(m.group(3)), m.group(4) == '0',
+                             m.group(5) == '-', float(m.group(6)), float(m.group(7)),
+                             float(m.group(8) or 0), float(m.group(9) or 0), m.group(10))
+                if sig.lsb < 0 or sig.lsb + sig.length > 64:
+                    raise ValueError('%s: %s.%s out of frame' % (path, current.name, sig.name))
+                current.signals.append(sig)
+                continue
+
+            if not line.strip():
+                current = None
+
+            m = RE_CM_BO.match(line)
+            if m:
+                for msg in messages:
+                    if (msg.id | (0x80000000 if msg.extended else 0)) == int(m.group(1)):
+                        msg.comment = m.group(2)
+
+    return messages
+
+
+def snake(name):
+    name = re.sub(r'([a-z0-9])([A-Z])', r'\1_\2', name)
+    return name.lower()
+
+
+def fmt_float(value):
+    text = repr(float(value))
+    return text + 'f' if ('.' in text or 'e' in text) else text + '.0f'
+
+
+def generate(bus, messages, outdir, source):
+    guard = '_%s_codec_h_' % bus
+    upper = bus.upper()
+    h = []
+    c = []
+
+    h.append('/* 由 tools/dbcgen/dbcgen.py 依 %s 自動產生，請勿手動修改 */' % source)
+    h.append('#ifndef %s' % guard)
+    h.append('#define %s' % guard)
+    h.append('')
+    h.append('#include "can_codec.h"')
+    h.append('')
+
+    for msg in messages:
+        prefix = '%s_%s' % (upper, msg.name.upper())
+        h.append('#define %-40s (0x%08XUL)%s' % (prefix + '_ID', msg.id,
+                                                 ('    /** %s */' % msg.comment) if msg.comment else ''))
+    h.append('#define %-40s (%dU)' % (upper + '_MESSAGE_COUNT', len(messages)))
+    h.append('#define %-40s (%dU)' % (upper + '_SIGNAL_COUNT', sum(len(m.signals) for m in messages)))
+    h.append('')
+
+    for msg in messages:
+        tname = '%s_%s' % (bus, msg.name.lower())
+        if msg.comment:
+            h.append('/** %s */' % msg.comment)
+        h.append('typedef struct %s' % tname)
+        h.append('{')
+        if not msg.signals:
+            h.append('    uint8_t reserved;')
+        for sig in msg.signals:
+            unit = (' (%s)' % sig.unit) if sig.unit else ''
+            scale = ''
+            if sig.factor != 1.0 or sig.offset != 0.0:
+                scale = ' x %g%s' % (sig.factor, (' %+g' % sig.offset) if sig.offset else '')
+            h.append('    %-16s%-24s/** raw%s%s */' % (sig.ctype, snake(sig.name) + ';', scale, unit))
+        h.append('} %s_t;' % tname)
+        h.append('')
+
+    for msg in messages:
+        tname = '%s_%s' % (bus, msg.name.lower())
+        h.append('void %s_unpack(%s_t* msg, const uint8_t data[8]);' % (tname, tname))
+        h.append('void %s_pack(const %s_t* msg, uint8_t data[8]);' % (tname, tname))
+    h.append('')
+    h.append('extern const can_codec_message_t %s_messages[%s_MESSAGE_COUNT];' % (bus, upper))
+    h.append('extern const can_codec_signal_t %s_signals[%s_SIGNAL_COUNT];' % (bus, upper))
+    h.append('')
+    h.append('#endif')
+
+    c.append('/* 由 tools/dbcgen/dbcgen.py 依 %s 自動產生，請勿手動修改 */' % source)
+    c.append('#include "%s_codec.h"' % bus)
+    c.append('')
+
+    for msg in messages:
+        tname = '%s_%s' % (bus, msg.name.lower())
+        intel = [s for s in msg.signals if not s.motorola]
+        motorola = [s for s in msg.signals if s.motorola]
+
+        c.append('RAMFUNC void %s_unpack(%s_t* msg, const uint8_t data[8])' % (tname, tname))
+        c.append('{')
+        if intel:
+            c.append('    const uint64_t le = can_codec_load_le(data);')
+        if motorola:
+            c.append('    const uint64_t be = can_codec_load_be(data);')
+        if intel or motorola:
+            c.append('')
+        else:
+            c.append('    (void)data;')
+            c.append('    msg->reserved = 0;')
+        for sig in msg.signals:
+            word = 'be' if sig.motorola else 'le'
+            raw = '((%s >> %d) & 0x%XULL)' % (word, sig.lsb, sig.mask)
+            if sig.signed:
+                raw = '(can_codec_sign((uint32_t)%s, %dU))' % (raw, sig.length)
+            c.append('    msg->%s = (%s)%s;' % (snake(sig.name), sig.ctype, raw))
+        c.append('}')
+        c.append('')
+
+        c.append('void %s_pack(const %s_t* msg, uint8_t data[8])' % (tname, tname))
+        c.append('{')
+        c.append('    uint64_t le = 0;')
+        c.append('    uint64_t be = 0;')
+        c.append('')
+        if not msg.signals:
+            c.append('    (void)msg;')
+        for sig in msg.signals:
+            word = 'be' if sig.motorola else 'le'
+            c.append('    %s |= ((uint64_t)((uint32_t)msg->%s & 0x%XUL)) << %d;' % (
+                word, snake(sig.name), sig.mask, sig.lsb))
+        c.append('')
+        c.append('    can_codec_store(data, le, be);')
+        c.append('}')
+        c.append('')
+
+    c.append('const can_codec_signal_t %s_signals[%s_SIGNAL_COUNT] =' % (bus, upper))
+    c.append('{')
+    for msg in messages:
+        for sig in msg.signals:
+            c.append('    { "%s", 0x%08XUL, %d, %d, %s, %s, %s, %s, %s, %s, "%s" },' % (
+                sig.name, msg.id, sig.start, sig.length,
+                'true' if sig.motorola else 'false', 'true' if sig.signed else 'false',
+                fmt_float(sig.factor), fmt_float(sig.offset),
+                fmt_float(sig.minimum), fmt_float(sig.maximum), sig.unit))
+    c.append('};')
+    c.append('')
+
+    c.append('const can_codec_message_t %s_messages[%s_MESSAGE_COUNT] =' % (bus, upper))
+    c.append('{')
+    index = 0
+    for msg in messages:
+        c.append('    { "%s", 0x%08XUL, %d, %s, %d, %d },' % (
+            msg.name, msg.id, msg.dlc, 'true' if msg.extended else 'false', index, len(msg.signals)))
+        index += len(msg.signals)
+    c.append('};')
+
+    with open(os.path.join(outdir, '%s_codec.h' % bus), 'w', encoding='utf-8', newline='\n') as f:
+        f.write('\n'.join(h) + '\n')
+    with open(os.path.join(outdir, '%s_codec.c' % bus), 'w', encoding='utf-8', newline='\n') as f:
+        f.write('\n'.join(c) + '\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='generate C pack/unpack codecs from DBC files')
+    parser.add_argument('-o', '--output', required=True, help='output directory')
+    parser.add_argument('dbc', nargs='+', help='DBC files, file name is used as bus prefix')
+    args = parser.parse_args()
+
+    for path in args.dbc:
+        bus = os.path.splitext(os.path.basename(path))[0]
+        messages = parse(path)
+        source = os.path.relpath(path, os.path.join(args.output, '..', '..')).replace(os.sep, '/')
+        generate(bus, messages, args.output, source)
+        print('%s: %d messages' % (bus, len(messages)))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
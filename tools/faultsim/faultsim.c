@@ -0,0 +1,1088 @@
+/*
+ * fc135kw / tyt60kw / bidc300100 驅動的故障注入測試，在 PC 上以模擬時間執行
+ *
+ * build (repo 根目錄):
+ *   gcc -O2 -std=gnu99 -ISources/timebase -ISources/can_signal -ISources/can_codec -ISources/ramfunc \
+ *       -ISources/fc135kw -ISources/toyota60kw -ISources/bidc300100 tools/faultsim/faultsim.c \
+ *       Sources/timebase/timebase.c Sources/can_signal/can_signal.c \
+ *       Sources/can_codec/fc135kw_codec.c Sources/can_codec/tyt60kw_codec.c Sources/can_codec/host_codec.c \
+ *       Sources/fc135kw/fc135kw.c Sources/toyota60kw/toyota60kw.c \
+ *       Sources/bidc300100/bidc300100.c Sources/bidc300100/bidc300100_bank.c -o faultsim
+ *   ./faultsim [-n scenarios] [-s seed]     隨機情境
+ *   ./faultsim -s seed -r scenario          重播單一情境並印出 stack log
+ *
+ * 每個情境以 10 ms tick 執行 SCENARIO_TICKS 次 *_task()，控制器、主機與 DCDC 模組以簡化模型回應
+ * 驅動送出的命令；情境內隨機排程數個事件(遺失幀、訊號卡住、H2 壓力超出範圍、控制器狀態轉換延遲、
+ * 主機連線中斷、錯誤等級、快速路徑、匯流排異常、主機停止/關機/清除錯誤)，每個 tick 檢查不變條件
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "timebase.h"
+#include "fc135kw.h"
+#include "toyota60kw.h"
+#include "bidc300100_bank.h"
+#include "fc135kw_codec.h"
+#include "tyt60kw_codec.h"
+
+#define TICK_US                                 TIMEBASE_MS(10)
+#define SIM_PERIOD                              TIMEBASE_S(1000)    /** 模擬計數器溢位週期 */
+#define SCENARIO_TICKS                          (4000U)     /** 40 s，涵蓋 fc135kw 上電(8 s)到運行 */
+#define FRAME_TICKS                             (10U)       /** 控制器與主機每 100 ms 發送 */
+#define BANK_TICKS                              (50U)       /** bidc300100_bank_task() 每 500 ms */
+#define CAN_TX_DEPTH                            (16U)       /** app_can.c can2 發送佇列深度 */
+#define EVENT_MAX                               (8U)
+#define MODULE_MAX                              (BIDC300100_BANK_MAX + 2U)  /** 模擬模組數可超過 bank 容量 */
+#define RESPONSE_MAX                            (64U)
+#define VIOLATION_MAX                           (10U)
+
+#define FC_SIGNALS                              (4U)        /** FC135KW_SYS_STATUS/H2/WATER/ERROR */
+#define TYT_SIGNALS                             (5U)        /** 050/051/222/225/508 */
+
+typedef enum event_kind
+{
+    EVENT_DROP = 0,         /** 控制器幀隨機遺失，arg = 遺失率(%) */
+    EVENT_STUCK,            /** 單一訊號停止更新，arg = 訊號 */
+    EVENT_H2_RANGE,         /** H2 氣源壓力超出範圍，arg = 壓力(0.1 kPa) */
+    EVENT_SLOW_STATUS,      /** 控制器狀態轉換延遲，arg = 延遲上限(tick) */
+    EVENT_HOST_STORM,       /** 主機停止發送 */
+    EVENT_ERROR_LEVEL,      /** 控制器回報錯誤，arg = 等級 */
+    EVENT_TRIP,             /** 快速路徑觸發 */
+    EVENT_BUS_FAULT,        /** 匯流排 error passive/bus-off */
+    EVENT_HOST_STOP,        /** 主機要求停止，區間結束後恢復啟動 */
+    EVENT_HOST_DEINIT,      /** 系統關機 (menu_main_stop)，區間結束後恢復啟動 */
+    EVENT_HOST_CLEAR,       /** 主機清除錯誤 */
+    EVENT_MODULE_LOSS,      /** DCDC 模組停止響應，arg = 模組 */
+    EVENT_BANK_SETUP,       /** DCDC 組開機並設定電流，arg = 電流(0.1 A) */
+    EVENT_KIND_MAX,
+} event_kind_t;
+
+typedef struct event
+{
+    event_kind_t kind;
+    uint16_t start;
+    uint16_t len;
+    uint16_t arg;
+} event_t;
+
+typedef struct fc135kw_plant
+{
+    uint8_t status;         /** 控制器 system_status */
+    uint8_t target;
+    uint16_t delay;
+    fc135kw_set_status_t cmd;
+} fc135kw_plant_t;
+
+typedef struct tyt60kw_plant
+{
+    tyt60kw_fc_status_t status;
+    tyt60kw_fc_status_t target;
+    uint16_t delay;
+    bool relay;
+    tyt60kw_ev_hv_1_t cmd;
+} tyt60kw_plant_t;
+
+typedef struct module_plant
+{
+    uint8_t addr;           /** 已加上 0x20 */
+    bool on;
+    uint16_t setup;         /** 電流設定(0.1 A) */
+    uint16_t gain;          /** 實際電流 = setup x gain / 1000 */
+    int16_t temp;           /** 0.1 度 */
+} module_plant_t;
+
+typedef struct response
+{
+    uint32_t id;
+    uint8_t data[8];
+} response_t;
+
+static const char* const event_name[EVENT_KIND_MAX] =
+{
+    [EVENT_DROP] = "drop",
+    [EVENT_STUCK] = "stuck",
+    [EVENT_H2_RANGE] = "h2 range",
+    [EVENT_SLOW_STATUS] = "slow status",
+    [EVENT_HOST_STORM] = "host storm",
+    [EVENT_ERROR_LEVEL] = "error level",
+    [EVENT_TRIP] = "trip",
+    [EVENT_BUS_FAULT] = "bus fault",
+    [EVENT_HOST_STOP] = "host stop",
+    [EVENT_HOST_DEINIT] = "host deinit",
+    [EVENT_HOST_CLEAR] = "host clear",
+    [EVENT_MODULE_LOSS] = "module loss",
+    [EVENT_BANK_SETUP] = "bank setup",
+};
+
+static const char* const status_name[FC135KW_STATUS_MAX] =
+{
+    "INIT", "IDLE", "PRECHARGE", "RUNNING", "SHUTDOWN", "ERROR", "DEINIT",
+};
+
+static uint32_t sim_counter(void);
+static void fc_log(const char* str, uint16_t size);
+static uint16_t fc_io(fc135kw_io_t io, uint16_t value);
+static uint16_t tyt_io(tyt60kw_io_t io, uint16_t value);
+static void bank_tx(uint32_t id, uint8_t* data, uint8_t size);
+
+static const timebase_config_t sim_timebase =
+{
+    .period = SIM_PERIOD,
+    .counter = sim_counter,
+    .pending = NULL,
+};
+
+/* log 只在重播時啟用，避免 snprintf 佔用大部分執行時間 */
+static fc135kw_config_t fc_config = { .name = "fc135kw", .log = NULL, .io = fc_io, .light_tower = NULL, };
+static tyt60kw_config_t tyt_config = { .name = "tyt60kw", .log = NULL, .io = tyt_io, .light_tower = NULL, };
+
+static fc135kw_t fc;
+static tyt60kw_t tyt;
+static bidc300100_bank_t bank;
+static fc135kw_plant_t fc_plant;
+static tyt60kw_plant_t tyt_plant;
+static module_plant_t module[MODULE_MAX];
+
+static struct
+{
+    uint64_t now;
+    uint32_t rng;
+    uint32_t index;
+    uint32_t seed;
+    uint16_t tick;
+    bool log;
+
+    event_t event[EVENT_MAX];
+    uint8_t events;
+    uint8_t modules;
+
+    bool host_start;
+    uint16_t host_silent;   /** 主機未發送的 tick 數 */
+
+    bool fc_power;
+    bool fc_ign;
+    bool tyt_power;
+    bool tyt_ign;
+
+    uint8_t bank_frames;    /** 單次 bank 調用送出的幀數 */
+    response_t response[RESPONSE_MAX];
+    uint8_t responses;
+} sim;
+
+static struct
+{
+    uint32_t fc_edge[FC135KW_STATUS_MAX][FC135KW_STATUS_MAX];
+    uint32_t tyt_edge[TYT60KW_STATUS_MAX][TYT60KW_STATUS_MAX];
+    uint32_t event[EVENT_KIND_MAX];
+    uint32_t bank_online_max;
+    uint32_t bank_removed;
+    uint64_t checks;
+    uint32_t violations;
+} cover;
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static uint32_t sim_counter(void)
+{
+    return (uint32_t)(sim.now % SIM_PERIOD);
+}
+
+static void sim_advance(void)
+{
+    uint64_t old = sim.now / SIM_PERIOD;
+
+    sim.now += TICK_US;
+
+    if ((sim.now / SIM_PERIOD) != old)
+    {
+        timebase_irq();
+    }
+}
+
+static uint32_t rnd(void)
+{
+    /* xorshift32 */
+    sim.rng ^= sim.rng << 13;
+    sim.rng ^= sim.rng >> 17;
+    sim.rng ^= sim.rng << 5;
+
+    return sim.rng;
+}
+
+static uint32_t rnd_range(uint32_t min, uint32_t max)
+{
+    return min + (rnd() % (max - min + 1U));
+}
+
+static void fc_log(const char* str, uint16_t size)
+{
+    if (sim.log)
+    {
+        printf("%8.2f %.*s", (double)sim.now / 1e6, (int)size, str);
+    }
+}
+
+static uint16_t fc_io(fc135kw_io_t io, uint16_t value)
+{
+    switch (io)
+    {
+        case FC135KW_IO_24V_POWER: { sim.fc_power = (value != 0); break; }
+        case FC135KW_IO_IGN: { sim.fc_ign = (value != 0); break; }
+        default: { break; }
+    }
+
+    return value;
+}
+
+static uint16_t tyt_io(tyt60kw_io_t io, uint16_t value)
+{
+    switch (io)
+    {
+        case TYT60KW_IO_POWER: { sim.tyt_power = (value != 0); break; }
+        case TYT60KW_IO_IGN: { sim.tyt_ign = (value != 0); break; }
+        default: { break; }
+    }
+
+    return value;
+}
+
+static bool active(event_kind_t kind, uint16_t* arg)
+{
+    const event_t* e;
+    uint8_t i;
+
+    for (i = 0; i < sim.events; i++)
+    {
+        e = &sim.event[i];
+
+        if ((e->kind == kind) && (sim.tick >= e->start) && (sim.tick < (e->start + e->len)))
+        {
+            if (arg)
+            {
+                *arg = e->arg;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool dropped(void)
+{
+    uint16_t rate;
+
+    return active(EVENT_DROP, &rate) && ((rnd() % 100U) < rate);
+}
+
+static bool stuck(uint8_t signal)
+{
+    uint16_t arg;
+
+    return active(EVENT_STUCK, &arg) && (arg == signal);
+}
+
+static uint16_t transition_delay(void)
+{
+    uint16_t max = 50;
+
+    active(EVENT_SLOW_STATUS, &max);
+
+    return (uint16_t)rnd_range(0, max);
+}
+
+static void check(bool ok, const char* name)
+{
+    cover.checks++;
+
+    if (!ok)
+    {
+        if (cover.violations < VIOLATION_MAX)
+        {
+            printf("violation: scenario %u (seed 0x%08X) at %u ms: %s, fc135kw %s, tyt60kw %s\n",
+                sim.index, sim.seed, sim.tick * 10U, name, status_name[fc.status], status_name[tyt.status]);
+        }
+
+        cover.violations++;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 情境產生，事件的種類、時間與參數都由情境 seed 決定
+ */
+static void scenario(uint32_t index, uint32_t seed)
+{
+    event_t* e;
+    uint8_t i;
+
+    sim.index = index;
+    sim.seed = seed ^ (index * 0x9E3779B9U);
+    sim.rng = sim.seed ? sim.seed : 1U;
+    sim.events = (uint8_t)rnd_range(1, EVENT_MAX);
+
+    for (i = 0; i < sim.events; i++)
+    {
+        e = &sim.event[i];
+        e->kind = (event_kind_t)(rnd() % EVENT_KIND_MAX);
+        e->start = (uint16_t)(rnd() % SCENARIO_TICKS);
+        e->len = (uint16_t)rnd_range(1, 1000);
+
+        switch (e->kind)
+        {
+            case EVENT_DROP: { e->arg = (uint16_t)rnd_range(1, 60); break; }
+            case EVENT_STUCK: { e->arg = (uint16_t)(rnd() % (FC_SIGNALS + TYT_SIGNALS)); break; }
+            case EVENT_H2_RANGE: { e->arg = (rnd() & 1U) ? (uint16_t)rnd_range(0, 599) : (uint16_t)rnd_range(1000, 3000); break; }
+            case EVENT_SLOW_STATUS: { e->arg = (uint16_t)rnd_range(100, 6000); break; }
+            case EVENT_HOST_STORM: { e->len = (uint16_t)rnd_range(50, 600); break; }
+            case EVENT_ERROR_LEVEL: { e->arg = (uint16_t)rnd_range(1, 3); break; }
+            case EVENT_MODULE_LOSS: { e->arg = (uint16_t)(rnd() % MODULE_MAX); break; }
+            case EVENT_BANK_SETUP: { e->arg = (uint16_t)(rnd() % (BIDC300100_BANK_MAX * BIDC300100_BANK_CURRENT_MAX)); break; }
+            default: { e->arg = 0; break; }
+        }
+
+        cover.event[e->kind]++;
+    }
+
+    sim.modules = (uint8_t)(rnd() % (MODULE_MAX + 1U));
+
+    for (i = 0; i < sim.modules; i++)
+    {
+        module[i].addr = (uint8_t)(0x20U | (rnd() & 0x1FU));
+        module[i].on = false;
+        module[i].setup = 400;
+        module[i].gain = (uint16_t)rnd_range(800, 1200);
+        module[i].temp = (int16_t)rnd_range(250, 900);
+    }
+}
+
+/**
+ * @brief 事件開始或結束時的動作
+ */
+static void host_events(void)
+{
+    const event_t* e;
+    uint8_t i;
+
+    for (i = 0; i < sim.events; i++)
+    {
+        e = &sim.event[i];
+
+        if (sim.tick == e->start)
+        {
+            switch (e->kind)
+            {
+                case EVENT_TRIP:
+                {
+                    fc135kw_trip(&fc);
+                    tyt60kw_trip(&tyt);
+                    break;
+                }
+                case EVENT_BUS_FAULT:
+                {
+                    fc135kw_bus_fault(&fc, true);
+                    tyt60kw_bus_fault(&tyt, true);
+                    break;
+                }
+                case EVENT_HOST_STOP:
+                {
+                    sim.host_start = false;
+                    break;
+                }
+                case EVENT_HOST_DEINIT:
+                {
+                    sim.host_start = false;
+                    fc135kw_deinit(&fc);
+                    tyt60kw_deinit(&tyt);
+                    sim.bank_frames = 0;
+                    bidc300100_bank_set_ctrl(&bank, BIDC300100_OFF);
+                    check(sim.bank_frames <= CAN_TX_DEPTH, "bank ctrl burst exceeds tx queue");
+                    break;
+                }
+                case EVENT_HOST_CLEAR:
+                {
+                    fc135kw_clear_error(&fc);
+                    tyt60kw_clear_error(&tyt);
+                    break;
+                }
+                case EVENT_BANK_SETUP:
+                {
+                    sim.bank_frames = 0;
+                    bidc300100_bank_set_ctrl(&bank, BIDC300100_ON);
+                    bidc300100_bank_current(&bank, e->arg);
+                    check(sim.bank_frames <= CAN_TX_DEPTH, "bank setup burst exceeds tx queue");
+                    break;
+                }
+                default: { break; }
+            }
+        }
+        else if (sim.tick == (e->start + e->len))
+        {
+            switch (e->kind)
+            {
+                case EVENT_BUS_FAULT:
+                {
+                    fc135kw_bus_fault(&fc, false);
+                    tyt60kw_bus_fault(&tyt, false);
+                    break;
+                }
+                case EVENT_HOST_STOP:
+                case EVENT_HOST_DEINIT:
+                {
+                    sim.host_start = true;
+                    break;
+                }
+                default: { break; }
+            }
+        }
+    }
+
+    if (active(EVENT_HOST_STORM, NULL))
+    {
+        sim.host_silent++;
+        return;
+    }
+
+    if ((sim.tick % FRAME_TICKS) == 0)
+    {
+        /* can2_rx_task() */
+        sim.host_silent = 0;
+        fc135kw_host_connect(&fc);
+        fc135kw_start(&fc, sim.host_start);
+        fc135kw_power(&fc, 60);
+        tyt60kw_host_connect(&tyt);
+        tyt60kw_start(&tyt, sim.host_start);
+        tyt60kw_power(&tyt, 30);
+    }
+    else
+    {
+        sim.host_silent++;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief fc135kw 控制器模型，依 SET_STATUS 切換 system_status (3: 待機, 6: 運行, 9: 下電)
+ */
+static void fc135kw_plant(void)
+{
+    fc135kw_sys_status_t status;
+    fc135kw_sys_h2_t h2 = { .h2_pressure = 5000, .h2_src_pressure = 8000, };
+    fc135kw_sys_water_t water = { .water_temp = 100, .water_temp_target = 105, };
+    fc135kw_sys_error_t error = { .error_level = 0, .error_code = 0, };
+    uint8_t data[8];
+    uint16_t arg;
+    uint8_t target;
+
+    fc135kw_command(&fc, FC135KW_SET_STATUS, data);
+    fc135kw_set_status_unpack(&fc_plant.cmd, data);
+
+    if (!sim.fc_power || !sim.fc_ign)
+    {
+        fc_plant.status = 0;
+        fc_plant.target = 0;
+        return;
+    }
+
+    if (!fc_plant.cmd.power_on_sig)
+    {
+        target = 9;
+    }
+    else
+    {
+        target = (fc_plant.cmd.start && !fc_plant.cmd.emerg_stop) ? 6 : 3;
+    }
+
+    if (fc_plant.target != target)
+    {
+        fc_plant.target = target;
+        fc_plant.delay = transition_delay();
+    }
+
+    if (fc_plant.delay)
+    {
+        fc_plant.delay--;
+    }
+    else
+    {
+        fc_plant.status = fc_plant.target;
+    }
+
+    if ((sim.tick % FRAME_TICKS) != 0)
+    {
+        return;
+    }
+
+    status.system_status = fc_plant.status;
+
+    if (active(EVENT_H2_RANGE, &arg))
+    {
+        h2.h2_src_pressure = (uint16_t)(arg * 10U);
+    }
+
+    if (active(EVENT_ERROR_LEVEL, &arg))
+    {
+        error.error_level = (uint8_t)arg;
+        error.error_code = 0x1234;
+    }
+
+    if (!dropped() && !stuck(0))
+    {
+        fc135kw_sys_status_pack(&status, data);
+        fc135kw_update(&fc, FC135KW_SYS_STATUS, data);
+    }
+
+    if (!dropped() && !stuck(1))
+    {
+        fc135kw_sys_h2_pack(&h2, data);
+        fc135kw_update(&fc, FC135KW_SYS_H2, data);
+    }
+
+    if (!dropped() && !stuck(2))
+    {
+        fc135kw_sys_water_pack(&water, data);
+        fc135kw_update(&fc, FC135KW_SYS_WATER, data);
+    }
+
+    if (!dropped() && !stuck(3))
+    {
+        fc135kw_sys_error_pack(&error, data);
+        fc135kw_update(&fc, FC135KW_SYS_ERROR, data);
+    }
+}
+
+/**
+ * @brief tyt60kw 控制器模型，依 start_command 切換 fc_status，relay 在供電時閉合
+ */
+static void tyt60kw_plant(void)
+{
+    tyt60kw_fc_050_t fc_050;
+    tyt60kw_fc_051_t fc_051 = { .error_level = 0, .pcu_voltage = 650, };
+    tyt60kw_fc_222_t fc_222 = { .water_temp_fco = 60, };
+    tyt60kw_fc_225_t fc_225 = { .pcu_temp = 40, };
+    tyt60kw_fc_508_t fc_508 = { .error_code = 0, };
+    tyt60kw_fc_status_t target = tyt_plant.target;
+    uint8_t data[8];
+    uint16_t arg;
+
+    tyt60kw_command(&tyt, TYT60KW_CMD_04E, data);
+    tyt60kw_ev_hv_1_unpack(&tyt_plant.cmd, data);
+
+    if (!sim.tyt_power || !sim.tyt_ign)
+    {
+        tyt_plant.status = TYT60KW_STOPPED;
+        tyt_plant.target = TYT60KW_STOPPED;
+        tyt_plant.relay = false;
+        return;
+    }
+
+    switch (tyt_plant.cmd.start_command)
+    {
+        case TYT60KW_START:
+        {
+            if (tyt_plant.status != TYT60KW_POWER_SUPPLY)
+            {
+                tyt_plant.status = TYT60KW_START_PROCESSING;
+                target = TYT60KW_POWER_SUPPLY;
+            }
+            break;
+        }
+        case TYT60KW_STOP:
+        case TYT60KW_PURGE_STOP:
+        case TYT60KW_EMERG_STOP:
+        {
+            if ((tyt_plant.status != TYT60KW_STOP_FINISH) && (tyt_plant.status != TYT60KW_STOPPED))
+            {
+                tyt_plant.status = TYT60KW_STOP_PROCESSING;
+                target = TYT60KW_STOP_FINISH;
+            }
+            break;
+        }
+        default:
+        {
+            if (tyt_plant.status == TYT60KW_STOP_FINISH)
+            {
+                target = TYT60KW_STOPPED;
+            }
+            break;
+        }
+    }
+
+    if (tyt_plant.target != target)
+    {
+        tyt_plant.target = target;
+        tyt_plant.delay = transition_delay();
+    }
+
+    if (tyt_plant.delay)
+    {
+        tyt_plant.delay--;
+    }
+    else
+    {
+        tyt_plant.status = tyt_plant.target;
+    }
+
+    if (tyt_plant.status == TYT60KW_POWER_SUPPLY)
+    {
+        tyt_plant.relay = true;
+    }
+
+    if (tyt_plant.cmd.relay_off)
+    {
+        tyt_plant.relay = false;
+    }
+
+    if ((sim.tick % FRAME_TICKS) != 0)
+    {
+        return;
+    }
+
+    fc_050.fc_status = (uint8_t)tyt_plant.status;
+    fc_050.relay_status = tyt_plant.relay;
+
+    if (active(EVENT_ERROR_LEVEL, &arg))
+    {
+        fc_051.error_level = (uint8_t)arg;
+    }
+
+    if (!dropped() && !stuck(FC_SIGNALS + 0))
+    {
+        tyt60kw_fc_050_pack(&fc_050, data);
+        tyt60kw_update(&tyt, TYT60KW_UPDATE_050, data);
+    }
+
+    if (!dropped() && !stuck(FC_SIGNALS + 1))
+    {
+        tyt60kw_fc_051_pack(&fc_051, data);
+        tyt60kw_update(&tyt, TYT60KW_UPDATE_051, data);
+    }
+
+    if (!dropped() && !stuck(FC_SIGNALS + 2))
+    {
+        tyt60kw_fc_222_pack(&fc_222, data);
+        tyt60kw_update(&tyt, TYT60KW_UPDATE_222, data);
+    }
+
+    if (!dropped() && !stuck(FC_SIGNALS + 3))
+    {
+        tyt60kw_fc_225_pack(&fc_225, data);
+        tyt60kw_update(&tyt, TYT60KW_UPDATE_225, data);
+    }
+
+    if (!dropped() && !stuck(FC_SIGNALS + 4))
+    {
+        tyt60kw_fc_508_pack(&fc_508, data);
+        tyt60kw_update(&tyt, TYT60KW_UPDATE_508, data);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void respond(uint8_t addr, uint16_t order, uint16_t data0, int16_t data1, int16_t data2)
+{
+    response_t* r;
+
+    if ((sim.responses >= RESPONSE_MAX) || dropped())
+    {
+        return;
+    }
+
+    r = &sim.response[sim.responses++];
+    r->id = BIDC300100_ID(((rnd() & 1U) ? BIDC300100_FRAME_RESPONSE : BIDC300100_FRAME_ACK), BIDC300100_HOST_ADDR, addr);
+    r->data[0] = (uint8_t)(data0 >> 8);
+    r->data[1] = (uint8_t)data0;
+    r->data[2] = (uint8_t)(order >> 8);
+    r->data[3] = (uint8_t)order;
+    r->data[4] = (uint8_t)((uint16_t)data2 >> 8);
+    r->data[5] = (uint8_t)data2;
+    r->data[6] = (uint8_t)((uint16_t)data1 >> 8);
+    r->data[7] = (uint8_t)data1;
+}
+
+/**
+ * @brief DCDC 模組模型，響應在 bank 調用結束後才送回，與實際接收順序相同
+ */
+static void bank_tx(uint32_t id, uint8_t* data, uint8_t size)
+{
+    module_plant_t* m;
+    uint8_t pf = (uint8_t)(id >> 16);
+    uint8_t ps = (uint8_t)(id >> 8);
+    uint16_t order;
+    uint16_t value;
+    uint16_t len;
+    uint16_t arg;
+    uint8_t i;
+    uint8_t j;
+
+    (void)size;
+    sim.bank_frames++;
+
+    for (i = 0; i < sim.modules; i++)
+    {
+        m = &module[i];
+
+        if ((m->addr != ps) || (active(EVENT_MODULE_LOSS, &arg) && (arg == i)))
+        {
+            continue;
+        }
+
+        value = (uint16_t)((data[0] << 8) | data[1]);
+        order = (uint16_t)((data[2] << 8) | data[3]);
+
+        if (pf == BIDC300100_FRAME_SETUP)
+        {
+            if (order == 32)
+            {
+                m->on = (value == 0x55U);
+            }
+            else if (order == BIDC300100_CURRENT_SETUP)
+            {
+                m->setup = value;
+            }
+
+            respond(m->addr, order, value, 0, 0);
+        }
+        else if (pf == BIDC300100_FRAME_QUERY)
+        {
+            len = (uint16_t)((data[6] << 8) | data[7]);
+
+            if (len == 0)
+            {
+                len = 1;
+            }
+            else
+            {
+                order = value;
+            }
+
+            m->temp = (int16_t)(m->temp + (int16_t)rnd_range(0, 20) - 10);
+
+            for (j = 0; j < len; j++)
+            {
+                switch (order + j)
+                {
+                    case BIDC300100_BATTERY:
+                    {
+                        respond(m->addr, order + j, 5000, (int16_t)(m->on ? ((uint32_t)m->setup * m->gain / 1000U) : 0), 0);
+                        break;
+                    }
+                    case BIDC300100_TEMPERATURE:
+                    {
+                        respond(m->addr, order + j, 0, m->temp, (int16_t)(m->temp - 30));
+                        break;
+                    }
+                    case BIDC300100_ONOFF:
+                    {
+                        respond(m->addr, order + j, m->on ? 0x55U : 0xAAU, 0, 0);
+                        break;
+                    }
+                    default:
+                    {
+                        respond(m->addr, order + j, 0, 0, 0);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void bank_step(void)
+{
+    uint8_t online;
+    uint8_t i;
+    uint8_t j;
+    bool valid = true;
+
+    if ((sim.tick % BANK_TICKS) != 0)
+    {
+        return;
+    }
+
+    online = bidc300100_bank_online(&bank);
+
+    sim.bank_frames = 0;
+    bidc300100_bank_task(&bank);
+    check(sim.bank_frames <= CAN_TX_DEPTH, "bank task burst exceeds tx queue");
+
+    if (bidc300100_bank_online(&bank) < online)
+    {
+        cover.bank_removed++;
+    }
+
+    for (i = 0; i < sim.responses; i++)
+    {
+        bidc300100_bank_parser(&bank, sim.response[i].id, sim.response[i].data, 8);
+    }
+
+    sim.responses = 0;
+
+    if (bank.count > cover.bank_online_max)
+    {
+        cover.bank_online_max = bank.count;
+    }
+
+    check(bank.count <= BIDC300100_BANK_MAX, "bank count overflow");
+    check(bidc300100_bank_output(&bank) <= bank.count, "bank output exceeds online");
+
+    for (i = 0; i < bank.count; i++)
+    {
+        valid &= ((bank.addr[i] & 0xE0U) == 0x20U);
+        valid &= ((bank.present & (1UL << (bank.addr[i] & 0x1FU))) != 0);
+        valid &= (bank.share[i] <= BIDC300100_BANK_CURRENT_MAX);
+
+        for (j = (uint8_t)(i + 1U); j < bank.count; j++)
+        {
+            valid &= (bank.addr[i] != bank.addr[j]);
+        }
+    }
+
+    check(valid, "bank slot table corrupt");
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief 不變條件，每個 tick 在 *_task() 之後檢查
+ *
+ * @note 狀態的進入動作與 ems() 在轉換後的下一個 tick 才執行(status_old 更新)，
+ *       狀態相關的條件只在 status == status_old 時檢查
+ */
+static void invariants(void)
+{
+    fc135kw_set_status_t fc_cmd = fc_plant.cmd;
+    tyt60kw_ev_hv_1_t tyt_cmd = tyt_plant.cmd;
+    uint8_t data[8];
+
+    fc135kw_command(&fc, FC135KW_SET_STATUS, data);
+    fc135kw_set_status_unpack(&fc_cmd, data);
+    tyt60kw_command(&tyt, TYT60KW_CMD_04E, data);
+    tyt60kw_ev_hv_1_unpack(&tyt_cmd, data);
+
+    check(fc.status < FC135KW_STATUS_MAX, "fc135kw status out of range");
+    check(tyt.status < TYT60KW_STATUS_MAX, "tyt60kw status out of range");
+
+    if ((fc.status == FC135KW_DEINIT) && (fc.status_old == FC135KW_DEINIT))
+    {
+        check(!sim.fc_ign, "fc135kw IGN on while DEINIT");
+        check(!sim.fc_power, "fc135kw power on while DEINIT");
+    }
+
+    if ((tyt.status == TYT60KW_DEINIT) && (tyt.status_old == TYT60KW_DEINIT))
+    {
+        check(!sim.tyt_ign, "tyt60kw IGN on while DEINIT");
+        check(!sim.tyt_power, "tyt60kw power on while DEINIT");
+    }
+
+    if (fc.trip)
+    {
+        check(fc_cmd.power_setup == 0, "fc135kw power while tripped");
+    }
+
+    if (tyt.trip)
+    {
+        check(tyt_cmd.power_cmd == 0, "tyt60kw power while tripped");
+        check(tyt_cmd.relay_off, "tyt60kw relay not opened while tripped");
+    }
+
+    if (fc.flag.bits.bus_fault)
+    {
+        check(fc_cmd.power_setup <= FC135KW_DERATE_POWER, "fc135kw not derated on bus fault");
+    }
+
+    if (tyt.flag.bits.bus_fault)
+    {
+        check(tyt_cmd.power_cmd <= (TYT60KW_DERATE_POWER * 10U), "tyt60kw not derated on bus fault");
+    }
+
+    if ((fc.status == FC135KW_RUNNING) && (fc.status_old == FC135KW_RUNNING))
+    {
+        check(can_signal_valid(&fc.signal[FC135KW_SIGNAL_H2]), "fc135kw running on stale H2");
+        check((fc.H2_src_pressure >= 600) && (fc.H2_src_pressure < 1000), "fc135kw running with H2 out of range");
+        check(fc.error <= 1, "fc135kw running with error level");
+    }
+
+    if ((tyt.status == TYT60KW_RUNNING) && (tyt.status_old == TYT60KW_RUNNING))
+    {
+        check(can_signal_valid(&tyt.signal[TYT60KW_SIGNAL_051]), "tyt60kw running on stale 051");
+        check(can_signal_valid(&tyt.signal[TYT60KW_SIGNAL_222]), "tyt60kw running on stale 222");
+        check(tyt.error == 0, "tyt60kw running with error level");
+    }
+
+    /* 主機逾時後會調用 *_error_stop()，start 必須清除 */
+    if (sim.host_silent > ((FC135KW_HOST_TIMEOUT / TICK_US) + 1U))
+    {
+        check(!fc.flag.bits.start, "fc135kw still started after host timeout");
+    }
+
+    if (sim.host_silent > ((TYT60KW_HOST_TIMEOUT / TICK_US) + 1U))
+    {
+        check(!tyt.flag.bits.start, "tyt60kw still started after host timeout");
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void run(uint32_t index, uint32_t seed)
+{
+    fc135kw_status_t fc_old;
+    tyt60kw_status_t tyt_old;
+
+    memset(&fc_plant, 0, sizeof(fc_plant));
+    memset(&tyt_plant, 0, sizeof(tyt_plant));
+
+    sim.now = 0;
+    sim.host_start = true;
+    sim.host_silent = 0;
+    sim.fc_power = false;
+    sim.fc_ign = false;
+    sim.tyt_power = false;
+    sim.tyt_ign = false;
+    sim.responses = 0;
+
+    scenario(index, seed);
+    timebase_init(&sim_timebase);
+
+    fc135kw_init(&fc, &fc_config);
+    tyt60kw_init(&tyt, &tyt_config);
+    bidc300100_bank_init(&bank, bank_tx);
+
+    /* menu_main() */
+    fc135kw_start(&fc, true);
+    tyt60kw_start(&tyt, true);
+
+    for (sim.tick = 0; sim.tick < SCENARIO_TICKS; sim.tick++)
+    {
+        fc_old = fc.status;
+        tyt_old = tyt.status;
+
+        timebase_task();
+        host_events();
+        fc135kw_plant();
+        tyt60kw_plant();
+        fc135kw_task(&fc);
+        tyt60kw_task(&tyt);
+        bank_step();
+        invariants();
+
+        cover.fc_edge[fc_old][fc.status]++;
+        cover.tyt_edge[tyt_old][tyt.status]++;
+
+        sim_advance();
+    }
+}
+
+static void report_stack(const char* name, uint32_t edge[FC135KW_STATUS_MAX][FC135KW_STATUS_MAX])
+{
+    uint32_t visit;
+    uint8_t edges = 0;
+    uint8_t states = 0;
+    uint8_t i;
+    uint8_t j;
+
+    printf("%s states:", name);
+
+    for (i = 0; i < FC135KW_STATUS_MAX; i++)
+    {
+        visit = 0;
+
+        for (j = 0; j < FC135KW_STATUS_MAX; j++)
+        {
+            visit += edge[j][i];
+            edges += ((i != j) && edge[j][i]) ? 1U : 0U;
+        }
+
+        states += visit ? 1U : 0U;
+        printf(" %s%s", status_name[i], visit ? "" : "(missed)");
+    }
+
+    printf(" (%u/%u), transitions: %u\n", states, FC135KW_STATUS_MAX, edges);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t count = 2000;
+    uint32_t seed = (uint32_t)time(NULL);
+    int32_t replay = -1;
+    struct timespec t0;
+    struct timespec t1;
+    double elapsed;
+    uint32_t i;
+    int opt;
+
+    for (opt = 1; opt < argc; opt++)
+    {
+        if ((strcmp(argv[opt], "-n") == 0) && ((opt + 1) < argc))
+        {
+            count = (uint32_t)strtoul(argv[++opt], NULL, 0);
+        }
+        else if ((strcmp(argv[opt], "-s") == 0) && ((opt + 1) < argc))
+        {
+            seed = (uint32_t)strtoul(argv[++opt], NULL, 0);
+        }
+        else if ((strcmp(argv[opt], "-r") == 0) && ((opt + 1) < argc))
+        {
+            replay = (int32_t)strtol(argv[++opt], NULL, 0);
+        }
+        else
+        {
+            printf("usage: %s [-n scenarios] [-s seed] [-r scenario]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (replay >= 0)
+    {
+        sim.log = true;
+        fc_config.log = fc_log;
+        tyt_config.log = fc_log;
+        scenario((uint32_t)replay, seed);
+
+        for (i = 0; i < sim.events; i++)
+        {
+            printf("event: %s at %u ms for %u ms, arg %u\n", event_name[sim.event[i].kind],
+                sim.event[i].start * 10U, sim.event[i].len * 10U, sim.event[i].arg);
+        }
+
+        memset(&cover, 0, sizeof(cover));
+        run((uint32_t)replay, seed);
+
+        return cover.violations ? 1 : 0;
+    }
+
+    printf("seed 0x%08X\n", seed);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (i = 0; i < count; i++)
+    {
+        run(i, seed);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    elapsed = (double)(t1.tv_sec - t0.tv_sec) + ((double)(t1.tv_nsec - t0.tv_nsec) / 1e9);
+
+    printf("scenarios: %u (%u s simulated each), %.2f s, %.0f scenarios/s\n",
+        count, (SCENARIO_TICKS * 10U) / 1000U, elapsed, count / elapsed);
+
+    report_stack("fc135kw", cover.fc_edge);
+    report_stack("tyt60kw", (uint32_t (*)[FC135KW_STATUS_MAX])cover.tyt_edge);
+
+    printf("events:");
+
+    for (i = 0; i < EVENT_KIND_MAX; i++)
+    {
+        printf(" %s %u%s", event_name[i], cover.event[i], (i + 1U < EVENT_KIND_MAX) ? "," : "\n");
+    }
+
+    printf("bank: online max %u, removed %u\n", cover.bank_online_max, cover.bank_removed);
+    printf("checks: %llu, violations: %u\n", (unsigned long long)cover.checks, cover.violations);
+
+    return cover.violations ? 1 : 0;
+}
@@ -0,0 +1,437 @@
+/*
+ * j1939_tp 的 PC 測試，驗證 BAM 與 RTS/CTS 的重組、中止與逾時，以及重組後 fc135kw 的 DM1 解碼
+ *
+ * build (repo 根目錄):
+ *   gcc -O2 -std=gnu99 -Wall -ISources/j1939_tp -ISources/ramfunc -ISources/timebase -ISources/can_signal \
+ *       -ISources/can_codec -ISources/fc135kw tools/j1939_tp_test/main.c Sources/j1939_tp/j1939_tp.c \
+ *       Sources/timebase/timebase.c Sources/can_signal/can_signal.c Sources/can_codec/fc135kw_codec.c \
+ *       Sources/can_codec/host_codec.c Sources/fc135kw/fc135kw.c -o j1939_tp_test
+ *   ./j1939_tp_test                         失敗時印出項目與行號，回傳非 0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "j1939_tp.h"
+#include "fc135kw.h"
+
+#define LOCAL_ADDRESS                           (0x27U)
+#define PGN_DM1                                 (0x00FECAUL)
+#define PGN_DM2                                 (0x00FECBUL)
+#define TX_MAX                                  (64U)
+
+#define CM_RTS                                  (16U)
+#define CM_CTS                                  (17U)
+#define CM_EOMA                                 (19U)
+#define CM_BAM                                  (32U)
+#define CM_ABORT                                (255U)
+
+#define CHECK(ok)                               check((ok), #ok, __LINE__)
+
+static void tp_tx(const void* handle, uint32_t id, const uint8_t data[8]);
+static void tp_deliver(const void* handle, uint32_t pgn, uint8_t sa, const uint8_t* data, uint16_t size);
+
+static const j1939_tp_config_t config =
+{
+    .name = "tp",
+    .address = LOCAL_ADDRESS,
+    .log = NULL,
+    .tx = tp_tx,
+    .deliver = tp_deliver,
+};
+
+static void fc_log(const char* str, uint16_t size);
+
+static fc135kw_config_t fc_config =
+{
+    .name = "fc135kw",
+    .log = fc_log,
+    .io = NULL,
+    .light_tower = NULL,
+};
+
+static j1939_tp_t tp;
+static fc135kw_t fc;
+static char fc_log_text[1024];      /** fc135kw 的 log，依序串接 */
+
+static struct
+{
+    uint32_t id[TX_MAX];            /** 接收端送出的 TP.CM */
+    uint8_t data[TX_MAX][8];
+    uint8_t count;
+
+    uint32_t pgn;                   /** 最後一次交給上層的訊息 */
+    uint8_t sa;
+    uint16_t size;
+    uint8_t buffer[J1939_TP_SIZE_MAX];
+    uint32_t delivered;
+} sim;
+
+static uint8_t message[J1939_TP_SIZE_MAX + 8U];
+
+static uint32_t checks;
+static uint32_t failures;
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void tp_tx(const void* handle, uint32_t id, const uint8_t data[8])
+{
+    (void)handle;
+
+    if (sim.count < TX_MAX)
+    {
+        sim.id[sim.count] = id;
+        memcpy(&sim.data[sim.count][0], data, 8);
+        sim.count++;
+    }
+}
+
+static void tp_deliver(const void* handle, uint32_t pgn, uint8_t sa, const uint8_t* data, uint16_t size)
+{
+    (void)handle;
+
+    sim.pgn = pgn;
+    sim.sa = sa;
+    sim.size = size;
+    memcpy(&sim.buffer[0], data, size);
+    sim.delivered++;
+}
+
+static void fc_log(const char* str, uint16_t size)
+{
+    size_t len = strlen(fc_log_text);
+
+    if ((len + size) < sizeof(fc_log_text))
+    {
+        memcpy(&fc_log_text[len], str, size);
+        fc_log_text[len + size] = 0;
+    }
+}
+
+static void check(bool ok, const char* expr, int line)
+{
+    checks++;
+
+    if (!ok)
+    {
+        printf("fail: line %d: %s\n", line, expr);
+        failures++;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static uint32_t tp_id(uint32_t pgn, uint8_t da, uint8_t sa)
+{
+    return (7UL << 26) | (pgn << 8) | ((uint32_t)da << 8) | sa;
+}
+
+static uint8_t packets(uint16_t size)
+{
+    return (uint8_t)((size + 6U) / 7U);
+}
+
+/**
+ * @brief 發送端送出 TP.CM
+ */
+static bool sender_cm(uint8_t da, uint8_t sa, uint8_t control, uint16_t size, uint8_t count, uint8_t b4, uint32_t pgn)
+{
+    const uint8_t data[8] =
+    {
+        control, (uint8_t)size, (uint8_t)(size >> 8), count, b4, (uint8_t)pgn, (uint8_t)(pgn >> 8), (uint8_t)(pgn >> 16),
+    };
+
+    return j1939_tp_receive(&tp, tp_id(J1939_PGN_TP_CM, da, sa), data);
+}
+
+/**
+ * @brief 發送端送出第 sn 個 TP.DT (內容取自 message，不足補 0xFF)
+ */
+static void sender_dt(uint8_t da, uint8_t sa, uint8_t sn, uint16_t size)
+{
+    uint8_t data[8];
+    uint16_t offset = (uint16_t)(sn - 1U) * 7U;
+    uint8_t i;
+
+    data[0] = sn;
+
+    for (i = 0; i < 7U; i++)
+    {
+        data[1U + i] = ((offset + i) < size) ? message[offset + i] : 0xFFU;
+    }
+
+    (void)j1939_tp_receive(&tp, tp_id(J1939_PGN_TP_DT, da, sa), data);
+}
+
+static void tasks(uint16_t count)
+{
+    while (count--)
+    {
+        j1939_tp_task(&tp);
+    }
+}
+
+/**
+ * @brief 最後一個送出的 TP.CM 是給 da 的指定控制碼
+ */
+static bool last_cm(uint8_t da, uint8_t control)
+{
+    uint8_t n = sim.count - 1U;
+
+    return (sim.count > 0) &&
+        (sim.id[n] == tp_id(J1939_PGN_TP_CM, da, LOCAL_ADDRESS)) && (sim.data[n][0] == control);
+}
+
+static bool sessions_idle(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < J1939_TP_SESSION_MAX; i++)
+    {
+        if (tp.session[i].active)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void reset(void)
+{
+    j1939_tp_init(&tp, NULL, &config);
+    memset(&sim, 0, sizeof(sim));
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void test_bam(void)
+{
+    const uint16_t size = 20;
+    uint8_t sn;
+
+    /* 完整接收，不回應任何 TP.CM */
+    reset();
+    CHECK(sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_BAM, size, packets(size), 0xFF, PGN_DM1));
+    for (sn = 1; sn <= packets(size); sn++)
+    {
+        sender_dt(J1939_ADDRESS_GLOBAL, 0x10, sn, size);
+        tasks(J1939_TP_T1 - 1U);
+    }
+    CHECK((sim.delivered == 1) && (sim.pgn == PGN_DM1) && (sim.sa == 0x10) && (sim.size == size));
+    CHECK(memcmp(&sim.buffer[0], &message[0], size) == 0);
+    CHECK((sim.count == 0) && (tp.completed == 1) && sessions_idle());
+
+    /* 序號跳號：放棄，不送中止 */
+    reset();
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_BAM, size, packets(size), 0xFF, PGN_DM1);
+    sender_dt(J1939_ADDRESS_GLOBAL, 0x10, 1, size);
+    sender_dt(J1939_ADDRESS_GLOBAL, 0x10, 3, size);
+    CHECK((sim.delivered == 0) && (sim.count == 0) && (tp.aborted == 1) && sessions_idle());
+
+    /* T1 逾時 */
+    reset();
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_BAM, size, packets(size), 0xFF, PGN_DM1);
+    sender_dt(J1939_ADDRESS_GLOBAL, 0x10, 1, size);
+    tasks(J1939_TP_T1 - 1U);
+    CHECK(!sessions_idle());
+    tasks(1);
+    CHECK((tp.aborted == 1) && (sim.count == 0) && sessions_idle());
+
+    /* 逾時後的 DT 不屬於任何 session */
+    sender_dt(J1939_ADDRESS_GLOBAL, 0x10, 2, size);
+    CHECK((sim.delivered == 0) && (tp.aborted == 1));
+
+    /* 重送 BAM 取代前一個，兩個發送端各自一個 session */
+    reset();
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_BAM, size, packets(size), 0xFF, PGN_DM1);
+    sender_dt(J1939_ADDRESS_GLOBAL, 0x10, 1, size);
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_BAM, size, packets(size), 0xFF, PGN_DM2);
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x11, CM_BAM, size, packets(size), 0xFF, PGN_DM1);
+    for (sn = 1; sn <= packets(size); sn++)
+    {
+        sender_dt(J1939_ADDRESS_GLOBAL, 0x10, sn, size);
+    }
+    CHECK((sim.delivered == 1) && (sim.pgn == PGN_DM2) && !sessions_idle());
+    for (sn = 1; sn <= packets(size); sn++)
+    {
+        sender_dt(J1939_ADDRESS_GLOBAL, 0x11, sn, size);
+    }
+    CHECK((sim.delivered == 2) && (sim.sa == 0x11) && sessions_idle());
+
+    /* 格式錯誤：BAM 指定目的地、封包數不符、長度不足；過長時拒絕 (不送中止) */
+    reset();
+    (void)sender_cm(LOCAL_ADDRESS, 0x10, CM_BAM, size, packets(size), 0xFF, PGN_DM1);
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_BAM, size, packets(size) + 1U, 0xFF, PGN_DM1);
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_BAM, 8, 2, 0xFF, PGN_DM1);
+    CHECK(sessions_idle() && (tp.rejected == 0));
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_BAM, J1939_TP_SIZE_MAX + 1U, packets(J1939_TP_SIZE_MAX + 1U), 0xFF,
+        PGN_DM1);
+    CHECK(sessions_idle() && (tp.rejected == 1) && (sim.count == 0));
+}
+
+static void test_rts_cts(void)
+{
+    const uint16_t size = 50;       /** 8 個封包 */
+    uint8_t sn;
+
+    /* 發送端每次最多 3 包：CTS(3, 1) CTS(3, 4) CTS(2, 7) EOMA */
+    reset();
+    CHECK(sender_cm(LOCAL_ADDRESS, 0x10, CM_RTS, size, packets(size), 3, PGN_DM2));
+    CHECK(last_cm(0x10, CM_CTS) && (sim.data[0][1] == 3) && (sim.data[0][2] == 1));
+    CHECK((sim.data[0][5] == (uint8_t)PGN_DM2) && (sim.data[0][6] == (uint8_t)(PGN_DM2 >> 8)));
+    for (sn = 1; sn <= packets(size); sn++)
+    {
+        sender_dt(LOCAL_ADDRESS, 0x10, sn, size);
+
+        /* 重複的最後一包忽略 */
+        if (sn == 2)
+        {
+            sender_dt(LOCAL_ADDRESS, 0x10, sn, size);
+        }
+    }
+    CHECK(sim.count == 4);
+    CHECK((sim.data[1][0] == CM_CTS) && (sim.data[1][1] == 3) && (sim.data[1][2] == 4));
+    CHECK((sim.data[2][0] == CM_CTS) && (sim.data[2][1] == 2) && (sim.data[2][2] == 7));
+    CHECK(last_cm(0x10, CM_EOMA) && (sim.data[3][1] == size) && (sim.data[3][2] == 0) && (sim.data[3][3] == 8));
+    CHECK((sim.delivered == 1) && (sim.size == size) && (memcmp(&sim.buffer[0], &message[0], size) == 0));
+    CHECK((tp.aborted == 0) && sessions_idle());
+
+    /* 序號錯誤：中止 (7) */
+    reset();
+    (void)sender_cm(LOCAL_ADDRESS, 0x10, CM_RTS, size, packets(size), 0xFF, PGN_DM2);
+    sender_dt(LOCAL_ADDRESS, 0x10, 1, size);
+    sender_dt(LOCAL_ADDRESS, 0x10, 3, size);
+    CHECK(last_cm(0x10, CM_ABORT) && (sim.data[sim.count - 1U][1] == J1939_TP_ABORT_SEQUENCE));
+    CHECK((sim.data[sim.count - 1U][5] == (uint8_t)PGN_DM2) && (tp.aborted == 1) && sessions_idle());
+
+    /* CTS 後沒有資料：T2 逾時中止 (3) */
+    reset();
+    (void)sender_cm(LOCAL_ADDRESS, 0x10, CM_RTS, size, packets(size), 0xFF, PGN_DM2);
+    tasks(J1939_TP_T2 - 1U);
+    CHECK(!sessions_idle());
+    tasks(1);
+    CHECK(last_cm(0x10, CM_ABORT) && (sim.data[sim.count - 1U][1] == J1939_TP_ABORT_TIMEOUT) && sessions_idle());
+
+    /* 資料中斷：T1 逾時中止 */
+    reset();
+    (void)sender_cm(LOCAL_ADDRESS, 0x10, CM_RTS, size, packets(size), 0xFF, PGN_DM2);
+    sender_dt(LOCAL_ADDRESS, 0x10, 1, size);
+    tasks(J1939_TP_T1);
+    CHECK(last_cm(0x10, CM_ABORT) && (sim.data[sim.count - 1U][1] == J1939_TP_ABORT_TIMEOUT) && sessions_idle());
+
+    /* 發送端中止：PGN 與目的地需相符，不回應 */
+    reset();
+    (void)sender_cm(LOCAL_ADDRESS, 0x10, CM_RTS, size, packets(size), 0xFF, PGN_DM2);
+    (void)sender_cm(LOCAL_ADDRESS, 0x10, CM_ABORT, 0xFFFF, 0xFF, 0xFF, PGN_DM1);
+    CHECK(!sessions_idle());
+    (void)sender_cm(LOCAL_ADDRESS, 0x10, CM_ABORT, 0xFFFF, 0xFF, 0xFF, PGN_DM2);
+    CHECK(sessions_idle() && (tp.aborted == 1) && (sim.count == 1));
+    sender_dt(LOCAL_ADDRESS, 0x10, 1, size);
+    CHECK((sim.count == 1) && (sim.delivered == 0));
+
+    /* 過長：中止 (2)；session 用盡：中止 (1) */
+    reset();
+    (void)sender_cm(LOCAL_ADDRESS, 0x10, CM_RTS, J1939_TP_SIZE_MAX + 1U, packets(J1939_TP_SIZE_MAX + 1U), 0xFF, PGN_DM2);
+    CHECK(last_cm(0x10, CM_ABORT) && (sim.data[0][1] == J1939_TP_ABORT_RESOURCE) && (tp.rejected == 1));
+    for (sn = 0; sn < J1939_TP_SESSION_MAX; sn++)
+    {
+        (void)sender_cm(LOCAL_ADDRESS, (uint8_t)(0x20U + sn), CM_RTS, size, packets(size), 0xFF, PGN_DM2);
+    }
+    (void)sender_cm(LOCAL_ADDRESS, 0x30, CM_RTS, size, packets(size), 0xFF, PGN_DM2);
+    CHECK(last_cm(0x30, CM_ABORT) && (sim.data[sim.count - 1U][1] == J1939_TP_ABORT_BUSY) && (tp.rejected == 2));
+
+    /* 重送 RTS 重新開始，不佔用新的 session */
+    (void)sender_cm(LOCAL_ADDRESS, 0x20, CM_RTS, size, packets(size), 0xFF, PGN_DM2);
+    CHECK(last_cm(0x20, CM_CTS) && (sim.data[sim.count - 1U][2] == 1) && (tp.rejected == 2));
+}
+
+static void test_filter(void)
+{
+    const uint8_t data[8] = { 0 };
+
+    reset();
+
+    /* 其他 PGN 交回呼叫者；給其他位址的 TP 已處理但忽略 */
+    CHECK(!j1939_tp_receive(&tp, tp_id(PGN_DM1, 0, 0x10), data));
+    CHECK(sender_cm(0x55, 0x10, CM_RTS, 20, packets(20), 0xFF, PGN_DM2));
+    CHECK(sessions_idle() && (sim.count == 0));
+
+    /* RTS 需指定目的地 */
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_RTS, 20, packets(20), 0xFF, PGN_DM2);
+    CHECK(sessions_idle() && (sim.count == 0));
+}
+
+/**
+ * @brief 組成 DM1 故障碼 (J1939-73 版本 4)
+ */
+static void dm1_dtc(uint8_t* data, uint32_t spn, uint8_t fmi, uint8_t oc)
+{
+    data[0] = (uint8_t)spn;
+    data[1] = (uint8_t)(spn >> 8);
+    data[2] = (uint8_t)((fmi & 0x1FU) | (((spn >> 16) & 0x7U) << 5));
+    data[3] = oc & 0x7FU;
+}
+
+static void test_dm1(void)
+{
+    uint8_t single[8] = { 0x04, 0xFF, 0, 0, 0, 0, 0xFF, 0xFF, };
+    const uint16_t size = 14;       /** lamp 2 bytes + 3 個故障碼 */
+    uint8_t sn;
+
+    memset(&fc, 0, sizeof(fc));
+    fc.config = &fc_config;
+
+    /* 單封包：SPN 大於 0xFFFF 且 FMI 非 0，高 3 位元不可混入 FMI */
+    dm1_dtc(&single[2], 0x7FFFEUL, 3, 5);
+    fc_log_text[0] = 0;
+    fc135kw_message(&fc, FC135KW_PGN_DM1, single, sizeof(single));
+    CHECK((fc.fault.lamp == 0x04) && (fc.fault.count == 1));
+    CHECK(FC135KW_DTC_SPN(fc.fault.dtc[0]) == 0x7FFFEUL);
+    CHECK((FC135KW_DTC_FMI(fc.fault.dtc[0]) == 3) && (FC135KW_DTC_OC(fc.fault.dtc[0]) == 5));
+    CHECK(strstr(fc_log_text, "dtc spn 524286 fmi 3 oc 5") != NULL);
+
+    /* SPN 0 的填充 (FMI 非 0 也一樣) 不算故障 */
+    dm1_dtc(&single[2], 0, 31, 0);
+    fc135kw_message(&fc, FC135KW_PGN_DM1, single, sizeof(single));
+    CHECK((fc.fault.count == 0) && (fc.fault.dtc[0] == 0));
+
+    /* 多封包 (BAM) 重組後交給 fc135kw_message，只有低 16 位元的 SPN 同樣正確 */
+    reset();
+    message[0] = 0x40;
+    message[1] = 0xFF;
+    dm1_dtc(&message[2], 0x10000UL, 1, 1);
+    dm1_dtc(&message[6], 520192UL, 16, 127);
+    dm1_dtc(&message[10], 100, 18, 2);
+    (void)sender_cm(J1939_ADDRESS_GLOBAL, 0x10, CM_BAM, size, packets(size), 0xFF, FC135KW_PGN_DM1);
+    for (sn = 1; sn <= packets(size); sn++)
+    {
+        sender_dt(J1939_ADDRESS_GLOBAL, 0x10, sn, size);
+    }
+    CHECK((sim.delivered == 1) && (sim.pgn == FC135KW_PGN_DM1));
+    fc135kw_message(&fc, sim.pgn, &sim.buffer[0], sim.size);
+    CHECK((fc.fault.lamp == 0x40) && (fc.fault.count == 3));
+    CHECK((FC135KW_DTC_SPN(fc.fault.dtc[0]) == 0x10000UL) && (FC135KW_DTC_FMI(fc.fault.dtc[0]) == 1));
+    CHECK((FC135KW_DTC_SPN(fc.fault.dtc[1]) == 520192UL) && (FC135KW_DTC_FMI(fc.fault.dtc[1]) == 16));
+    CHECK(FC135KW_DTC_OC(fc.fault.dtc[1]) == 127);
+    CHECK((FC135KW_DTC_SPN(fc.fault.dtc[2]) == 100) && (FC135KW_DTC_FMI(fc.fault.dtc[2]) == 18));
+}
+
+int main(void)
+{
+    uint16_t i;
+
+    for (i = 0; i < sizeof(message); i++)
+    {
+        message[i] = (uint8_t)(i * 13U + 1U);
+    }
+
+    test_bam();
+    test_rts_cts();
+    test_filter();
+    test_dm1();
+
+    printf("checks: %u, failures: %u\n", checks, failures);
+
+    return failures ? 1 : 0;
+}
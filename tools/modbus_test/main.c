@@ -0,0 +1,234 @@
+/*
+ * modbus_rtu 的 PC 測試，驗證 CRC、訊框切分錯誤 (t3.5 間隔遺失或提早) 與例外回應
+ *
+ * build (repo 根目錄):
+ *   gcc -O2 -std=gnu99 -Wall -ISources/modbus tools/modbus_test/main.c Sources/modbus/modbus_rtu.c -o modbus_test
+ *   ./modbus_test                           失敗時印出項目與行號，回傳非 0
+ *
+ * 訊框切分由 app_modbus.c 的 UART 閒置偵測負責，這裡以切錯的訊框 (截斷、兩幀相連) 驗證從站的處理
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "modbus_rtu.h"
+
+#define SLAVE_ADDRESS                           (1U)
+
+#define CHECK(ok)                               check((ok), #ok, __LINE__)
+
+static uint16_t reg_u16 = 0x1234;
+static int16_t reg_s16 = -2;
+static int8_t reg_s8 = -1;
+static bool reg_bool = true;
+static uint32_t reg_u32 = 0x89ABCDEFUL;
+
+/* 位址 5 空缺 */
+static const modbus_reg_t map[] =
+{
+    MODBUS_UNSIGNED(0, reg_u16),
+    MODBUS_SIGNED(1, reg_s16),
+    MODBUS_SIGNED(2, reg_s8),
+    MODBUS_UNSIGNED(3, reg_u32),
+    MODBUS_UNSIGNED(6, reg_bool),
+};
+
+static const modbus_rtu_config_t config =
+{
+    .address = SLAVE_ADDRESS,
+    .map = &map[0],
+    .count = sizeof(map) / sizeof(map[0]),
+};
+
+static modbus_rtu_t mb;
+static uint8_t response[MODBUS_RTU_FRAME_MAX];
+
+static uint32_t checks;
+static uint32_t failures;
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void check(bool ok, const char* expr, int line)
+{
+    checks++;
+
+    if (!ok)
+    {
+        printf("fail: line %d: %s\n", line, expr);
+        failures++;
+    }
+}
+
+/**
+ * @brief 組成讀取請求 (含 CRC)
+ *
+ * @return uint16_t 訊框長度
+ */
+static uint16_t request_read(uint8_t* frame, uint8_t address, uint8_t function, uint16_t start, uint16_t quantity)
+{
+    uint16_t crc;
+
+    frame[0] = address;
+    frame[1] = function;
+    frame[2] = (uint8_t)(start >> 8);
+    frame[3] = (uint8_t)start;
+    frame[4] = (uint8_t)(quantity >> 8);
+    frame[5] = (uint8_t)quantity;
+
+    crc = modbus_rtu_crc(frame, 6);
+    frame[6] = (uint8_t)crc;
+    frame[7] = (uint8_t)(crc >> 8);
+
+    return 8;
+}
+
+/**
+ * @brief 回應的 CRC 正確
+ */
+static bool response_valid(uint16_t size)
+{
+    return (size >= 4U) &&
+        (modbus_rtu_crc(response, size - 2U) == (((uint16_t)response[size - 1U] << 8) | response[size - 2U]));
+}
+
+static uint16_t register_at(uint16_t index)
+{
+    return ((uint16_t)response[3U + (index * 2U)] << 8) | response[4U + (index * 2U)];
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void test_crc(void)
+{
+    const uint8_t check_string[] = "123456789";
+    const uint8_t frame[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x0A, 0xC5, 0xCD, };
+
+    /* CRC-16/MODBUS 的標準檢查值與規範中的範例訊框 */
+    CHECK(modbus_rtu_crc(check_string, 9) == 0x4B37U);
+    CHECK(modbus_rtu_crc(frame, 6) == 0xCDC5U);
+    CHECK(modbus_rtu_crc(frame, 8) == 0);
+}
+
+static void test_read(void)
+{
+    uint8_t frame[8];
+    uint16_t size;
+
+    /* 位址 0 ~ 4：有號數延伸、32 位元高位在前 */
+    size = modbus_rtu_handle(&mb, frame, request_read(frame, SLAVE_ADDRESS, MODBUS_FC_READ_HOLDING, 0, 5), response);
+    CHECK((size == 3U + 10U + 2U) && response_valid(size));
+    CHECK((response[0] == SLAVE_ADDRESS) && (response[1] == MODBUS_FC_READ_HOLDING) && (response[2] == 10U));
+    CHECK(register_at(0) == 0x1234U);
+    CHECK(register_at(1) == 0xFFFEU);
+    CHECK(register_at(2) == 0xFFFFU);
+    CHECK((register_at(3) == 0x89ABU) && (register_at(4) == 0xCDEFU));
+
+    /* 從 32 位元的低位開始讀取，0x04 與 0x03 共用同一份表 */
+    size = modbus_rtu_handle(&mb, frame, request_read(frame, SLAVE_ADDRESS, MODBUS_FC_READ_INPUT, 4, 1), response);
+    CHECK((size == 7U) && response_valid(size) && (response[1] == MODBUS_FC_READ_INPUT) && (register_at(0) == 0xCDEFU));
+
+    size = modbus_rtu_handle(&mb, frame, request_read(frame, SLAVE_ADDRESS, MODBUS_FC_READ_INPUT, 6, 1), response);
+    CHECK((size == 7U) && (register_at(0) == 1U));
+
+    CHECK((mb.request == 3U) && (mb.exception == 0));
+}
+
+static void test_exception(void)
+{
+    uint8_t frame[8];
+    uint16_t size;
+    uint16_t crc;
+
+    /* 區間跨過空缺的位址 5 */
+    size = modbus_rtu_handle(&mb, frame, request_read(frame, SLAVE_ADDRESS, MODBUS_FC_READ_HOLDING, 4, 3), response);
+    CHECK((size == 5U) && response_valid(size) && (response[1] == (MODBUS_FC_READ_HOLDING | 0x80U)));
+    CHECK(response[2] == MODBUS_EX_ILLEGAL_ADDRESS);
+
+    /* 起始位址未對應、超出表格 */
+    size = modbus_rtu_handle(&mb, frame, request_read(frame, SLAVE_ADDRESS, MODBUS_FC_READ_HOLDING, 5, 1), response);
+    CHECK((size == 5U) && (response[2] == MODBUS_EX_ILLEGAL_ADDRESS));
+    size = modbus_rtu_handle(&mb, frame, request_read(frame, SLAVE_ADDRESS, MODBUS_FC_READ_HOLDING, 6, 2), response);
+    CHECK((size == 5U) && (response[2] == MODBUS_EX_ILLEGAL_ADDRESS));
+    size = modbus_rtu_handle(&mb, frame, request_read(frame, SLAVE_ADDRESS, MODBUS_FC_READ_HOLDING, 0xFFFFU, 2), response);
+    CHECK((size == 5U) && (response[2] == MODBUS_EX_ILLEGAL_ADDRESS));
+
+    /* 數量 0 或超過 MODBUS_RTU_READ_MAX */
+    size = modbus_rtu_handle(&mb, frame, request_read(frame, SLAVE_ADDRESS, MODBUS_FC_READ_HOLDING, 0, 0), response);
+    CHECK((size == 5U) && (response[2] == MODBUS_EX_ILLEGAL_VALUE));
+    size = modbus_rtu_handle(&mb, frame,
+        request_read(frame, SLAVE_ADDRESS, MODBUS_FC_READ_HOLDING, 0, MODBUS_RTU_READ_MAX + 1U), response);
+    CHECK((size == 5U) && (response[2] == MODBUS_EX_ILLEGAL_VALUE));
+
+    /* 不支援的功能碼 (寫入單一暫存器) */
+    size = modbus_rtu_handle(&mb, frame, request_read(frame, SLAVE_ADDRESS, 0x06, 0, 1), response);
+    CHECK((size == 5U) && response_valid(size) && (response[1] == 0x86U) && (response[2] == MODBUS_EX_ILLEGAL_FUNCTION));
+
+    /* 讀取的長度不是 8 bytes */
+    frame[0] = SLAVE_ADDRESS;
+    frame[1] = MODBUS_FC_READ_HOLDING;
+    frame[2] = 0;
+    frame[3] = 0;
+    crc = modbus_rtu_crc(frame, 4);
+    frame[4] = (uint8_t)crc;
+    frame[5] = (uint8_t)(crc >> 8);
+    size = modbus_rtu_handle(&mb, frame, 6, response);
+    CHECK((size == 5U) && (response[2] == MODBUS_EX_ILLEGAL_VALUE));
+
+    CHECK(mb.exception == 8U);
+}
+
+static void test_framing(void)
+{
+    uint8_t frame[2][8];
+    uint8_t merged[MODBUS_RTU_FRAME_MAX + 1U];
+    uint32_t crc_error = mb.crc_error;
+    uint32_t ignored = mb.ignored;
+    uint16_t size;
+
+    (void)request_read(frame[0], SLAVE_ADDRESS, MODBUS_FC_READ_HOLDING, 0, 1);
+    (void)request_read(frame[1], SLAVE_ADDRESS, MODBUS_FC_READ_HOLDING, 1, 1);
+
+    /* 間隔過早切斷：前半段與後半段都是 CRC 錯誤，不回應 */
+    CHECK(modbus_rtu_handle(&mb, &frame[0][0], 5, response) == 0);
+    CHECK(modbus_rtu_handle(&mb, &frame[0][5], 3, response) == 0);
+    CHECK((mb.crc_error == crc_error + 1U) && (mb.ignored == ignored + 1U));
+
+    /* 間隔遺失：兩幀相連視為一個 CRC 錯誤的訊框 */
+    memcpy(&merged[0], &frame[0][0], 8);
+    memcpy(&merged[8], &frame[1][0], 8);
+    CHECK(modbus_rtu_handle(&mb, merged, 16, response) == 0);
+    CHECK(mb.crc_error == crc_error + 2U);
+
+    /* 單一位元錯誤 */
+    frame[0][3] ^= 0x01U;
+    CHECK(modbus_rtu_handle(&mb, &frame[0][0], 8, response) == 0);
+    CHECK(mb.crc_error == crc_error + 3U);
+    frame[0][3] ^= 0x01U;
+
+    /* 切分恢復後正常回應 */
+    size = modbus_rtu_handle(&mb, &frame[1][0], 8, response);
+    CHECK((size == 7U) && (register_at(0) == 0xFFFEU));
+
+    /* 其他站號與廣播：CRC 正確但不回應 */
+    CHECK(modbus_rtu_handle(&mb, frame[0], request_read(frame[0], 2, MODBUS_FC_READ_HOLDING, 0, 1), response) == 0);
+    CHECK(modbus_rtu_handle(&mb, frame[0], request_read(frame[0], 0, MODBUS_FC_READ_HOLDING, 0, 1), response) == 0);
+    CHECK(mb.ignored == ignored + 3U);
+
+    /* 超過 RTU 最大長度 */
+    CHECK(modbus_rtu_handle(&mb, merged, sizeof(merged), response) == 0);
+    CHECK(mb.ignored == ignored + 4U);
+}
+
+int main(void)
+{
+    modbus_rtu_init(&mb, &config);
+
+    test_crc();
+    test_read();
+    test_exception();
+    test_framing();
+
+    printf("checks: %u, failures: %u\n", checks, failures);
+
+    return failures ? 1 : 0;
+}
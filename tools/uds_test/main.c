@@ -0,0 +1,490 @@
+/*
+ * isotp / uds 的 PC 測試，以模擬時間驗證流量控制、分段收發與 S3
+ *
+ * build (repo 根目錄):
+ *   gcc -O2 -std=gnu99 -Wall -ISources/timebase -ISources/ramfunc -ISources/isotp -ISources/uds tools/uds_test/main.c \
+ *       Sources/timebase/timebase.c Sources/isotp/isotp.c Sources/uds/uds.c -o uds_test
+ *   ./uds_test                              失敗時印出項目與行號，回傳非 0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "timebase.h"
+#include "isotp.h"
+#include "uds.h"
+
+#define SIM_PERIOD                              TIMEBASE_S(1000)    /** 模擬計數器溢位週期 */
+#define TICK_US                                 TIMEBASE_US(100)    /** 主迴圈間隔 */
+#define FRAME_MAX                               (1024U)
+#define LARGE_SIZE                              (4000U)     /** 大 DID，回應 4003 bytes (573 CF) */
+
+#define CHECK(ok)                               check((ok), #ok, __LINE__)
+
+static uint32_t sim_counter(void);
+static bool tp_tx(const void* handle, const uint8_t data[8]);
+static void tp_deliver(const void* handle, const uint8_t* data, uint16_t size, bool functional);
+static bool uds_send(const void* handle, const uint8_t* head, uint16_t head_size, const uint8_t* body, uint16_t body_size);
+static bool uds_busy(const void* handle);
+static uint8_t uds_io_control(const void* handle, uint32_t arg, uint8_t param, const uint8_t* state, uint16_t size);
+static void uds_session_change(const void* handle, uds_session_t session);
+
+static const timebase_config_t sim_timebase =
+{
+    .period = SIM_PERIOD,
+    .counter = sim_counter,
+    .pending = NULL,
+};
+
+static uint8_t did_u8 = 0x5A;
+static uint16_t did_u16 = 0x1234;
+static uint8_t did_large[LARGE_SIZE];
+
+static const uds_did_t did[] =
+{
+    UDS_DID(0x0100, did_u8),
+    UDS_DID(0x0101, did_u16),
+    UDS_DID(0x0102, did_large),
+};
+
+static const uds_control_t io[] =
+{
+    { 0x0A00, 0, },
+};
+
+static const uds_config_t uds_config =
+{
+    .did = &did[0],
+    .did_count = sizeof(did) / sizeof(did[0]),
+    .io = &io[0],
+    .io_count = sizeof(io) / sizeof(io[0]),
+    .routine = NULL,
+    .routine_count = 0,
+    .memory = NULL,
+    .memory_count = 0,
+    .io_control = uds_io_control,
+    .routine_control = NULL,
+    .session = uds_session_change,
+    .send = uds_send,
+    .busy = uds_busy,
+};
+
+static const isotp_config_t tp_config =
+{
+    .block_size = 0,
+    .st_min = 0,
+    .tx = tp_tx,
+    .deliver = tp_deliver,
+};
+
+static isotp_t tp;
+static uds_t uds;
+
+static struct
+{
+    uint64_t now;
+    uint8_t frame[FRAME_MAX][8];    /** 伺服器送出的訊框 */
+    uint16_t frames;
+    uint16_t room;                  /** 發送佇列剩餘空間 */
+    uint8_t session;                /** 最後一次 session 回呼，0: 沒有 */
+    uint8_t response[ISOTP_SIZE_MAX];
+    uint16_t length;                /** 重組後的回應長度，0: 沒有 */
+} sim;
+
+static uint32_t checks;
+static uint32_t failures;
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static uint32_t sim_counter(void)
+{
+    return (uint32_t)(sim.now % SIM_PERIOD);
+}
+
+static void sim_advance(uint32_t us)
+{
+    uint64_t old = sim.now / SIM_PERIOD;
+
+    sim.now += us;
+
+    if ((sim.now / SIM_PERIOD) != old)
+    {
+        timebase_irq();
+    }
+}
+
+/**
+ * @brief 一次主迴圈 (與 app_uds_task 相同)
+ */
+static void sim_loop(uint32_t us)
+{
+    sim_advance(us);
+    isotp_task(&tp);
+    uds_task(&uds);
+}
+
+static bool tp_tx(const void* handle, const uint8_t data[8])
+{
+    (void)handle;
+
+    if ((sim.room == 0) || (sim.frames >= FRAME_MAX))
+    {
+        return false;
+    }
+
+    sim.room--;
+    memcpy(&sim.frame[sim.frames++][0], data, 8);
+
+    return true;
+}
+
+static void tp_deliver(const void* handle, const uint8_t* data, uint16_t size, bool functional)
+{
+    (void)handle;
+
+    uds_request(&uds, data, size, functional);
+}
+
+static bool uds_send(const void* handle, const uint8_t* head, uint16_t head_size, const uint8_t* body, uint16_t body_size)
+{
+    (void)handle;
+
+    return isotp_send(&tp, head, head_size, body, body_size);
+}
+
+static bool uds_busy(const void* handle)
+{
+    (void)handle;
+
+    return isotp_busy(&tp);
+}
+
+static uint8_t uds_io_control(const void* handle, uint32_t arg, uint8_t param, const uint8_t* state, uint16_t size)
+{
+    (void)handle;
+    (void)arg;
+    (void)state;
+
+    return ((param == 0x03U) && (size == 1U)) ? UDS_NRC_NONE : UDS_NRC_OUT_OF_RANGE;
+}
+
+static void uds_session_change(const void* handle, uds_session_t session)
+{
+    (void)handle;
+
+    sim.session = (uint8_t)session;
+}
+
+static void check(bool ok, const char* expr, int line)
+{
+    checks++;
+
+    if (!ok)
+    {
+        printf("fail: line %d: %s\n", line, expr);
+        failures++;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void frames_clear(void)
+{
+    sim.frames = 0;
+    sim.room = 0xFFFFU;
+}
+
+/**
+ * @brief 測試端送出一個訊框 (實體定址時 dlc 8，補 0xCC)
+ */
+static void tester_frame(const uint8_t* data, uint8_t size, bool functional)
+{
+    uint8_t frame[8];
+
+    memset(&frame[0], ISOTP_PADDING, sizeof(frame));
+    memcpy(&frame[0], data, size);
+
+    isotp_receive(&tp, &frame[0], 8, functional);
+}
+
+static void tester_fc(uint8_t status, uint8_t bs, uint8_t st_min)
+{
+    const uint8_t fc[3] = { (uint8_t)(0x30U | status), bs, st_min, };
+
+    tester_frame(&fc[0], sizeof(fc), false);
+}
+
+/**
+ * @brief 測試端送出單訊框請求
+ */
+static void tester_request(const uint8_t* data, uint8_t size, bool functional)
+{
+    uint8_t frame[8];
+
+    frame[0] = size;
+    memcpy(&frame[1], data, size);
+
+    frames_clear();
+    tester_frame(&frame[0], (uint8_t)(size + 1U), functional);
+}
+
+/**
+ * @brief 接收伺服器的回應，FF 之後以 (bs, st_min) 回覆 FC 並依時間推進，重組到 sim.response
+ *
+ * @return true 收到完整回應
+ */
+static bool tester_response(uint8_t bs, uint8_t st_min, uint32_t limit_us)
+{
+    uint16_t next = 0;
+    uint16_t size = 0;
+    uint16_t offset = 0;
+    uint8_t sn = 1;
+    uint8_t block = 0;
+    uint64_t end = sim.now + limit_us;
+    uint16_t len;
+
+    sim.length = 0;
+
+    while (sim.now < end)
+    {
+        for (; next < sim.frames; next++)
+        {
+            const uint8_t* f = &sim.frame[next][0];
+
+            switch (f[0] & 0xF0U)
+            {
+                case 0x00:
+                {
+                    memcpy(&sim.response[0], &f[1], f[0]);
+                    sim.length = f[0];
+                    return true;
+                }
+                case 0x10:
+                {
+                    size = (uint16_t)(((f[0] & 0x0FU) << 8) | f[1]);
+                    memcpy(&sim.response[0], &f[2], 6);
+                    offset = 6;
+                    tester_fc(0, bs, st_min);
+                    break;
+                }
+                case 0x20:
+                {
+                    if ((f[0] & 0x0FU) != sn)
+                    {
+                        return false;
+                    }
+
+                    len = ((uint16_t)(size - offset) > 7U) ? 7U : (uint16_t)(size - offset);
+                    memcpy(&sim.response[offset], &f[1], len);
+                    offset += len;
+                    sn = (sn + 1U) & 0x0FU;
+
+                    if (offset >= size)
+                    {
+                        sim.length = size;
+                        return true;
+                    }
+
+                    if (bs && (++block >= bs))
+                    {
+                        block = 0;
+                        tester_fc(0, bs, st_min);
+                    }
+                    break;
+                }
+                default:
+                {
+                    return false;
+                }
+            }
+        }
+
+        sim_loop(TICK_US);
+    }
+
+    return false;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+
+static void test_single_frame(void)
+{
+    const uint8_t read_u16[] = { 0x22, 0x01, 0x01, };
+    const uint8_t read_two[] = { 0x22, 0x01, 0x00, 0x01, 0x01, };
+    const uint8_t unknown[] = { 0x99, };
+    const uint8_t present[] = { 0x3E, 0x80, };
+
+    tester_request(&read_u16[0], sizeof(read_u16), false);
+    CHECK((sim.frames == 1) && tester_response(0, 0, TICK_US));
+    CHECK((sim.length == 5) && (sim.response[0] == 0x62) && (sim.response[3] == 0x12) && (sim.response[4] == 0x34));
+
+    /* 兩個 DID 共 8 bytes，分段回應 */
+    tester_request(&read_two[0], sizeof(read_two), false);
+    CHECK(tester_response(0, 0, TIMEBASE_MS(10)));
+    CHECK((sim.length == 8) && (sim.response[3] == 0x5A) && (sim.response[6] == 0x12) && (sim.response[7] == 0x34));
+
+    /* 不支援的服務：功能定址不回應，實體定址回 0x11 */
+    tester_request(&unknown[0], sizeof(unknown), true);
+    CHECK(sim.frames == 0);
+    tester_request(&unknown[0], sizeof(unknown), false);
+    CHECK(tester_response(0, 0, TICK_US) && (sim.response[0] == 0x7F) && (sim.response[2] == UDS_NRC_SERVICE_NOT_SUPPORTED));
+
+    /* 抑制正面回應 */
+    tester_request(&present[0], sizeof(present), false);
+    CHECK(sim.frames == 0);
+}
+
+static void test_segmented_request(void)
+{
+    const uint8_t ff[] = { 0x10, 0x09, 0x22, 0x01, 0x00, 0x01, 0x01, 0x01, };
+    const uint8_t cf[] = { 0x21, 0x00, 0x01, 0x02, };
+    const uint8_t cf_bad[] = { 0x22, 0x00, 0x01, 0x02, };
+    const uint8_t ff_large[] = { 0x10, 0xFF, 0x22, 0x01, 0x00, 0x01, 0x01, 0x01, };
+    uint32_t error = tp.error;
+
+    /* 9 bytes 請求：FF 後回 FC CTS，收齊後回應三個 DID 中的前兩個 (0x0102 需單獨讀取，回 0x14) */
+    frames_clear();
+    tester_frame(&ff[0], sizeof(ff), false);
+    CHECK((sim.frames == 1) && (sim.frame[0][0] == 0x30));
+    frames_clear();
+    tester_frame(&cf[0], sizeof(cf), false);
+    CHECK(tester_response(0, 0, TICK_US) && (sim.response[2] == UDS_NRC_RESPONSE_TOO_LONG));
+
+    /* 序號錯誤：放棄接收，不交給上層 */
+    frames_clear();
+    tester_frame(&ff[0], sizeof(ff), false);
+    frames_clear();
+    tester_frame(&cf_bad[0], sizeof(cf_bad), false);
+    CHECK((sim.frames == 0) && (tp.error == error + 1U) && !tp.rx_active);
+
+    /* 超過接收緩衝：FC overflow */
+    frames_clear();
+    tester_frame(&ff_large[0], sizeof(ff_large), false);
+    CHECK((sim.frames == 1) && (sim.frame[0][0] == 0x32) && !tp.rx_active && (tp.error == error + 2U));
+}
+
+static void test_flow_control(void)
+{
+    const uint8_t read_large[] = { 0x22, 0x01, 0x02, };
+    const uint8_t read_u8[] = { 0x22, 0x01, 0x00, };
+    uint32_t error = tp.error;
+    uint16_t i;
+
+    /* BS 8、STmin 1 ms，內容與來源一致 */
+    tester_request(&read_large[0], sizeof(read_large), false);
+    CHECK(tester_response(8, 0x01, TIMEBASE_S(2)));
+    CHECK((sim.length == LARGE_SIZE + 3U) && (sim.response[0] == 0x62));
+    CHECK(memcmp(&sim.response[3], &did_large[0], LARGE_SIZE) == 0);
+    CHECK(!isotp_busy(&tp));
+
+    /* 發送佇列已滿時下次重試，不遺失 CF */
+    tester_request(&read_large[0], sizeof(read_large), false);
+    sim.room = 0;
+    tester_fc(0, 0, 0);
+    CHECK(isotp_busy(&tp) && (sim.frames == 1));
+    sim.room = 3;
+    sim_loop(TICK_US);
+    CHECK(sim.frames == 4);
+    sim.room = 0xFFFFU;
+    while (isotp_busy(&tp))
+    {
+        sim_loop(TICK_US);
+    }
+    CHECK(sim.frames == 1U + ((LARGE_SIZE + 3U - 6U) + 6U) / 7U);
+
+    /* FC WAIT：每次重新計時 N_Bs，總等待可超過 N_Bs */
+    tester_request(&read_large[0], sizeof(read_large), false);
+    for (i = 0; i < 3U; i++)
+    {
+        sim_loop(ISOTP_N_BS - TIMEBASE_MS(100));
+        tester_fc(1, 0, 0);
+    }
+    sim_loop(ISOTP_N_BS - TIMEBASE_MS(100));
+    CHECK(isotp_busy(&tp) && (sim.frames == 1));
+    tester_fc(0, 0, 0);
+    while (isotp_busy(&tp))
+    {
+        sim_loop(TICK_US);
+    }
+    CHECK(tp.error == error);
+
+    /* FC WAIT 後沒有後續：N_Bs 逾時放棄 */
+    tester_request(&read_large[0], sizeof(read_large), false);
+    tester_fc(1, 0, 0);
+    sim_loop(ISOTP_N_BS + TICK_US);
+    CHECK(!isotp_busy(&tp) && (tp.error == error + 1U));
+
+    /* FC overflow：立即放棄，不送 CF */
+    tester_request(&read_large[0], sizeof(read_large), false);
+    tester_fc(2, 0, 0);
+    sim_loop(TICK_US);
+    CHECK(!isotp_busy(&tp) && (sim.frames == 1) && (tp.error == error + 2U));
+
+    /* 發送中收到的請求忽略，發送完畢後可再接受 */
+    tester_request(&read_large[0], sizeof(read_large), false);
+    tester_request(&read_u8[0], sizeof(read_u8), false);
+    CHECK(sim.frames == 0);
+    tester_fc(0, 0, 0);
+    while (isotp_busy(&tp))
+    {
+        sim_loop(TICK_US);
+    }
+    tester_request(&read_u8[0], sizeof(read_u8), false);
+    CHECK(tester_response(0, 0, TICK_US) && (sim.length == 4) && (sim.response[3] == 0x5A));
+}
+
+static void test_session(void)
+{
+    const uint8_t extended[] = { 0x10, 0x03, };
+    const uint8_t io_control[] = { 0x2F, 0x0A, 0x00, 0x03, 0x01, };
+    const uint8_t read_large[] = { 0x22, 0x01, 0x02, };
+    uint64_t start;
+
+    /* 預設 session 不允許 IO 控制，功能定址時不回應 */
+    tester_request(&io_control[0], sizeof(io_control), false);
+    CHECK(tester_response(0, 0, TICK_US) && (sim.response[2] == UDS_NRC_NOT_IN_SESSION));
+    tester_request(&io_control[0], sizeof(io_control), true);
+    CHECK(sim.frames == 0);
+
+    tester_request(&extended[0], sizeof(extended), false);
+    CHECK(tester_response(0, 0, TICK_US) && (sim.response[0] == 0x50) && (sim.session == UDS_SESSION_EXTENDED));
+    tester_request(&io_control[0], sizeof(io_control), false);
+    CHECK(tester_response(0, 0, TICK_US) && (sim.response[0] == 0x6F));
+
+    /* STmin 127 ms 的大筆回應遠超過 S3，發送期間不可回到預設 */
+    start = sim.now;
+    tester_request(&read_large[0], sizeof(read_large), false);
+    CHECK(tester_response(0, 0x7F, TIMEBASE_S(100)));
+    CHECK((sim.now - start) > (uint64_t)UDS_S3_TIMEOUT * 10U);
+    CHECK(uds_session(&uds) == UDS_SESSION_EXTENDED);
+
+    /* S3 由發送完畢起算 */
+    sim_loop(UDS_S3_TIMEOUT - TIMEBASE_MS(10));
+    CHECK(uds_session(&uds) == UDS_SESSION_EXTENDED);
+    sim_loop(TIMEBASE_MS(20));
+    CHECK((uds_session(&uds) == UDS_SESSION_DEFAULT) && (sim.session == UDS_SESSION_DEFAULT));
+}
+
+int main(void)
+{
+    uint16_t i;
+
+    for (i = 0; i < LARGE_SIZE; i++)
+    {
+        did_large[i] = (uint8_t)(i * 7U);
+    }
+
+    timebase_init(&sim_timebase);
+    isotp_init(&tp, NULL, &tp_config);
+    uds_init(&uds, NULL, &uds_config);
+    frames_clear();
+
+    test_single_frame();
+    test_segmented_request();
+    test_flow_control();
+    test_session();
+
+    printf("checks: %u, failures: %u\n", checks, failures);
+
+    return failures ? 1 : 0;
+}